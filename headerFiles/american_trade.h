@@ -36,6 +36,7 @@ public:
     const Date& getExpiry() const override;
     const Date& getTradeDate() const override;
     const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
     OptionType getOptionType() const;
     double getStrike() const;
     Date getVolTenor() const;
@@ -84,6 +85,8 @@ public:
     const Date& getExpiry() const override;
     const Date& getTradeDate() const override;
     const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    uint64_t fingerprint() const override;
     OptionType getOptionType() const override;
     double getStrike() const override;
 
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "pricer.h"
+#include "market.h"
+#include "asian_trade.h"
+#include "thread_pool.h"
+#include "path_generator.h"
+#include "monte_carlo_pricer.h"
+
+// ===========================
+// AsianPricer Class
+// ===========================
+// Geometric Asians use the discrete-fixing lognormal closed form. Arithmetic Asians are
+// simulated on the future fixing dates (Brownian bridge, Sobol by default) with the
+// geometric Asian of the same strike as control variate, whose expectation is exact.
+//
+// priceGroup values several trades on one set of paths: trades on the same underlying and
+// fixing schedule see identical paths, so each block computes the arithmetic and geometric
+// averages once and every trade only evaluates its payoff against them.
+class AsianPricer : public Pricer {
+public:
+    explicit AsianPricer(size_t nPaths = 16384, uint64_t seed = 20250101, ThreadPool& pool = ThreadPool::global());
+
+    void setSampling(Sampling method) { sampling = method; }
+    void setReplicates(size_t count);
+    void setControlVariate(bool on) { controlVariate = on; }
+
+    double price(const Market& mkt, std::shared_ptr<Trade> trade) const override;
+    McResult priceWithError(const Market& mkt, std::shared_ptr<Trade> trade) const;
+
+    // Trades must share underlying, rate curve and fixing dates
+    std::vector<McResult> priceGroup(const Market& mkt, const std::vector<const AsianOption*>& group) const;
+
+    // Signed, notional-scaled geometric Asian value
+    static double geometricClosedForm(const Market& mkt, const AsianOption& trade);
+
+    static constexpr size_t kBlockPaths = 2048;
+
+private:
+    size_t nPaths;
+    uint64_t seed;
+    Sampling sampling = Sampling::Sobol;
+    size_t replicates = 8;
+    bool controlVariate = true;
+    ThreadPool& pool;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "trade.h"
+#include "types.h"
+#include "date.h"
+#include <string>
+#include <vector>
+
+// ===========================
+// AsianOption Class
+// ===========================
+// Option on the arithmetic or geometric average of fixings taken every `fixingFreq` years
+// from startDate (exclusive) to expiry (inclusive), paid at expiry. The market holds no
+// fixing history, so fixings dated on or before the valuation date are taken at spot.
+class AsianOption : public Trade {
+public:
+    AsianOption(OptionType optType,
+        AverageType avgType,
+        double notional,
+        double strike,
+        const Date& tradeDate,
+        const Date& startDate,
+        const Date& expiryDate,
+        double fixingFreq,
+        const std::string& underlying,
+        bool isLong = true);
+
+    std::shared_ptr<Trade> clone() const override;
+
+    // Trade overrides
+    const std::string& getType() const override;
+    const std::string& getUnderlying() const override;
+    double getNotional() const override;
+    double payoff(double S) const override;               // Every fixing at S
+    double payoff(const Market& market) const override;
+    double valueAtNode(double S, double t, double continuation) const override;
+    double price(const Market& mkt) const override;
+    double pv(const Market& mkt) const override;
+    uint64_t fingerprint() const override;
+
+    const Date& getExpiry() const override;
+    const Date& getTradeDate() const override;
+    const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    OptionType getOptionType() const override;
+    double getStrike() const override;
+
+    // Asian terms
+    AverageType getAverageType() const;
+    const Date& getStartDate() const;
+    const std::vector<Date>& getFixingDates() const;
+
+    // Signed payoff for a full set of fixings
+    double payoffOnFixings(const double* fixings, size_t n) const;
+
+private:
+    void generateSchedule(double fixingFreq);
+
+    OptionType optType;
+    AverageType avgType;
+    double notional;
+    double strike;
+    std::string underlying;
+    std::string rateCurve;
+    Date startDate;
+    Date expiryDate;
+    std::vector<Date> fixingDates;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "date.h"
+#include "market.h"
+#include "trade.h"
+#include "discount_table.h"
+#include "thread_pool.h"
+
+// ===========================
+// PvMatrix
+// ===========================
+// Dense trade-by-date PVs, stored date-major so each date task writes one contiguous row.
+class PvMatrix {
+public:
+    PvMatrix() = default;
+    PvMatrix(size_t nTrades, size_t nDates);
+
+    double& at(size_t trade, size_t date) { return data[date * nTrades + trade]; }
+    double at(size_t trade, size_t date) const { return data[date * nTrades + trade]; }
+
+    size_t tradeCount() const { return nTrades; }
+    size_t dateCount() const { return nDates; }
+
+    std::vector<double> portfolioPv() const;   // Per date, summed in trade order
+
+private:
+    size_t nTrades = 0;
+    size_t nDates = 0;
+    std::vector<double> data;
+};
+
+struct BacktestStats {
+    size_t dates = 0;
+    size_t valuations = 0;   // Trade valuations actually run
+    size_t matured = 0;      // Trade-dates skipped because the trade had expired
+};
+
+// ===========================
+// BacktestValuer Class
+// ===========================
+// Prices one portfolio on a sequence of market snapshots (one per historical as-of date).
+// Trades, their schedules and the discount table layout are built once and shared read-only
+// by every date; each date evaluates its own discount factors once and only date-dependent
+// quantities are recomputed: rate trades drop cashflows before the snapshot's asOf, tree
+// pricing measures time to expiry from it, and trades that expired before it are left at
+// zero without being priced. Dates run in parallel, and trades in chunks within a date.
+class BacktestValuer {
+public:
+    BacktestValuer(const std::vector<std::shared_ptr<Trade>>& portfolio,
+        std::shared_ptr<const DiscountTable> table = nullptr,   // Built from the portfolio if null
+        ThreadPool& pool = ThreadPool::global());
+
+    // Snapshots are read, not copied; the PV matrix columns follow their order
+    const PvMatrix& run(const std::vector<std::shared_ptr<const Market>>& snapshots);
+
+    const PvMatrix& getMatrix() const { return matrix; }
+    const std::vector<Date>& getDates() const { return dates; }
+    const BacktestStats& getStats() const { return stats; }
+
+    // One row per trade, one column per as-of date
+    void writeCsv(const std::string& filename) const;
+
+private:
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    ThreadPool& pool;
+    std::shared_ptr<const DiscountTable> dfTable;
+
+    std::vector<size_t> byExpiry;      // Trade indices sorted by expiry
+    std::vector<long> expirySerials;   // Aligned with byExpiry
+
+    std::vector<Date> dates;
+    PvMatrix matrix;
+    BacktestStats stats;
+    size_t tradeChunk = 256;
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "trade.h"
+#include "types.h"
+#include "date.h"
+#include <string>
+
+// ===========================
+// BarrierOption Class
+// ===========================
+// European call or put that is knocked out (or in) when the spot touches the barrier,
+// monitored continuously up to expiry; no rebate. The market holds no monitoring history,
+// so a spot already beyond the barrier counts as a touch.
+class BarrierOption : public Trade {
+public:
+    BarrierOption(OptionType optType,
+        BarrierType barrierType,
+        double notional,
+        double strike,
+        double barrier,
+        const Date& tradeDate,
+        const Date& expiryDate,
+        const std::string& underlying,
+        bool isLong = true);
+
+    std::shared_ptr<Trade> clone() const override;
+
+    // Trade overrides
+    const std::string& getType() const override;
+    const std::string& getUnderlying() const override;
+    double getNotional() const override;
+    double payoff(double S) const override;               // Terminal payoff, barrier not touched
+    double payoff(const Market& market) const override;
+    double valueAtNode(double S, double t, double continuation) const override;
+    double price(const Market& mkt) const override;
+    double pv(const Market& mkt) const override;
+    uint64_t fingerprint() const override;
+
+    const Date& getExpiry() const override;
+    const Date& getTradeDate() const override;
+    const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    OptionType getOptionType() const override;
+    double getStrike() const override;
+
+    // Barrier terms
+    BarrierType getBarrierType() const;
+    double getBarrier() const;
+    bool isKnockIn() const;
+    bool isUpBarrier() const;
+
+private:
+    OptionType optType;
+    BarrierType barrierType;
+    double notional;
+    double strike;
+    double barrier;
+    std::string underlying;
+    std::string rateCurve;
+    Date expiryDate;
+};
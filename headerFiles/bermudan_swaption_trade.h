@@ -0,0 +1,61 @@
+#pragma once
+
+#include "trade.h"
+#include "types.h"
+#include "date.h"
+#include "swap.h"
+#include <string>
+#include <vector>
+
+// ===========================
+// BermudanSwaption Class
+// ===========================
+// Co-terminal Bermudan swaption: exercisable on every reset date of the underlying swap
+// from the first exercise date on, into the remaining swap to the common end date.
+// A call is a payer (pay fixed at the strike), a put a receiver. Priced on the
+// Hull-White lattice.
+class BermudanSwaption : public Trade {
+public:
+    BermudanSwaption(OptionType optType,
+        double notional,
+        double strike,
+        const Date& tradeDate,
+        const Date& firstExercise,
+        const Date& swapEndDate,
+        double frequency,
+        const std::string& rateCurve,
+        bool isLong = true);
+
+    std::shared_ptr<Trade> clone() const override;
+
+    // Trade overrides
+    const std::string& getType() const override;
+    const std::string& getUnderlying() const override;
+    double getNotional() const override;
+    double payoff(double swapRate) const override;        // Intrinsic per unit annuity
+    double payoff(const Market& market) const override;
+    double valueAtNode(double S, double t, double continuation) const override;
+    double price(const Market& mkt) const override;
+    double pv(const Market& mkt) const override;
+    uint64_t fingerprint() const override;
+
+    const Date& getExpiry() const override;              // Last exercise date
+    const Date& getTradeDate() const override;
+    const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    OptionType getOptionType() const override;
+    double getStrike() const override;
+
+    // Bermudan terms
+    bool isPayer() const { return optType == OptionType::Call; }
+    const Swap& getSwap() const { return swap; }
+    const Date& getFirstExercise() const { return swap.getStartDate(); }
+    const Date& getSwapEnd() const { return swap.getExpiry(); }
+    const std::vector<Date>& getExerciseDates() const { return exerciseDates; }
+
+private:
+    OptionType optType;
+    double strike;
+    Swap swap;                        // Swap from the first exercise date; unit direction
+    std::vector<Date> exerciseDates;  // Every swap reset date, i.e. the schedule without its end
+};
@@ -4,6 +4,10 @@
 #include "pricer.h"
 #include "market.h"
 #include "trade.h"
+#include "types.h"
+
+// Black-Scholes value of one unit vanilla call or put (expired: intrinsic)
+double blackScholesPrice(OptionType type, double S, double K, double T, double r, double sigma);
 
 class BlackScholesPricer : public Pricer {
 public:
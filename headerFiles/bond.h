@@ -27,6 +27,7 @@ public:
     const std::string& getType() const override;
     const std::string& getUnderlying() const override;
     const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
     const Date& getTradeDate() const override;
     const Date& getExpiry() const override;
     double getNotional() const override;
@@ -37,6 +38,25 @@ public:
     // === Cloning Support ===
     std::shared_ptr<Trade> clone() const override;
 
+    // === Issuer Call (priced on the Hull-White lattice) ===
+    // Callable on each date at callPrice per 1 of notional; coupons due on a call date are paid
+    void setCallSchedule(const std::vector<Date>& callDates, double callPrice = 1.0);
+    bool isCallable() const { return !callDates.empty(); }
+    const std::vector<Date>& getCallDates() const { return callDates; }
+    double getCallPrice() const { return callPrice; }
+    uint64_t fingerprint() const override;
+
+    // === Schedule Access ===
+    const std::vector<Date>& getSchedule() const { return bondSchedule; }
+    double getCouponRate() const { return couponRate; }
+    double getAccrual(size_t i) const;   // ACT/365 fraction of the period ending at schedule[i]
+
+    // === Discount Table Valuation (callables revalue on the lattice instead) ===
+    bool usesDiscountTable() const override { return !isCallable(); }
+    void registerDates(DiscountTable& table) const override;
+    void bindDiscountTable(const DiscountTable& table) override;
+    double pvFromTable(const std::vector<double>& dfs, const Market& mkt) const override;
+
     // === Internal Helpers ===
     void generateSchedule();
 
@@ -50,6 +70,12 @@ private:
     std::string rateCurve;
 
     std::vector<Date> bondSchedule;
+    std::vector<double> accruals;     // Year fraction per period, aligned with bondSchedule
+    std::vector<size_t> dfSlots;      // DiscountTable slot per schedule date
+    size_t maturitySlot = 0;
+
+    std::vector<Date> callDates;
+    double callPrice = 1.0;
 
     bool isLong_ = true; 
 };
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// ===========================
+// BrownianBridge Class
+// ===========================
+// Builds Brownian paths on a time grid from standard normals in bisection order: the first
+// normal fixes W(T), the second the midpoint, and so on. With quasi-random inputs this puts
+// the low (best distributed) Sobol dimensions on the path features that carry most of the
+// variance, which is what keeps QMC effective for long paths.
+class BrownianBridge {
+public:
+    // times: strictly increasing and positive; W(0) = 0 is implied
+    explicit BrownianBridge(const std::vector<double>& times);
+
+    size_t size() const { return bridgeIndex.size(); }
+
+    // Levels W(t_k) for `count` paths at once. Layouts are step-major:
+    // z[d * count + p] is normal d of path p, w[k * count + p] is W(t_k) of path p.
+    void build(const double* z, size_t count, double* w) const;
+
+private:
+    std::vector<size_t> bridgeIndex, leftIndex, rightIndex;
+    std::vector<double> leftWeight, rightWeight, stdDev;
+};
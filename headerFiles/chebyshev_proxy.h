@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "market.h"
+#include "pricer.h"
+#include "trade.h"
+#include "thread_pool.h"
+
+// ===========================
+// ProxyConfig
+// ===========================
+// Chebyshev nodes per axis (1 drops the axis: the proxy then ignores moves in it) and the
+// half-widths of the box fitted around the market's inputs.
+struct ProxyConfig {
+    size_t spotNodes = 16;
+    size_t volNodes = 6;
+    size_t rateNodes = 3;
+    double spotWidth = 0.35;        // Relative to the fit spot
+    double volWidth = 0.5;          // Relative to the fit vol
+    double rateWidth = 0.01;        // Absolute
+    size_t maxCoefficients = 512;   // Per trade; larger grids are rejected
+    bool autoRefit = true;          // Outside the box: refit (true) or price exactly (false)
+};
+
+struct ProxyStats {
+    size_t groups = 0;              // Homogeneous batches sharing one node grid
+    size_t trades = 0;
+    size_t fits = 0;                // Node grids priced, refits included
+    size_t refits = 0;
+    size_t nodePricings = 0;        // Exact prices taken at nodes
+    size_t evaluations = 0;         // Prices served from an interpolant
+    size_t fallbacks = 0;           // Prices served by the exact pricer
+};
+
+// ===========================
+// ChebyshevProxy Class
+// ===========================
+// Tensor Chebyshev interpolant of PV over (spot, LOGVOL at expiry, curve rate at expiry),
+// fitted against an exact pricer on the nodes of a box around the market's inputs. Trades
+// on the same underlying, expiry and rate curve form one group: they share the box and the
+// node markets, so each node market is built once per group. Per trade the proxy keeps one
+// coefficient tensor of fixed size, whatever the number of refits.
+//
+// A market whose inputs leave a group's box, or with another asOf, refits the group over
+// the smallest box holding the old one and the new point's own box (a new asOf starts
+// afresh), so a wandering scenario set settles after a few refits. A scenario set known up
+// front avoids those serial refits: fitEnvelope sizes every box to the whole set and refits
+// each group that grew once, with its node grid priced in parallel. The error estimate is the
+// sum of the magnitudes of each trade's highest-order coefficients.
+//
+// The exact pricer must see the trade only through those three inputs and asOf, and be safe
+// to call concurrently. `price` may be called from many threads at once; `fit` and
+// `fitEnvelope` may not overlap with it.
+class ChebyshevProxy {
+public:
+    ChebyshevProxy(std::shared_ptr<const Pricer> exact,
+        ProxyConfig config = {},
+        ThreadPool& pool = ThreadPool::global());
+
+    // Fit the trades on `mkt`, dropping any earlier fits; returns the number fitted. Expired
+    // trades are left to the exact pricer; those with no spot, LOGVOL or rate curve are
+    // skipped with a warning.
+    size_t fit(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades);
+    bool covers(const Trade& trade) const { return slots.count(&trade) != 0; }
+    // Grow each group's box to hold `base` and the `count` markets `scenario` returns (those on
+    // base's asOf), refitting every group that grew once on `base`; returns the groups refitted
+    size_t fitEnvelope(const Market& base, size_t count, const std::function<Market(size_t)>& scenario);
+
+    // PV under `mkt`: the interpolant inside the box; outside, a refit or the exact pricer
+    double price(const Market& mkt, const std::shared_ptr<Trade>& trade);
+    // Interpolant at explicit inputs; false if the trade is not covered or the point is not
+    // in its box on `asOf`
+    bool evaluate(const Trade& trade, const Date& asOf, double spot, double vol, double rate, double& pv) const;
+
+    double errorEstimate(const Trade& trade) const;   // Absolute PV; 0 if not covered
+    double maxErrorEstimate() const;
+    size_t memoryBytes() const;                       // Coefficients and error estimates
+    ProxyStats getStats() const;
+    const ProxyConfig& getConfig() const { return config; }
+
+private:
+    struct Point {
+        double x[3];   // spot, vol, rate
+    };
+    struct Box {
+        double lo[3];
+        double hi[3];
+    };
+    struct Group {
+        std::string underlying;
+        std::string rateCurve;
+        Date expiry;
+        std::vector<std::shared_ptr<Trade>> trades;
+
+        mutable std::shared_mutex lock;
+        Date asOf;
+        Box box{};
+        std::vector<double> coeffs;   // [slot * coeffCount + flat index]
+        std::vector<double> errors;   // Per slot
+    };
+    struct Fit {
+        std::vector<double> coeffs;
+        std::vector<double> errors;
+    };
+
+    Point inputsOf(const Market& mkt, const Group& g) const;
+    Box boxAround(const Point& p) const;
+    bool inside(const Box& box, const Point& p) const;
+    Fit fitGroup(const Group& g, const Market& mkt, const Box& box, bool parallel) const;
+    double interpolate(const Group& g, size_t slot, const Point& p) const;   // Caller holds g.lock
+
+    std::shared_ptr<const Pricer> exact;
+    ProxyConfig config;
+    ThreadPool& pool;
+    size_t n[3];
+    size_t coeffCount;
+
+    std::vector<std::unique_ptr<Group>> groups;
+    std::map<std::tuple<std::string, long, std::string>, size_t> groupIndex;
+    std::map<const Trade*, std::pair<size_t, size_t>> slots;   // Trade -> (group, slot)
+
+    mutable std::atomic<size_t> fitCount{ 0 };
+    mutable std::atomic<size_t> refitCount{ 0 };
+    mutable std::atomic<size_t> nodeCount{ 0 };
+    mutable std::atomic<size_t> evalCount{ 0 };
+    mutable std::atomic<size_t> fallbackCount{ 0 };
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "date.h"
+#include "rate_curve.h"
+#include "thread_pool.h"
+#include "market_factor.h"
+
+class Market;
+
+enum class CurveInstrument { Deposit, Swap };
+
+// One par quote; rates are decimals. Deposits accrue simple ACT/360 from the valuation date
+// to the tenor; swaps start on the valuation date and pay a fixed leg every `frequency` years.
+struct CurveQuote {
+    CurveInstrument type = CurveInstrument::Swap;
+    std::string tenor;
+    double rate = 0.0;
+    double frequency = 1.0;
+};
+
+// ===========================
+// CurveBootstrapper Class
+// ===========================
+// Builds a RateCurve from deposit and par swap quotes, one pillar per quote at its maturity,
+// plus an anchor pillar at the valuation date that carries the first pillar's rate, so
+// getDf(asOf) is exactly 1. Rates interpolate linearly in date between pillars, exactly as
+// RateCurve::getRate does, so every quote reprices to par on the RateCurve it returns
+// (Swap::getForwardRate included).
+//
+// Swap schedules and accruals come from Swap itself. Each instrument only sees pillars up to
+// its own maturity, so pillars are solved in order by a 1-D Newton on the last one, with the
+// discount-factor weights precomputed once per quote set. Quote indices follow the input,
+// which must be strictly increasing in maturity.
+//
+// updateQuote() re-solves only the pillar of the changed quote and those after it, warm-started
+// from the previous solution. The par-to-zero Jacobian is analytic (implicit function theorem
+// on each instrument's pricing equation) and lower triangular; its inverse maps zero-rate
+// risk on the curve's pillars into par-rate risk without rebumping.
+class CurveBootstrapper {
+public:
+    CurveBootstrapper(const std::string& curveName, const Date& asOf, const std::vector<CurveQuote>& quotes);
+
+    // Full bootstrap; returns a fresh curve
+    std::shared_ptr<RateCurve> build();
+
+    // Moves quote i and re-solves pillars i.. only; returns a fresh curve
+    std::shared_ptr<RateCurve> updateQuote(size_t i, double rate);
+
+    // Current curve from the last solve (built on first use)
+    std::shared_ptr<RateCurve> getCurve();
+
+    const std::string& getName() const { return name; }
+    const std::vector<CurveQuote>& getQuotes() const { return quotes; }
+    const std::vector<Date>& getPillars() const { return pillars; }       // Anchor first, then one per quote
+    const std::vector<double>& getZeroRates() const { return zeros; }    // Aligned with getPillars()
+    size_t lastSolved() const { return solvedCount; }                    // Pillars solved by the last build/update
+    size_t lastIterations() const { return iterationCount; }
+
+    // Model par rate of quote i on the current curve
+    double parRate(size_t i) const;
+
+    // d(par_i)/d(zero_j) over the quote pillars, row-major n x n, lower triangular
+    std::vector<double> parJacobian() const;
+    // d(zero_j)/d(par_i), row-major n x n (row j, column i)
+    std::vector<double> zeroJacobian() const;
+
+    // Par-rate risk per quote from zero-rate risk per curve pillar (getPillars() order,
+    // anchor included, which folds into the first quote)
+    std::vector<double> parRisk(const std::vector<double>& zeroRisk) const;
+
+private:
+    // One discounted cashflow date of an instrument: z(T) = (1 - w) z[left] + w z[right]
+    struct Node {
+        double T;
+        size_t left, right;
+        double w;
+        double fixedCoef;   // Coefficient of P(T) independent of the quote
+        double quoteCoef;   // Coefficient of P(T) per unit of quote
+    };
+    // Pricing equation: constant + sum (fixedCoef + q quoteCoef) P(T) = 0
+    struct Instrument {
+        double constant;
+        std::vector<Node> nodes;
+    };
+
+    double rateAt(size_t pillar) const { return zeros[pillar == 0 ? 1 : pillar]; }
+    double zeroAt(const Node& n) const { return (1.0 - n.w) * rateAt(n.left) + n.w * rateAt(n.right); }
+    double dZero(const Node& n, size_t quotePillar) const;    // dz(T)/dz[quotePillar]
+    double residual(size_t k, double* dfdz = nullptr, double* dfdq = nullptr) const;
+    void solveFrom(size_t first);
+    std::shared_ptr<RateCurve> makeCurve() const;
+
+    std::string name;
+    Date valueDate;
+    std::vector<CurveQuote> quotes;
+    std::vector<Date> pillars;
+    std::vector<double> zeros;
+    std::vector<Instrument> instruments;
+    bool built = false;
+    size_t solvedCount = 0;
+    size_t iterationCount = 0;
+};
+
+// ===========================
+// MultiCurveBootstrapper Class
+// ===========================
+// A set of independently bootstrapped curves (each discounts off itself, as Swap prices),
+// built in parallel and installed into a Market under their names and aliases. A quote tick
+// re-solves and replaces only the curve it belongs to, under every name it is known by.
+class MultiCurveBootstrapper {
+public:
+    explicit MultiCurveBootstrapper(ThreadPool& pool = ThreadPool::global());
+
+    void addCurve(const std::string& curveName, const Date& asOf, const std::vector<CurveQuote>& quotes);
+    bool hasCurve(const std::string& curveName) const;
+    CurveBootstrapper& getBootstrapper(const std::string& curveName);
+
+    // Installs the curve under alias as well (USD-GOV sharing USD-SOFR) on every build and
+    // quote update, so the alias never keeps a stale curve or version
+    void addAlias(const std::string& curveName, const std::string& alias);
+    // Curve factors that a rebuild of curveName moves: the curve and its aliases
+    std::vector<MarketFactor> movedFactors(const std::string& curveName) const;
+
+    void buildAll(Market& mkt);
+    // Returns the number of pillars re-solved
+    size_t updateQuote(Market& mkt, const std::string& curveName, size_t quote, double rate);
+
+private:
+    void install(Market& mkt, const CurveBootstrapper& b, const std::shared_ptr<RateCurve>& curve) const;
+
+    ThreadPool& pool;
+    std::map<std::string, std::unique_ptr<CurveBootstrapper>> curves;
+    std::map<std::string, std::vector<std::string>> aliases;   // By curve name
+};
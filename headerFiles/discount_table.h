@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "date.h"
+
+class Market;
+class Trade;
+
+// ===========================
+// DiscountTable Class
+// ===========================
+// Portfolio-wide layout of the distinct (curve, payment date) pairs used by rate trades.
+// Trades register their cashflow dates once at load time and keep slot indices; each
+// market scenario then evaluates every distinct discount factor exactly once into a
+// dense vector that trades value themselves from by indexed gathers.
+class DiscountTable {
+public:
+    DiscountTable() = default;
+
+    // === Layout Construction ===
+    void addDate(const std::string& curveName, const Date& date);
+    void finalize();                            // Sort and dedupe dates, assign slots
+    bool isFinalized() const { return finalized; }
+
+    // Slot of a registered (curve, date) pair inside the dense DF vector
+    size_t getSlot(const std::string& curveName, const Date& date) const;
+
+    // === Evaluation (one DF per slot) ===
+    std::vector<double> evaluate(const Market& mkt) const;
+    void evaluate(const Market& mkt, std::vector<double>& dfs) const;  // Reuses caller buffer
+
+    // === Accessors ===
+    size_t size() const { return totalSlots; }
+    size_t curveCount() const { return blocks.size(); }
+
+    // Collect dates from every rate trade, finalize and bind the trades to the layout
+    static std::shared_ptr<DiscountTable> build(const std::vector<std::shared_ptr<Trade>>& portfolio);
+
+private:
+    struct CurveBlock {
+        std::string curveName;
+        std::vector<Date> dates;   // Sorted and unique once finalized
+        size_t offset = 0;         // First slot of this curve in the dense vector
+    };
+
+    std::vector<CurveBlock> blocks;
+    std::unordered_map<std::string, size_t> blockIndex;
+    size_t totalSlots = 0;
+    bool finalized = false;
+};
@@ -34,6 +34,7 @@ public:
     const Date& getExpiry() const override;
     const Date& getTradeDate() const override;
     const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
     OptionType getOptionType() const;
     double getStrike() const;
     Date getVolTenor() const;
@@ -77,8 +78,12 @@ public:
     const Date& getExpiry() const override;
     const Date& getTradeDate() const override;
     const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    uint64_t fingerprint() const override;
     OptionType getOptionType() const override;
     double getStrike() const override;
+    double getLowerStrike() const { return strike1; }
+    double getUpperStrike() const { return strike2; }
 
 private:
     double strike1, strike2;
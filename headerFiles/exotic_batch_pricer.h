@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+#include "thread_pool.h"
+#include "asian_pricer.h"
+#include "barrier_pricer.h"
+
+// ===========================
+// ExoticBatchPricer Class
+// ===========================
+// Values a book of exotics by grouping trades that can share work: Asians on the same
+// underlying and fixing schedule are priced on one set of simulated paths, barriers on the
+// same underlying, expiry and barrier are solved on one PDE grid. Groups run in parallel on
+// the pool; path and grid buffers are per-thread and reused from group to group. Any other
+// trade is valued with its own pv(). Prices match each trade's own pv() exactly.
+//
+// PortfolioValuer, the VaR engines and the stress engine send their Asians and barriers
+// through one price() call per market.
+class ExoticBatchPricer {
+public:
+    explicit ExoticBatchPricer(const AsianPricer& asian = AsianPricer(),
+        const BarrierPricer& barrier = BarrierPricer(),
+        ThreadPool& pool = ThreadPool::global());
+
+    // PVs in input order; `groups`, if given, receives the number of shared groups formed.
+    // Safe to call concurrently.
+    std::vector<double> price(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades,
+        size_t* groups = nullptr) const;
+
+    // True for the trade types price() groups (Asians and barriers)
+    static bool batches(const Trade& trade);
+
+private:
+    AsianPricer asianPricer;
+    BarrierPricer barrierPricer;
+    ThreadPool& pool;
+};
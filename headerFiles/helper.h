@@ -11,6 +11,8 @@
 #include <stdexcept>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
+#include <type_traits>
 
 #include "date.h"
 
@@ -131,6 +133,109 @@ namespace util {
         return y0 + (x - x0) * (y1 - y0) / (x1 - x0);
     }
 
+    // ===========================
+    // Normal Distribution
+    // ===========================
+
+    inline double normPdf(double x) {
+        return 0.3989422804014327 * std::exp(-0.5 * x * x);
+    }
+
+    inline double normCdf(double x) {
+        return 0.5 * std::erfc(-x / std::sqrt(2.0));
+    }
+
+    // Inverse standard normal CDF (Acklam's rational approximation, |rel err| < 1.2e-9)
+    inline double invNormCdf(double p) {
+        static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+            1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+        static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+            6.680131188771972e+01, -1.328068155288572e+01 };
+        static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+            -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+        static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+            3.754408661907416e+00 };
+        const double pLow = 0.02425;
+
+        if (p <= 0.0) return -HUGE_VAL;
+        if (p >= 1.0) return HUGE_VAL;
+        if (p < pLow || p > 1.0 - pLow) {
+            double q = std::sqrt(-2.0 * std::log(p < pLow ? p : 1.0 - p));
+            double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+            return p < pLow ? x : -x;
+        }
+        double q = p - 0.5;
+        double r = q * q;
+        return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+            (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+    }
+
+    // Batched inverse normal: the branch-free central-region polynomial runs over the whole
+    // array (auto-vectorizes), then the few tail points (~5%) are patched individually
+    inline void invNormCdf(const double* u, double* z, size_t n) {
+        const double a0 = -3.969683028665376e+01, a1 = 2.209460984245205e+02, a2 = -2.759285104469687e+02,
+            a3 = 1.383577518672690e+02, a4 = -3.066479806614716e+01, a5 = 2.506628277459239e+00;
+        const double b0 = -5.447609879822406e+01, b1 = 1.615858368580409e+02, b2 = -1.556989798598866e+02,
+            b3 = 6.680131188771972e+01, b4 = -1.328068155288572e+01;
+        const double pLow = 0.02425;
+
+        for (size_t i = 0; i < n; ++i) {
+            double q = u[i] - 0.5;
+            double r = q * q;
+            z[i] = (((((a0 * r + a1) * r + a2) * r + a3) * r + a4) * r + a5) * q /
+                (((((b0 * r + b1) * r + b2) * r + b3) * r + b4) * r + 1.0);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (u[i] < pLow || u[i] > 1.0 - pLow)
+                z[i] = invNormCdf(u[i]);
+        }
+    }
+
+    // ===========================
+    // Deterministic Reductions
+    // ===========================
+
+    // Pairwise summation in fixed index order: O(eps log n) error and bit-identical results
+    // for the same input order, independent of how the values were produced in parallel
+    inline double pairwiseSum(const double* x, size_t n) {
+        if (n <= 8) {
+            double s = 0.0;
+            for (size_t i = 0; i < n; ++i) s += x[i];
+            return s;
+        }
+        size_t half = n / 2;
+        return pairwiseSum(x, half) + pairwiseSum(x + half, n - half);
+    }
+
+    inline double pairwiseSum(const std::vector<double>& x) {
+        return pairwiseSum(x.data(), x.size());
+    }
+
+    // ===========================
+    // Content Hashing (FNV-1a, 64-bit)
+    // ===========================
+
+    constexpr uint64_t kHashSeed = 1469598103934665603ULL;
+
+    // Fold n raw bytes into the running hash h
+    inline uint64_t hashBytes(uint64_t h, const void* p, size_t n) {
+        const unsigned char* b = static_cast<const unsigned char*>(p);
+        for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ULL; }
+        return h;
+    }
+
+    // Fold one value's bytes into h; strings contribute their characters only
+    template <typename T>
+    inline uint64_t hashMix(uint64_t h, const T& x) {
+        static_assert(std::is_trivially_copyable<T>::value, "hashMix needs a trivially copyable value");
+        return hashBytes(h, &x, sizeof(T));
+    }
+
+    inline uint64_t hashMix(uint64_t h, const std::string& s) {
+        return hashBytes(h, s.data(), s.size());
+    }
+
     // ===========================
     // Tenor/Frequency Helpers
     // ===========================
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "heston_pricer.h"
+#include "types.h"
+
+// One calibration target: a unit option price on a given expiry (years) and flat rate
+struct HestonQuote {
+    double expiry = 0.0;
+    double strike = 0.0;
+    double rate = 0.0;
+    OptionType type = OptionType::Call;
+    double price = 0.0;
+    double weight = 1.0;
+};
+
+struct HestonCalibration {
+    HestonParams params;
+    double rmse = 0.0;          // Weighted price RMSE at the solution
+    size_t iterations = 0;
+    size_t evaluations = 0;     // Full grid repricings, Jacobian columns included
+    bool converged = false;
+};
+
+// ===========================
+// HestonCalibrator Class
+// ===========================
+// Levenberg-Marquardt fit of the five Heston parameters to a grid of option prices.
+// Quotes are grouped by (expiry, rate) once, so each repricing of the grid is one COS chain
+// per expiry. The Jacobian is by forward differences, one grid repricing per parameter.
+//
+// The search runs on unconstrained coordinates (log of v0, kappa, theta, sigma and atanh
+// of rho), so every trial point is admissible; the Feller condition is not imposed.
+// Damping follows Nielsen's update with Marquardt's diagonal scaling.
+class HestonCalibrator {
+public:
+    explicit HestonCalibrator(const HestonPricer& pricer = HestonPricer(), size_t maxIterations = 100,
+        double tolerance = 1e-10);
+
+    HestonCalibration calibrate(double spot, const std::vector<HestonQuote>& quotes,
+        const HestonParams& initial = HestonParams()) const;
+
+private:
+    struct Chain {
+        double expiry, rate;
+        std::vector<double> strikes;
+        std::vector<OptionType> types;
+        std::vector<size_t> quotes;
+    };
+
+    void residuals(const HestonParams& p, double spot, const std::vector<Chain>& chains,
+        const std::vector<HestonQuote>& quotes, std::vector<double>& r) const;
+
+    HestonPricer pricer;
+    size_t maxIter;
+    double tol;
+};
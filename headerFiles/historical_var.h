@@ -0,0 +1,136 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "date.h"
+#include "market.h"
+#include "trade.h"
+#include "discount_table.h"
+#include "portfolio_valuer.h"
+#include "thread_pool.h"
+#include "exotic_batch_pricer.h"
+
+class BinomialTreePricer;
+class ChebyshevProxy;
+
+// ===========================
+// HistoricalScenario
+// ===========================
+// One day of observed market moves. Curve and vol moves are absolute changes at a pillar
+// tenor (empty tenor = parallel); spot moves are relative returns.
+struct FactorMove {
+    std::string name;     // Curve, vol or stock identifier
+    std::string tenor;    // Pillar tenor such as "1Y"; empty for parallel / spot
+    double move = 0.0;
+};
+
+struct HistoricalScenario {
+    Date date;
+    std::vector<FactorMove> curveMoves;
+    std::vector<FactorMove> volMoves;
+    std::vector<FactorMove> spotMoves;
+
+    // Overlay on the base market; only the curves and vols this scenario moves are cloned
+    Market apply(const Market& base) const;
+    // Moves that take the moved market back: curve and vol moves negated, spot returns inverted
+    HistoricalScenario inverse() const;
+};
+
+// Wide file format: header "date;CURVE:USD-SOFR:1Y;VOL:LOGVOL:3M;SPOT:STI;..." and one row per day
+std::vector<HistoricalScenario> loadHistoricalScenarios(const std::string& filename);
+
+// ===========================
+// PnlCube
+// ===========================
+// Dense trade-by-scenario P&L, stored scenario-major so each scenario task writes one
+// contiguous row. Reductions walk trades in index order and are deterministic.
+class PnlCube {
+public:
+    PnlCube() = default;
+    PnlCube(size_t nTrades, size_t nScenarios);
+
+    double& at(size_t trade, size_t scenario) { return data[scenario * nTrades + trade]; }
+    double at(size_t trade, size_t scenario) const { return data[scenario * nTrades + trade]; }
+
+    size_t tradeCount() const { return nTrades; }
+    size_t scenarioCount() const { return nScenarios; }
+
+    // Per-scenario P&L for each key of an arbitrary trade hierarchy
+    std::map<std::string, std::vector<double>> reduce(const std::function<std::string(size_t)>& keyOf) const;
+    std::vector<double> portfolioPnl() const;
+
+private:
+    size_t nTrades = 0;
+    size_t nScenarios = 0;
+    std::vector<double> data;
+};
+
+struct VarResult {
+    double VaR = 0.0;    // Loss quantile, reported as a positive number
+    double ES = 0.0;     // Mean loss beyond the VaR quantile
+};
+
+// Historical-simulation VaR/ES of a P&L vector at the given confidence (e.g. 0.99)
+VarResult computeVaR(const std::vector<double>& pnl, double confidence);
+
+// ===========================
+// HistoricalVarEngine Class
+// ===========================
+// Full revaluation of the portfolio under every historical scenario. Scenarios are market
+// overlays (no deep copies); rate trades gather from one discount table evaluation per
+// scenario; tree pricers are created once per task rather than once per trade.
+class HistoricalVarEngine {
+public:
+    HistoricalVarEngine(const Market& base,
+        const std::vector<std::shared_ptr<Trade>>& portfolio,
+        std::shared_ptr<const DiscountTable> table = nullptr,   // Built from the portfolio if null
+        ThreadPool& pool = ThreadPool::global());
+
+    void setScenarios(std::vector<HistoricalScenario> scenarios);
+    void loadScenarios(const std::string& filename);
+    const std::vector<HistoricalScenario>& getScenarios() const { return scenarios; }
+
+    // Revalue every trade under every scenario and fill the P&L cube
+    const PnlCube& run();
+    const PnlCube& getCube() const { return cube; }
+    const std::vector<double>& getBasePv() const { return basePv; }
+
+    VarResult portfolioVaR(double confidence) const;
+    std::map<std::string, VarResult> varBy(AggregateBy level, double confidence) const;
+
+    // Full revaluation of one trade under one market; rate trades use the scenario DFs
+    double revalue(size_t tradeIndex, const Market& mkt, const std::vector<double>& dfs) const;
+    double revalue(size_t tradeIndex, const Market& mkt, const std::vector<double>& dfs,
+        const BinomialTreePricer& pricer) const;   // Caller-owned pricer, reused across trades
+    // pv[k] = revalue(todo[k], ...): Asians and barriers in one ExoticBatchPricer call, every
+    // other trade in parallel chunks
+    void revalueAll(const std::vector<size_t>& todo, const Market& mkt, const std::vector<double>& dfs,
+        std::vector<double>& pv) const;
+
+    std::shared_ptr<const DiscountTable> getDiscountTable() const { return dfTable; }
+    const std::vector<double>& getBaseDfs() const { return baseDfs; }
+
+    // Trades the proxy covers are priced from it instead of the tree pricer (null: none)
+    void setProxy(ChebyshevProxy* p) { proxy = p; }
+    // Sizes the proxy's boxes to these scenario markets before they are priced, so no
+    // scenario triggers a serial refit (no-op without a proxy)
+    void prepareProxy(const std::vector<HistoricalScenario>& scenarioSet) const;
+
+private:
+    const Market& baseMarket;
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    ThreadPool& pool;
+
+    std::shared_ptr<const DiscountTable> dfTable;
+    std::vector<double> baseDfs;
+    std::vector<double> basePv;
+    std::vector<HistoricalScenario> scenarios;
+    PnlCube cube;
+    ChebyshevProxy* proxy = nullptr;
+    ExoticBatchPricer exoticPricer;
+    size_t tradeChunk = 256;
+};
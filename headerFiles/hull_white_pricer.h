@@ -0,0 +1,56 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "pricer.h"
+#include "market.h"
+#include "thread_pool.h"
+#include "hull_white_tree.h"
+#include "bond.h"
+#include "bermudan_swaption_trade.h"
+
+// ===========================
+// HullWhitePricer Class
+// ===========================
+// Backward induction on a calibrated Hull-White lattice for Bermudan swaptions and
+// callable bonds (a non-callable Bond is accepted too and reprices its static value).
+// Lattices come from a HullWhiteLatticeCache, so every trade on the same curve, valuation
+// date and grid reuses one calibration.
+//
+// Event dates are snapped to the nearest lattice step. A cashflow paid on date d but
+// valued at step t_m is scaled by P(0, d) / P(0, t_m), so static cashflows reprice the
+// curve exactly and only the exercise timing carries the grid error.
+class HullWhitePricer : public Pricer {
+public:
+    explicit HullWhitePricer(const HullWhiteParams& params = HullWhiteParams(),
+        HullWhiteLatticeCache& cache = HullWhiteLatticeCache::global(),
+        ThreadPool& pool = ThreadPool::global());
+
+    double price(const Market& mkt, std::shared_ptr<Trade> trade) const override;
+
+    // PVs in input order. One lattice per curve covers the longest trade on it, each distinct
+    // event date is discounted once up front, and trades run in parallel with per-thread
+    // induction buffers.
+    std::vector<double> priceBatch(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades) const;
+
+    const HullWhiteParams& getParams() const { return params; }
+
+    // Default-parameter pricer on the global cache and pool, behind Bond::pv and
+    // BermudanSwaption::pv
+    static const HullWhitePricer& global();
+
+private:
+    HullWhiteParams params;
+    HullWhiteLatticeCache& cache;
+    ThreadPool& pool;
+
+    using DfLookup = std::function<double(const Date&)>;
+
+    static Date lastEventDate(const Trade& trade);
+    static void eventDates(const Trade& trade, std::vector<Date>& dates);
+    double priceOnTree(const Date& asOf, const HullWhiteTree& tree, const Trade& trade, const DfLookup& df) const;
+    double bermudan(const Date& asOf, const HullWhiteTree& tree, const BermudanSwaption& trade, const DfLookup& df) const;
+    double callableBond(const Date& asOf, const HullWhiteTree& tree, const Bond& bond, const DfLookup& df) const;
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "date.h"
+#include "rate_curve.h"
+
+class Market;
+
+// ===========================
+// HullWhiteParams Structure
+// ===========================
+// dr = (theta(t) - a r) dt + sigma dW. sigma is an absolute (normal) rate vol.
+// Lattice steps are whole calendar days so every step lands on a Date.
+struct HullWhiteParams {
+    double meanReversion = 0.03;
+    double volatility = 0.01;
+    int stepDays = 30;
+};
+
+// ===========================
+// HullWhiteTree Class
+// ===========================
+// One-factor Hull-White trinomial short-rate lattice (Hull & White 1994). The x = r - alpha
+// process sits on nodes j * dx with dx = sigma * sqrt(3 dt); branching switches from the
+// normal (j+1, j, j-1) pattern to edge branching at |j| = jmax = ceil(0.184 / (a dt)).
+// Forward induction on Arrow-Debreu prices fixes alpha per step so the lattice reprices
+// every curve discount factor P(0, t_m) exactly.
+//
+// Branch probabilities depend on j only and are stored once; the per-node one-step
+// discount factors are stored step by step. The tree is immutable once built, so one
+// instance serves every trade and thread on the same curve and date grid.
+class HullWhiteTree {
+public:
+    HullWhiteTree(const RateCurve& curve, const Date& asOf, size_t steps, const HullWhiteParams& params);
+
+    // === Grid ===
+    size_t steps() const { return nSteps; }
+    double dt() const { return stepDt; }
+    const Date& getAsOf() const { return asOf; }
+    const HullWhiteParams& getParams() const { return params; }
+    size_t halfWidth(size_t m) const { return std::min<size_t>(m, jmax); }
+    size_t width(size_t m) const { return 2 * halfWidth(m) + 1; }
+    size_t maxWidth() const { return 2 * std::min<size_t>(nSteps, jmax) + 1; }
+
+    // Nearest step to a date (clamped at 0); past the horizon returns steps() + 1
+    size_t stepOf(const Date& date) const;
+    static size_t stepsToCover(const Date& asOf, const Date& last, int stepDays);
+
+    // Curve discount factor at step m, as calibrated
+    double zeroPrice(size_t m) const { return zero[m]; }
+    double shortRate(size_t m, long j) const;
+
+    // Discounted expectation of step m+1 values into step m. Both buffers are node-major with
+    // `width` values per node (several payoffs rolled back together).
+    void rollback(size_t m, const double* next, double* out, size_t width) const;
+
+private:
+    struct Branch {
+        long center;      // Middle target node
+        double pu, pm, pd;
+    };
+
+    Date asOf;
+    long asOfSerial;
+    HullWhiteParams params;
+    size_t nSteps;
+    double stepDt;
+    double dx;
+    size_t jmax;
+
+    std::vector<Branch> branches;      // Indexed by j + jmax
+    std::vector<double> alpha;         // Per step
+    std::vector<double> zero;          // P(0, t_m), m = 0..nSteps
+    std::vector<size_t> discOffset;    // First node of step m in disc
+    std::vector<double> disc;          // exp(-(alpha_m + j dx) dt) per node
+};
+
+// ===========================
+// HullWhiteLatticeCache Class
+// ===========================
+// Shares calibrated lattices between trades and pricing calls. Entries are keyed by curve
+// name, valuation date and model parameters, and are valid while the curve's pillar hash
+// is unchanged; a request for a longer horizon rebuilds the entry to cover it. Lookups are
+// thread-safe and return immutable trees.
+class HullWhiteLatticeCache {
+public:
+    std::shared_ptr<const HullWhiteTree> get(const Market& mkt, const std::string& curveName,
+        const HullWhiteParams& params, size_t steps);
+
+    size_t size() const;
+    size_t builds() const;      // Calibrations performed so far
+    void clear();
+
+    static HullWhiteLatticeCache& global();
+
+    static constexpr size_t kMaxEntries = 64;
+
+private:
+    struct Entry {
+        uint64_t curveHash = 0;
+        std::shared_ptr<const HullWhiteTree> tree;
+    };
+    using Key = std::tuple<std::string, long, double, double, int>;
+
+    mutable std::mutex mtx;
+    std::map<Key, Entry> entries;
+    size_t buildCount = 0;
+};
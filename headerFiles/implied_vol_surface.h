@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// ===========================
+// ImpliedVolSurface Class
+// ===========================
+// Equity Black implied vols on an (expiry, forward moneyness K / F) grid. Expiries are year
+// fractions; the moneyness nodes are shared by every smile. The surface is held as total
+// variance w = vol^2 T:
+//   - each expiry slice is a natural cubic spline in y = ln(K / F), so w, dw/dy and
+//     d2w/dy2 are continuous (flat vol beyond the outer nodes);
+//   - between slices w is linear in T, with flat vol before the first and after the last;
+//   - slices are made non-decreasing in T node by node when loaded, which removes calendar
+//     arbitrage from noisy quotes.
+// This is the smoothed input a Dupire local-vol surface needs.
+class ImpliedVolSurface {
+public:
+    ImpliedVolSurface();
+    explicit ImpliedVolSurface(const std::string& name);
+
+    // Forward moneyness of every smile, e.g. { 0.8, 0.9, 1.0, 1.1, 1.2 }
+    void setMoneyness(const std::vector<double>& moneyness);
+
+    // Add or replace the smile at one expiry; one vol per moneyness node
+    void addSmile(double expiry, const std::vector<double>& smileVols);
+
+    // Implied vol for expiry T (years) struck at `strike` on `forward`
+    double getVol(double expiry, double strike, double forward) const;
+
+    // Total variance at (T, y) with optional dw/dT, dw/dy and d2w/dy2
+    double totalVariance(double expiry, double y, double* dwdT = nullptr, double* dwdy = nullptr,
+        double* d2wdy2 = nullptr) const;
+
+    void shock(double delta);                 // Parallel shock of every quote
+    void scale(double factor);                // Relative shock: every quote times factor
+
+    // FNV-1a hash of the quotes; changes whenever a vol moves
+    uint64_t fingerprint() const;
+
+    const std::string& getName() const { return name; }
+    const std::vector<double>& getExpiries() const { return expiries; }
+    const std::vector<double>& getLogMoneyness() const { return logMoneyness; }
+
+    void display() const;
+
+private:
+    std::string name;
+    std::vector<double> logMoneyness;
+
+    // Quotes as loaded, and the calendar-monotone total variance slices built from them
+    std::map<double, std::vector<double>> smiles;
+    std::vector<double> expiries;
+    std::vector<double> w;        // [e * n + j]
+    std::vector<double> w2;       // Spline second derivatives, same layout
+
+    void rebuild();
+    double slice(size_t e, double y, double* d1, double* d2) const;
+};
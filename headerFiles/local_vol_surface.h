@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "implied_vol_surface.h"
+
+class Market;
+
+struct LocalVolGridSpec {
+    size_t timeRows = 100;        // Rows from 0 to the horizon, inclusive of both ends
+    size_t spaceNodes = 401;      // Odd, so y = 0 (the forward) is the centre node
+    double width = 6.0;           // Half-width in ATM standard deviations at the horizon
+    double minVol = 0.01;         // Clamp for arbitrageable or degenerate points
+    double maxVol = 2.0;
+};
+
+// ===========================
+// LocalVolSurface Class
+// ===========================
+// Dupire local variance sampled on a (t, y) grid, y = ln(S / F(t)) the log forward
+// moneyness, from the total implied variance w(T, y) (Gatheral's form):
+//     sigma_loc^2 = (dw/dT) / (1 - (y/w) dw/dy + (-1/4 - 1/w + y^2/w^2)(dw/dy)^2 / 4 + d2w/dy2 / 2)
+// In forward moneyness the formula does not involve rates or spot, so one grid serves every
+// spot and curve scenario of the same implied surface (sticky moneyness).
+//
+// The y nodes are uniform with the forward on the centre node, and a PDE in y can use them
+// directly, so the only interpolation left at pricing time is a linear blend of two time
+// rows per step. The grid is immutable once built and safe to share across threads.
+class LocalVolSurface {
+public:
+    LocalVolSurface(const ImpliedVolSurface& surface, double horizon, const LocalVolGridSpec& spec = LocalVolGridSpec());
+
+    double horizon() const { return tMax; }
+    double dt() const { return rowDt; }
+    size_t rows() const { return nRows; }
+    size_t nodes() const { return nNodes; }
+    size_t centre() const { return nNodes / 2; }
+    double dy() const { return yStep; }
+    double y(size_t i) const { return (static_cast<double>(i) - static_cast<double>(centre())) * yStep; }
+
+    // Local variances of row m (t = m * dt()) over the y nodes
+    const double* row(size_t m) const { return var.data() + m * nNodes; }
+
+    // Local variances at time t over the y nodes, blended linearly between rows; flat past the horizon
+    void varianceAt(double t, double* out) const;
+
+    // Bilinear lookup, for inspection
+    double localVol(double t, double y) const;
+
+private:
+    double tMax;
+    double rowDt;
+    size_t nRows;
+    size_t nNodes;
+    double yStep;
+    std::vector<double> var;     // [m * nNodes + i]
+};
+
+// ===========================
+// LocalVolCache Class
+// ===========================
+// One local-vol grid per (underlying, valuation date, horizon bucket), valid while the implied
+// surface's fingerprint is unchanged, so every trade and thread pricing against the same
+// market snapshot shares one build. Horizons are bucketed to 30 days times a power of two:
+// the spatial step scales with the horizon, and a grid much longer than the trade would be
+// needlessly coarse. Lookups are thread-safe and return immutable grids.
+class LocalVolCache {
+public:
+    std::shared_ptr<const LocalVolSurface> get(const Market& mkt, const std::string& underlying, double horizon,
+        const LocalVolGridSpec& spec = LocalVolGridSpec());
+
+    size_t size() const;
+    size_t builds() const;        // Grids built so far
+    void clear();
+
+    static LocalVolCache& global();
+
+    static constexpr size_t kMaxEntries = 64;
+
+private:
+    struct Entry {
+        uint64_t surfaceHash = 0;
+        std::shared_ptr<const LocalVolSurface> grid;
+    };
+    using Key = std::tuple<std::string, long, int, size_t, size_t, double, double, double>;
+
+    mutable std::mutex mtx;
+    std::map<Key, Entry> entries;
+    size_t buildCount = 0;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "pricer.h"
+#include "market.h"
+#include "trade.h"
+#include "thread_pool.h"
+#include "path_generator.h"
+#include "monte_carlo_pricer.h"
+
+// ===========================
+// Longstaff-Schwartz Pricer
+// ===========================
+// Least-squares Monte Carlo for early-exercise options (AmericanOption, AmerCallSpread;
+// European trades never exercise early and price as plain simulation). GBM paths come
+// from a PathGenerator on `exerciseDates` equally spaced dates and are held in fixed-size
+// blocks. Walking backwards, each block accumulates the normal equations of a polynomial
+// regression of the discounted cash flow on S/S0 over paths with non-zero intrinsic value;
+// block moments are reduced in index order and the small system is solved once per date.
+// The exercise rule is the trade's own valueAtNode: where it departs from the regressed
+// continuation value the path takes that value as its cash flow, exactly as the tree does
+// at its nodes. Short positions are exercised by the counterparty, so for them the rule is
+// applied from the holder's side. Results are independent of the thread count.
+//
+// Regression and valuation use the same paths (the usual in-sample estimator), which has
+// a small upward bias that shrinks with the number of paths.
+class LsmPricer : public Pricer {
+public:
+    explicit LsmPricer(size_t nPaths, size_t exerciseDates = 50, uint64_t seed = 20250101,
+        ThreadPool& pool = ThreadPool::global());
+
+    void setSampling(Sampling method) { sampling = method; }
+    void setBasisDegree(size_t degree);
+
+    double price(const Market& mkt, std::shared_ptr<Trade> trade) const override;
+    McResult priceWithError(const Market& mkt, std::shared_ptr<Trade> trade) const;
+
+    static constexpr size_t kBlockPaths = 2048;
+    static constexpr size_t kMaxDegree = 6;
+
+private:
+    // Normal equations of one block: sum(phi phi') (upper triangle) and sum(phi y)
+    struct Regression {
+        std::vector<double> ata, aty;
+        Regression(size_t nBasis) : ata(nBasis * nBasis, 0.0), aty(nBasis, 0.0) {}
+        void add(const Regression& o);
+    };
+
+    struct PathBlock {
+        std::vector<double> spots;   // spots[k * kBlockPaths + p]
+        std::vector<double> cash;    // Cash flow of each path, discounted to the current date
+    };
+
+    void basis(double x, double* phi) const;
+    std::vector<double> solve(const Regression& r) const;
+
+    size_t nPaths;
+    size_t nDates;
+    uint64_t seed;
+    size_t degree = 3;
+    Sampling sampling = Sampling::PseudoRandom;
+    ThreadPool& pool;
+};
@@ -1,11 +1,17 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 #include "date.h"
 #include "rate_curve.h"
 #include "vol_curve.h"
+#include "swaption_vol_cube.h"
+#include "implied_vol_surface.h"
+#include "market_factor.h"
 
 class Market {
 public:
@@ -18,20 +24,50 @@ public:
     Market& operator=(const Market& other);  // Copy assignment
     ~Market();
 
+    // Shallow copy sharing every curve, vol and vol cube object with this market. Scenario
+    // code replaces only the objects it moves (addCurve/addVolCurve with a shocked clone),
+    // so building a scenario costs O(moved curves) instead of a full deep copy.
+    Market overlay() const;
+
+    // Replaces this market's copy of one factor with a deep copy of source's (dropped if source
+    // has none); FactorKind::Any copies everything. Keeps bumped risk markets in step with a
+    // live update without rebuilding them.
+    void copyFactor(const Market& source, const MarketFactor& factor);
+
     // Add or update
     void addCurve(const std::string& name, std::shared_ptr<RateCurve> curve);
     void addVolCurve(const std::string& name, std::shared_ptr<VolCurve> vol);
+    void addSwaptionVolCube(const std::string& name, std::shared_ptr<SwaptionVolCube> cube);
+    void addVolSurface(const std::string& underlying, std::shared_ptr<ImpliedVolSurface> surface);
     void addBondPrice(const std::string& bondName, double price);
     void addStockPrice(const std::string& stockName, double price);
 
     // Accessors
     std::shared_ptr<RateCurve> getCurve(const std::string& name) const;
     std::shared_ptr<VolCurve> getVolCurve(const std::string& name) const;
+    std::shared_ptr<SwaptionVolCube> getSwaptionVolCube(const std::string& name) const;
+    bool hasSwaptionVolCube(const std::string& name) const;
+    std::vector<std::string> getSwaptionVolCubeNames() const;
+    std::shared_ptr<ImpliedVolSurface> getVolSurface(const std::string& underlying) const;
+    bool hasVolSurface(const std::string& underlying) const;
+    std::vector<std::string> getVolSurfaceNames() const;
     double getStockPrice(const std::string& stockName) const;
     double getBondPrice(const std::string& bondName) const;
     const Date& getAsOf() const { return asOf; };
     void shockPrice(const std::string& symbol, double bump);
 
+    // === Versioning ===
+    // Every add and shock stamps the factor with a new process-wide monotonic version; copies
+    // and overlays keep the versions of what they copy, so equal versions mean equal content.
+    // Code that mutates an object in place through a getter must touch() it afterwards.
+    uint64_t version(const MarketFactor& factor) const;   // 0 if absent; Any: highest version held
+    void touch(const MarketFactor& factor);
+    // Hash of the valuation date and the versions of the listed factors (Any: all factors);
+    // equal keys mean a trade reading only those factors sees the same market
+    uint64_t stateKey(const std::vector<MarketFactor>& factors) const;
+    // Every factor held, in MarketFactor order
+    std::vector<MarketFactor> getFactors() const;
+
 
     // File loaders
     void loadCurveFromFile(const std::string& filename);
@@ -42,10 +78,16 @@ public:
     void Print() const;
 
 private:
+    struct ShareTag {};
+    Market(const Market& other, ShareTag);   // Shallow copy used by overlay()
+
     std::unordered_map<std::string, std::shared_ptr<RateCurve>> curves;
     std::unordered_map<std::string, std::shared_ptr<VolCurve>> vols;
+    std::unordered_map<std::string, std::shared_ptr<SwaptionVolCube>> swaptionVols;
+    std::unordered_map<std::string, std::shared_ptr<ImpliedVolSurface>> volSurfaces;   // By underlying
     std::unordered_map<std::string, double> bondPrices;
     std::unordered_map<std::string, double> stockPrices;
+    std::map<MarketFactor, uint64_t> versions;
 };
 
 std::ostream& operator<<(std::ostream& os, const Market& obj);
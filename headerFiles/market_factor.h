@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <tuple>
+
+// ===========================
+// FactorKind Enumeration
+// ===========================
+enum class FactorKind
+{
+    Curve,          // RateCurve by curve name
+    Vol,            // VolCurve by name (e.g. LOGVOL)
+    SwaptionCube,   // SwaptionVolCube by name
+    VolSurface,     // ImpliedVolSurface by underlying
+    Spot,           // Stock price by symbol
+    BondPrice,      // Bond price by name
+    Any             // Wildcard: depends on (or moves) everything
+};
+
+// ===========================
+// MarketFactor Struct
+// ===========================
+// One named object in a Market. Names are upper-cased, as Market stores them, so factors
+// compare equal however the trade or the caller spells them.
+struct MarketFactor {
+    FactorKind kind = FactorKind::Any;
+    std::string name;
+
+    MarketFactor() = default;
+    MarketFactor(FactorKind k, const std::string& n) : kind(k), name(n) {
+        std::transform(name.begin(), name.end(), name.begin(),
+            [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    }
+
+    bool operator<(const MarketFactor& o) const { return std::tie(kind, name) < std::tie(o.kind, o.name); }
+    bool operator==(const MarketFactor& o) const { return kind == o.kind && name == o.name; }
+
+    std::string toString() const {
+        static const char* labels[] = { "Curve", "Vol", "SwaptionCube", "VolSurface", "Spot", "BondPrice", "Any" };
+        return kind == FactorKind::Any ? "Any" : std::string(labels[static_cast<int>(kind)]) + ":" + name;
+    }
+};
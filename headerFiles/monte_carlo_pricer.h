@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "pricer.h"
+#include "market.h"
+#include "trade.h"
+#include "thread_pool.h"
+#include "path_generator.h"
+
+struct McResult {
+    double price = 0.0;
+    double stdError = 0.0;
+    size_t paths = 0;
+};
+
+// Running sums of a discounted payoff Y and a control X over a set of paths
+struct McMoments {
+    double n = 0, sy = 0, syy = 0, sx = 0, sxx = 0, sxy = 0;
+
+    void add(double y, double x);
+    void add(const McMoments& o);
+
+    // Mean of Y (control-variate adjusted when useControl) and its per-sample variance
+    void estimate(bool useControl, double exactControl, double& mean, double& variance) const;
+};
+
+// Price and standard error from per-replicate moments. A single replicate uses the sample
+// variance; several (randomized QMC) use the spread of the replicate estimates.
+McResult combineReplicates(const std::vector<McMoments>& reps, bool useControl, double exactControl);
+
+// ===========================
+// Monte Carlo Pricer
+// ===========================
+// GBM simulation for European payoffs (EuropeanOption, EuroCallSpread) on an equally spaced
+// grid of `timeSteps` dates built by a PathGenerator. Paths are generated in fixed-size
+// blocks that are a pure function of (seed, replicate, block index), so a block is identical
+// whichever thread simulates it. Each block fills contiguous normal/Brownian/spot arrays for
+// vectorization and returns its sample moments; blocks are reduced in index order, so price
+// and standard error do not depend on the number of threads. Variance reduction: antithetic
+// pairs and a vanilla control valued by BlackScholesPricer.
+//
+// Pseudo-random sampling reports the sample standard error. Sobol sampling splits the paths
+// over `replicates` independently shifted copies of the same point set and reports the
+// spread of the replicate estimates; use power-of-two path counts per replicate.
+class MonteCarloPricer : public Pricer {
+public:
+    explicit MonteCarloPricer(size_t nPaths, uint64_t seed = 20250101, ThreadPool& pool = ThreadPool::global());
+
+    void setAntithetic(bool on) { antithetic = on; }
+    void setControlVariate(bool on) { controlVariate = on; }
+    void setSampling(Sampling method) { sampling = method; }
+    void setTimeSteps(size_t steps);
+    void setReplicates(size_t count);
+
+    double price(const Market& mkt, std::shared_ptr<Trade> trade) const override;
+    McResult priceWithError(const Market& mkt, std::shared_ptr<Trade> trade) const;
+
+    static constexpr size_t kBlockPaths = 2048;   // Upper bound; smaller runs use the next power of two
+
+private:
+    struct GbmInputs {
+        GbmParams gbm;
+        double T, df;
+        double controlStrike;
+        bool controlIsCall;
+    };
+
+    McMoments simulateBlock(const PathGenerator& gen, uint32_t replicate, uint64_t block, size_t blockPaths,
+        const GbmInputs& in, const Trade& trade) const;
+
+    size_t nPaths;
+    uint64_t seed;
+    bool antithetic = true;
+    bool controlVariate = true;
+    Sampling sampling = Sampling::PseudoRandom;
+    size_t timeSteps = 1;
+    size_t replicates = 16;
+    ThreadPool& pool;
+};
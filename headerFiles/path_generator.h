@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "brownian_bridge.h"
+#include "philox.h"
+#include "sobol.h"
+
+enum class Sampling {
+    PseudoRandom,   // Philox normals, error ~ 1/sqrt(N)
+    Sobol           // Digitally shifted Sobol points, one shift per replicate
+};
+
+struct GbmParams {
+    double spot = 0.0;
+    double rate = 0.0;
+    double vol = 0.0;
+};
+
+// ===========================
+// PathGenerator Class
+// ===========================
+// Sampling backend for simulation pricers. Produces standard normals for a block of path
+// indices, turns them into Brownian levels with a BrownianBridge on the time grid, and
+// maps those to GBM spots. Everything is a pure function of (seed, replicate, path index),
+// so blocks can be generated by any thread in any order.
+//
+// Sobol dimension d drives bridge step d. Grids longer than the embedded direction table
+// (SobolSequence::kMaxDimensions) fill the remaining, fine-scale bridge dimensions with
+// Philox normals; the bridge keeps nearly all of the variance in the leading dimensions.
+// Each replicate applies a different random digital shift, so independent replicates of
+// the same point set give an unbiased estimate and a standard error.
+class PathGenerator {
+public:
+    PathGenerator(std::vector<double> times, Sampling sampling, uint64_t seed);
+
+    size_t steps() const { return times.size(); }
+    const std::vector<double>& getTimes() const { return times; }
+    Sampling getSampling() const { return sampling; }
+
+    // Normals for paths [first, first + count) of `replicate`; z[d * count + p]
+    void normals(uint64_t first, size_t count, uint32_t replicate, double* z) const;
+
+    // Brownian levels w[k * count + p] = W(t_k) of path p
+    void brownian(const double* z, size_t count, double* w) const { bridge.build(z, count, w); }
+
+    // Spots s[k * count + p] = spot * exp((r - vol^2/2) t_k + sign * vol * W(t_k));
+    // sign = -1 gives the antithetic paths from the same Brownian levels
+    void spots(const GbmParams& gbm, const double* w, size_t count, double sign, double* s) const;
+
+private:
+    std::vector<double> times;
+    Sampling sampling;
+    Philox4x32 rng;
+    BrownianBridge bridge;
+    std::unique_ptr<SobolSequence> sobol;   // Null for pseudo-random sampling
+};
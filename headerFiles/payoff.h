@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <stdexcept>
 
 #include "types.h"
@@ -40,4 +42,21 @@ namespace PAYOFF
     {
         return std::max(0.0, S - strike1) - std::max(0.0, S - strike2);
     }
+
+    // Average of the fixings: arithmetic mean or geometric mean (via the mean log)
+    inline double Average(AverageType avgType, const double* fixings, size_t n)
+    {
+        double sum = 0.0;
+        if (avgType == AverageType::Geometric) {
+            for (size_t i = 0; i < n; ++i) sum += std::log(fixings[i]);
+            return std::exp(sum / static_cast<double>(n));
+        }
+        for (size_t i = 0; i < n; ++i) sum += fixings[i];
+        return sum / static_cast<double>(n);
+    }
+
+    inline bool IsKnockIn(BarrierType barrierType)
+    {
+        return barrierType == BarrierType::UpAndIn || barrierType == BarrierType::DownAndIn;
+    }
 }
\ No newline at end of file
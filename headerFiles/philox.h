@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// ===========================
+// Philox4x32-10 Counter-Based Generator
+// ===========================
+// Salmon et al. (2011). The output is a pure function of (key, counter): any path block
+// can be generated by any thread in any order and still produce the same numbers, which
+// is what makes Monte Carlo results independent of the thread count.
+class Philox4x32 {
+public:
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    explicit Philox4x32(uint64_t seed)
+        : key{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) } {
+    }
+
+    // Ten rounds of the Philox bijection applied to `ctr`
+    Counter operator()(Counter ctr) const {
+        Key k = key;
+        for (int round = 0; round < 10; ++round) {
+            ctr = singleRound(ctr, k);
+            k[0] += 0x9E3779B9u;   // Golden ratio Weyl sequence
+            k[1] += 0xBB67AE85u;   // sqrt(3) - 1
+        }
+        return ctr;
+    }
+
+    // Four uniforms in (0, 1) for the given (stream, block, index) coordinates
+    void uniforms(uint32_t stream, uint64_t block, uint32_t index, double out[4]) const {
+        Counter c = (*this)(Counter{ index, static_cast<uint32_t>(block),
+            static_cast<uint32_t>(block >> 32), stream });
+        for (int i = 0; i < 4; ++i)
+            out[i] = (static_cast<double>(c[i]) + 0.5) * 2.3283064365386963e-10;   // 2^-32
+    }
+
+private:
+    static Counter singleRound(const Counter& c, const Key& k) {
+        const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * c[0];
+        const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * c[2];
+        const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+        const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+        return Counter{ hi1 ^ c[1] ^ k[0], lo1, hi0 ^ c[3] ^ k[1], lo0 };
+    }
+
+    Key key;
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+#include "risk_engine.h"
+#include "discount_table.h"
+#include "thread_pool.h"
+#include "exotic_batch_pricer.h"
+#include "swaption_batch_pricer.h"
+
+struct TradeResult {
+    size_t id = 0;
+    std::string tradeInfo;
+    double PV = 0.0;
+    double DV01 = 0.0;
+    double Vega = 0.0;
+    std::map<std::string, double> dv01Buckets;   // By shocked curve; sums to DV01
+    std::map<std::string, double> vegaBuckets;   // By shocked vol curve or cube; sums to Vega
+};
+
+struct AggregateResult {
+    std::string key;
+    size_t tradeCount = 0;
+    double PV = 0.0;
+    double DV01 = 0.0;
+    double Vega = 0.0;
+};
+
+enum class AggregateBy {
+    Book,
+    Underlying,
+    Curve
+};
+
+// Grouping key of a trade at the given aggregation level
+std::string aggregateKey(const Trade& trade, AggregateBy level);
+
+// ===========================
+// PortfolioValuer Class
+// ===========================
+// Prices a portfolio on the work-stealing pool. Trades are visited in chunks of trades
+// with the same type and underlying so each task touches the same market data and code
+// path; every trade writes only to its own preallocated result slot. Aggregates are
+// reduced serially in trade order with pairwise summation, so totals are bit-identical
+// whatever the thread count or scheduling.
+//
+// Each trade's declared market dependencies are inverted at construction into an index from
+// market factor to trades. After the caller moves objects in the valuer's market, update()
+// marks only the dependent trades dirty and reprices them (PV and risk), so a spot tick on
+// one underlying touches only its options. Objects aliased under several names (USD-GOV
+// sharing USD-SOFR's curve) must be listed under each name.
+//
+// Asians, barriers and European swaptions are not valued trade by trade: per market (the
+// base and each bumped market) one ExoticBatchPricer call prices the exotics on shared paths
+// and grids, skipping PVs already in the cache, and one SwaptionBatchPricer call prices the
+// swaptions off a single evaluation of their discount factors.
+class PortfolioValuer {
+public:
+    PortfolioValuer(const Market& mkt,
+        const std::vector<std::shared_ptr<Trade>>& portfolio,
+        double curveShock,
+        double volShock,
+        ThreadPool& pool = ThreadPool::global());
+
+    void setChunkSize(size_t n) { chunkSize = n; }
+    // Memoize tree PVs and off-table risk PVs across runs and updates (nullptr disables)
+    void setCache(ValuationCache* valuationCache);
+
+    // Price all trades; results are indexed like the portfolio
+    const std::vector<TradeResult>& run();
+    const std::vector<TradeResult>& getResults() const { return results; }
+
+    // === Incremental Repricing ===
+    // Reprices the trades that depend on any moved factor; returns how many repriced.
+    // Prices everything first if run() has not been called.
+    size_t update(const std::vector<MarketFactor>& moved);
+    // Trades (portfolio indices) that read a factor, wildcard dependents included
+    std::vector<size_t> dependents(const MarketFactor& factor) const;
+
+    // === Off-Portfolio Valuation ===
+    // PV and risk of a trade that is not in the portfolio, against the same warm market,
+    // bumped markets and pricers (it is not bound to the discount table, so it discounts off
+    // the curves directly). Safe to call concurrently with other const calls.
+    TradeResult valueExternal(const std::shared_ptr<Trade>& trade) const;
+    // Portfolio index of the trade with this id, or -1
+    long findTrade(const std::string& id) const;
+
+    // === Deterministic Aggregation ===
+    std::vector<AggregateResult> aggregate(AggregateBy level) const;
+    AggregateResult total() const;
+
+    std::shared_ptr<const DiscountTable> getDiscountTable() const { return dfTable; }
+    const Market& getMarket() const { return market; }
+    const std::vector<std::shared_ptr<Trade>>& getTrades() const { return trades; }
+
+private:
+    void valueTrade(size_t i, TradeResult& r) const;
+    void valueInto(const std::shared_ptr<Trade>& trade, bool bound, TradeResult& r) const;
+    void addRisk(TradeResult& r, const std::map<std::string, double>& dv01, const std::map<std::string, double>& vega) const;
+
+    // Batched trades: PV and risk of trades[idx[k]], where price(mkt)[k] is its PV under mkt
+    void valueBatches(const std::vector<size_t>& idx);
+    void valueBatch(const std::vector<size_t>& idx, const RiskEngine::BatchPricing& price);
+    std::vector<double> batchPv(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& batch) const;
+
+    const Market& market;
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    ThreadPool& pool;
+
+    double curveShockSize;
+    double volShockSize;
+    size_t chunkSize = 64;
+
+    std::shared_ptr<DiscountTable> dfTable;
+    std::vector<double> baseDfs;
+    RiskEngine engine;
+    ValuationCache* cache = nullptr;
+    ExoticBatchPricer exoticPricer;
+    SwaptionBatchPricer swaptionPricer;
+    std::vector<char> batched;          // Valued by valueBatch rather than valueTrade
+    std::vector<size_t> swaptionSlot;   // Position in swaptionPricer, or npos
+
+    std::vector<size_t> order;          // Trade indices grouped by (type, underlying)
+    std::vector<size_t> rank;           // Position of each trade in order
+    std::vector<TradeResult> results;
+
+    std::map<MarketFactor, std::vector<size_t>> dependencyIndex;
+    std::vector<size_t> wildcardTrades; // Undeclared dependencies: reprice on every update
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "market.h"
+#include "market_factor.h"
+#include "portfolio_valuer.h"
+#include "thread_pool.h"
+
+// ===========================
+// Wire Protocol
+// ===========================
+// Every message is a frame: u32 payload length, then the payload. Integers and doubles are
+// little-endian, strings are u32 length + bytes.
+//   Request payload:  u8 op, u32 id, string text, u8 factor kind, f64 bump
+//   Response payload: u32 id, u8 status (0 ok, 1 error), u32 n, n x f64 values, string error
+// Responses on one connection come back in request order, so clients may pipeline.
+enum class ServerOp : uint8_t {
+    Ping = 0,
+    PriceTrade = 1,     // text: trade.txt row            -> PV, DV01, Vega
+    WhatIfAdd = 2,      // text: trade.txt row            -> dPV, dDV01, dVega, PV, DV01, Vega of the portfolio with it
+    WhatIfRemove = 3,   // text: trade id                 -> dPV, dDV01, dVega, PV, DV01, Vega of the portfolio without it
+    BumpMarket = 4,     // text: factor name, factor, bump -> trades repriced, PV, DV01, Vega after the move
+    GetRisk = 5,        // text: trade id, empty = total  -> PV, DV01, Vega
+    Shutdown = 255
+};
+
+struct ServerRequest {
+    ServerOp op = ServerOp::Ping;
+    uint32_t id = 0;
+    std::string text;
+    FactorKind factor = FactorKind::Any;
+    double bump = 0.0;    // Curves, vols, cubes and surfaces: parallel shift; spots: relative; bond prices: absolute
+};
+
+struct ServerResponse {
+    uint32_t id = 0;
+    bool ok = true;
+    std::vector<double> values;
+    std::string error;
+};
+
+namespace wire {
+    std::vector<uint8_t> encode(const ServerRequest& req);      // Whole frame, length prefix included
+    std::vector<uint8_t> encode(const ServerResponse& resp);
+    ServerRequest decodeRequest(const uint8_t* payload, size_t n);
+    ServerResponse decodeResponse(const uint8_t* payload, size_t n);
+
+    constexpr uint32_t kMaxFrame = 1u << 20;
+}
+
+// ===========================
+// PricingServer Class
+// ===========================
+// Long-running pricing daemon over a local Unix domain socket. The market, portfolio and
+// PortfolioValuer are loaded once by the caller and stay warm: schedules and the discount
+// table are bound, bumped risk markets built, and the lattice and local-vol caches fill on
+// first use and are reused by every later request.
+//
+// One reader thread per connection decodes frames into a shared queue; readers of closed
+// connections are joined on the next accept, so a long-lived daemon does not accumulate
+// them. A single dispatcher
+// drains the queue in batches of up to maxBatch. Consecutive read-only requests (price,
+// what-if, risk) from any connection run in parallel on the pool. Market bumps are
+// barriers: they apply in arrival order and reprice only the dependent trades
+// (PortfolioValuer::update), so a read never sees a half-applied move. What-if requests never
+// change the booked portfolio.
+class PricingServer {
+public:
+    PricingServer(Market& mkt, PortfolioValuer& valuer, size_t maxBatch = 256, ThreadPool& pool = ThreadPool::global());
+    ~PricingServer();
+
+    PricingServer(const PricingServer&) = delete;
+    PricingServer& operator=(const PricingServer&) = delete;
+
+    // Listen on socketPath until a Shutdown request or stop(); blocks the calling thread
+    void serve(const std::string& socketPath);
+    void stop();
+
+    // Executes one batch in-process, exactly as the dispatcher does; responses in request order
+    std::vector<ServerResponse> handleBatch(const std::vector<ServerRequest>& batch);
+
+    size_t requestsServed() const { return requestCount; }
+    size_t batchesServed() const { return batchCount; }
+
+private:
+    struct Connection;
+    struct Pending {
+        ServerRequest request;
+        std::shared_ptr<Connection> conn;
+    };
+
+    struct ReaderThread {
+        std::thread thread;
+        std::weak_ptr<Connection> conn;
+        std::shared_ptr<std::atomic<bool>> done;   // Set by the reader as it exits
+    };
+
+    void readLoop(std::shared_ptr<Connection> conn, std::shared_ptr<std::atomic<bool>> done);
+    void reapReaders();     // Joins the finished readers; caller holds connMtx
+    void dispatchLoop();
+    ServerResponse execute(const ServerRequest& req, const AggregateResult& total) const;
+    ServerResponse bump(const ServerRequest& req);
+
+    Market& market;
+    PortfolioValuer& valuer;
+    ThreadPool& pool;
+    size_t maxBatch;
+
+    std::mutex queueMtx;
+    std::condition_variable queueCv;
+    std::deque<Pending> queue;
+
+    std::mutex connMtx;
+    std::vector<ReaderThread> readers;
+
+    std::atomic<bool> running{ false };
+    std::intptr_t listenSocket = -1;
+    std::atomic<size_t> requestCount{ 0 };
+    std::atomic<size_t> batchCount{ 0 };
+};
+
+// ===========================
+// PricingClient Class
+// ===========================
+// Blocking client for the same protocol; callBatch pipelines a batch on one connection.
+class PricingClient {
+public:
+    explicit PricingClient(const std::string& socketPath);
+    ~PricingClient();
+
+    PricingClient(const PricingClient&) = delete;
+    PricingClient& operator=(const PricingClient&) = delete;
+
+    ServerResponse call(const ServerRequest& req);
+    std::vector<ServerResponse> callBatch(const std::vector<ServerRequest>& reqs);
+
+private:
+    std::intptr_t sock = -1;
+    uint32_t nextId = 1;
+};
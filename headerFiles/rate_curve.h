@@ -3,6 +3,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "date.h"
 
 // ===========================
@@ -29,6 +30,11 @@ public:
     // Get the curve name identifier (e.g., "USD-SOFR")
     std::string getName() const { return name; }
 
+    // Pillars and an FNV-1a hash of them; the hash changes whenever a rate moves
+    const std::vector<Date>& getTenorDates() const { return tenorDates; }
+    const std::vector<double>& getRates() const { return rates; }
+    uint64_t fingerprint() const;
+
 
 private:
     std::string name;               // Name of the curve
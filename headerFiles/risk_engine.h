@@ -1,10 +1,14 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <map>
 #include <string>
+#include <vector>
 #include "market.h"
 #include "trade.h"
+#include "discount_table.h"
+#include "valuation_cache.h"
 
 struct MarketShock {
     std::string market_id;
@@ -17,7 +21,13 @@ public:
     const Market& getMarketUp() const;
     const Market& getMarketDown() const;
 
+    // Re-copy moved factors from the live market, re-bumping the shocked curve if it moved
+    void refresh(const Market& mkt, const std::vector<MarketFactor>& moved);
+
 private:
+    void apply();
+
+    MarketShock spec;
     Market thisMarketUp;
     Market thisMarketDown;
 };
@@ -28,11 +38,17 @@ public:
     const Market& getMarket() const;
     const Market& getOriginMarket() const;
 
+    void refresh(const Market& mkt, const std::vector<MarketFactor>& moved);
+
 private:
+    void apply();
+
+    MarketShock spec;
     Market thisMarket;
     Market originMarket;
 };
 
+// Spot market_id moved by a relative shock.second (the tenor is unused)
 class PriceDecorator {
 public:
     PriceDecorator(const Market& mkt, const MarketShock& shock);
@@ -49,6 +65,29 @@ public:
     void computeRisk(std::string riskType, std::shared_ptr<Trade> trade, bool singleThread = true);
     std::map<std::string, double> getResult() const;
 
+    // Stateless variant of computeRisk, safe to call concurrently from pool workers. Trades not
+    // bound to the discount table (priced off-portfolio) pass useDiscountTable = false.
+    std::map<std::string, double> evaluateRisk(const std::string& riskType, std::shared_ptr<Trade> trade,
+        bool singleThread = true, bool useDiscountTable = true) const;
+
+    // evaluateRisk for trades valued together: `price` returns the PVs of all `count` trades
+    // under one market, so each bumped market costs one batch call instead of one per trade.
+    // Element k holds the buckets of the k-th trade of the batch.
+    using BatchPricing = std::function<std::vector<double>(const Market&)>;
+    std::vector<std::map<std::string, double>> evaluateRiskBatch(const std::string& riskType, size_t count,
+        const BatchPricing& price) const;
+
+    // Evaluate the shared discount table once per bumped market; rate trades then gather from it
+    void setDiscountTable(std::shared_ptr<const DiscountTable> table);
+
+    // Bring every bumped market up to date after the listed factors moved in the base market;
+    // re-evaluates the discount table too if a curve moved
+    void refresh(const Market& market, const std::vector<MarketFactor>& moved);
+
+    // Memoize off-table PVs under base and bumped markets (nullptr disables); a bumped market
+    // that leaves a trade's dependencies untouched then costs a lookup
+    void setCache(ValuationCache* valuationCache) { cache = valuationCache; }
+
 private:
     double curveShockSize;
     double volShockSize;
@@ -57,4 +96,17 @@ private:
     std::map<std::string, CurveDecorator> curveShocks;
     std::map<std::string, VolDecorator> volShocks;
     std::map<std::string, double> result;
+
+    struct ShockedDfs {
+        std::vector<double> up;
+        std::vector<double> down;
+    };
+    std::shared_ptr<const DiscountTable> dfTable;
+    std::map<std::string, ShockedDfs> curveShockDfs;
+    std::vector<double> baseDfs;
+    ValuationCache* cache = nullptr;
+
+    double pvUnder(const Trade& trade, const Market& mkt, const std::vector<double>* dfs) const;
+    double curveRisk(const std::string& market_id, const CurveDecorator& shock, const Trade& trade, bool useTable = true) const;
+    double volRisk(const VolDecorator& shock, const Trade& trade, bool useTable = true) const;
 };
\ No newline at end of file
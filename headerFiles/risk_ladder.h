@@ -0,0 +1,106 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+#include "thread_pool.h"
+
+class ChebyshevProxy;
+
+// ===========================
+// LadderSpec
+// ===========================
+// Grid of relative spot moves times absolute LOGVOL moves. Keep 0 in both axes for the
+// gamma and vanna read-outs.
+struct LadderSpec {
+    std::vector<double> spotMoves;   // e.g. -0.2 .. +0.2
+    std::vector<double> volMoves;    // e.g. -0.05, 0, +0.05
+    int treeSteps = 200;             // Lattice steps for early-exercise trades
+
+    // `steps` evenly spaced spot moves from lo to hi
+    static LadderSpec uniform(double lo, double hi, size_t steps, std::vector<double> volMoves);
+};
+
+// ===========================
+// RiskLadder
+// ===========================
+// Dense P&L against the unmoved market, per trade (or per underlying) then vol level then
+// spot move, so one trade's whole grid is contiguous.
+class RiskLadder {
+public:
+    RiskLadder() = default;
+    RiskLadder(size_t nRows, size_t nVols, size_t nSpots);
+
+    double& at(size_t row, size_t vol, size_t spot) { return data[(row * nVols + vol) * nSpots + spot]; }
+    double at(size_t row, size_t vol, size_t spot) const { return data[(row * nVols + vol) * nSpots + spot]; }
+    const double* row(size_t r) const { return &data[r * nVols * nSpots]; }
+
+    size_t rowCount() const { return nRows; }
+    size_t volCount() const { return nVols; }
+    size_t spotCount() const { return nSpots; }
+
+private:
+    size_t nRows = 0;
+    size_t nVols = 0;
+    size_t nSpots = 0;
+    std::vector<double> data;
+};
+
+// Second-order read-outs from a ladder row around the zero moves (0 if the grid lacks them):
+// gamma is the spot second difference per unit relative move squared, vanna the spot-vol
+// cross difference per unit relative spot move and unit vol
+struct LadderGreeks {
+    double gamma = 0.0;
+    double vanna = 0.0;
+};
+
+// ===========================
+// LadderEngine Class
+// ===========================
+// Spot/vol ladders without one repricing per grid point:
+//   - EuropeanOption and EuroCallSpread: closed-form Black-Scholes at every point;
+//   - AmericanOption and AmerCallSpread: one CRR lattice per vol level, widened so its
+//     time-0 layer holds node values across the whole spot range; each spot move is read off
+//     that layer by quadratic interpolation in log spot;
+//   - other spot-dependent trades: the tree pricer on one overlay per grid point.
+// With a proxy set, trades it covers read every grid point off their interpolant instead,
+// unless the grid leaves the fitted box. Trades that depend on no spot are left at zero.
+// Trades run in parallel.
+class LadderEngine {
+public:
+    LadderEngine(const Market& market,
+        const std::vector<std::shared_ptr<Trade>>& portfolio,
+        ThreadPool& pool = ThreadPool::global());
+
+    const RiskLadder& run(const LadderSpec& spec);
+    const RiskLadder& getLadder() const { return ladder; }
+    const LadderSpec& getSpec() const { return spec; }
+
+    // Rows summed per underlying, in trade order
+    std::map<std::string, std::vector<double>> byUnderlying() const;
+    LadderGreeks greeks(const double* rowGrid) const;
+
+    size_t latticeBuilds() const { return latticeCount; }   // In the last run
+
+    void setProxy(const ChebyshevProxy* p) { proxy = p; }
+
+private:
+    bool ladderProxy(size_t t);
+    void ladderAnalytic(size_t t);
+    void ladderLattice(size_t t);
+    void ladderReprice(size_t t);
+
+    const Market& mkt;
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    ThreadPool& pool;
+    const ChebyshevProxy* proxy = nullptr;
+
+    LadderSpec spec;
+    RiskLadder ladder;
+    std::vector<char> laddered;    // Per trade: depends on a spot and has a ladder row
+    size_t latticeCount = 0;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "historical_var.h"
+
+// ===========================
+// ScenarioPnlStore Class
+// ===========================
+// Persisted scenario P&L keyed by (trade id, scenario date). Each trade also records the
+// fingerprint of the terms it was valued with, so amended trades are detected on reload.
+class ScenarioPnlStore {
+public:
+    struct Entry {
+        uint64_t fingerprint = 0;
+        std::map<long, double> pnl;   // Scenario date serial -> P&L
+    };
+
+    bool load(const std::string& filename);
+    void save(const std::string& filename) const;
+
+    Entry* find(const std::string& tradeId);
+    const Entry* find(const std::string& tradeId) const;
+    Entry& upsert(const std::string& tradeId, uint64_t fingerprint);
+
+    // Drop trades not listed and scenario dates outside the window
+    void retain(const std::vector<std::string>& tradeIds, const std::vector<long>& dates);
+
+    size_t tradeCount() const { return entries.size(); }
+    size_t size() const;
+
+private:
+    std::map<std::string, Entry> entries;
+};
+
+struct RollStats {
+    size_t scenarios = 0;          // Scenarios in the current window
+    size_t newScenarios = 0;       // Scenario dates no stored trade had seen
+    size_t repricedTrades = 0;     // New or amended trades revalued on every scenario
+    size_t revaluations = 0;       // (trade, scenario) pairs revalued this run
+    size_t reused = 0;             // (trade, scenario) pairs taken from the store
+};
+
+// ===========================
+// RollingVarEngine Class
+// ===========================
+// Incremental historical VaR over a rolling window. Stored P&L is reused for unchanged
+// trades; only (trade, scenario) pairs missing from the store are revalued, i.e. the
+// newly added day for the whole book plus every day for new or amended trades. Dates
+// that leave the window are evicted. The per-scenario portfolio P&L vector is then
+// re-derived from the store in trade order, so the quantile and ES stay deterministic.
+// Reused P&L keeps the base market of the run that produced it, as a rolling VaR does.
+class RollingVarEngine {
+public:
+    RollingVarEngine(const Market& base,
+        const std::vector<std::shared_ptr<Trade>>& portfolio,
+        size_t windowSize,
+        std::shared_ptr<const DiscountTable> table = nullptr,
+        ThreadPool& pool = ThreadPool::global());
+
+    bool loadStore(const std::string& filename) { return store.load(filename); }
+    void saveStore(const std::string& filename) const { store.save(filename); }
+
+    // Roll the window forward to the latest `windowSize` scenarios and update the store
+    RollStats update(std::vector<HistoricalScenario> scenarios);
+
+    const std::vector<Date>& getWindow() const { return windowDates; }
+    const std::vector<HistoricalScenario>& getWindowScenarios() const { return windowScenarios; }
+    const std::vector<double>& getPortfolioPnl() const { return portfolioPnl; }
+    std::vector<double> tradePnl(size_t tradeIndex) const;   // Window-ordered P&L from the store
+
+    VarResult portfolioVaR(double confidence) const;
+    std::map<std::string, VarResult> varBy(AggregateBy level, double confidence) const;
+
+    // Trades the proxy covers are revalued from it (null: none)
+    void setProxy(ChebyshevProxy* proxy) { revaluer.setProxy(proxy); }
+
+private:
+    std::string idOf(size_t tradeIndex) const;
+
+    const Market& baseMarket;
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    size_t window;
+    ThreadPool& pool;
+
+    HistoricalVarEngine revaluer;
+    ScenarioPnlStore store;
+
+    std::vector<HistoricalScenario> windowScenarios;
+    std::vector<Date> windowDates;
+    std::vector<long> windowSerials;
+    std::vector<double> portfolioPnl;
+};
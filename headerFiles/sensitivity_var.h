@@ -0,0 +1,117 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "historical_var.h"
+
+// ===========================
+// SensitivityVarConfig
+// ===========================
+struct SensitivityVarConfig {
+    double curveBump = 0.0001;    // Absolute, per curve pillar
+    double volBump = 0.01;        // Absolute, per vol pillar
+    double spotBump = 0.01;       // Relative, per spot
+
+    // Error monitoring: every `checkEvery` runs (0 = never), `sampleSize` approximated trades
+    // are fully revalued on every scenario; a trade whose RMS error exceeds `tolerance` times
+    // max(RMS full-reval P&L, absFloor) is promoted to full revaluation for good
+    size_t checkEvery = 1;
+    size_t sampleSize = 8;
+    double tolerance = 0.05;
+    double absFloor = 1.0;
+};
+
+struct SensitivityVarStats {
+    size_t factors = 0;            // Scenario risk factors (curve/vol pillars, spots)
+    size_t sensitivities = 0;      // Non-zero trade x factor entries
+    size_t approximated = 0;       // Trades priced from sensitivities
+    size_t fullReval = 0;          // Trades fully revalued on every scenario
+    size_t checked = 0;            // Trades checked against full revaluation in the last run
+    size_t promoted = 0;           // Trades promoted in the last run
+};
+
+// ===========================
+// SensitivityVarEngine Class
+// ===========================
+// Fast historical VaR from a Taylor expansion. Each scenario column (a curve or vol pillar
+// move, or a spot return) is a risk factor; sensitivities are bumped once on the base
+// market (key-rate DV01s, pillar vegas, spot delta and gamma), with each bumped market
+// shared by every dependent trade, and stored sparsely per trade. Scenario P&L is then the
+// sparse product of the sensitivity rows with the dense scenario-by-factor move matrix, plus
+// the spot gamma term; no market is built per scenario.
+//
+// Trades that declare no dependencies, and trades promoted by the error monitor, are fully
+// revalued instead, on one overlay per scenario shared by all of them. The monitor samples
+// approximated trades round-robin so the whole book is covered over successive runs.
+class SensitivityVarEngine {
+public:
+    SensitivityVarEngine(const Market& base,
+        const std::vector<std::shared_ptr<Trade>>& portfolio,
+        std::shared_ptr<const DiscountTable> table = nullptr,   // Built from the portfolio if null
+        ThreadPool& pool = ThreadPool::global());
+
+    void setConfig(const SensitivityVarConfig& cfg) { config = cfg; }
+    const SensitivityVarConfig& getConfig() const { return config; }
+
+    // Scenario moves as the factor-move matrix; sensitivities are recomputed on next run
+    void setScenarios(const std::vector<HistoricalScenario>& scenarios);
+    // Re-bump against the base market, e.g. after an intraday market update
+    void computeSensitivities();
+
+    // Approximate P&L for every scenario, full revaluation for promoted trades, then the
+    // periodic check
+    const PnlCube& run();
+    const PnlCube& getCube() const { return cube; }
+
+    // Fully revalue `sampleSize` approximated trades and promote those out of tolerance
+    size_t check(size_t sampleSize);
+    void promote(size_t tradeIndex);
+    bool isPromoted(size_t tradeIndex) const { return fullReval[tradeIndex] != 0; }
+    // Relative RMS error of each trade at its last check
+    const std::map<size_t, double>& getCheckErrors() const { return checkErrors; }
+
+    VarResult portfolioVaR(double confidence) const;
+    std::map<std::string, VarResult> varBy(AggregateBy level, double confidence) const;
+    const SensitivityVarStats& getStats() const { return stats; }
+
+    // Bumps and full revaluations of trades the proxy covers are priced from it (null: none)
+    void setProxy(ChebyshevProxy* proxy) { revaluer.setProxy(proxy); }
+
+private:
+    struct RiskFactor {
+        FactorKind kind;
+        std::string name;
+        std::string tenor;   // Empty: parallel (curves, vols) or spot
+    };
+    struct Sensitivity {
+        size_t factor;
+        double first;        // dPV per unit move (relative move for spots)
+        double second;       // d2PV per unit move squared; spots only
+    };
+
+    Market bumpedMarket(const RiskFactor& f, double bump) const;
+    std::vector<double> fullPnl(const std::vector<size_t>& tradeIdx) const;   // [s * n + k]
+
+    const Market& baseMarket;
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    ThreadPool& pool;
+    HistoricalVarEngine revaluer;
+    SensitivityVarConfig config;
+
+    std::vector<HistoricalScenario> scenarios;
+    std::vector<RiskFactor> factors;
+    std::vector<double> moves;                        // [s * nFactors + j]
+    std::vector<std::vector<Sensitivity>> sens;       // Per trade, sparse
+    std::vector<double> basePv;
+    std::vector<char> fullReval;
+    bool sensitivitiesValid = false;
+
+    PnlCube cube;
+    SensitivityVarStats stats;
+    std::map<size_t, double> checkErrors;
+    size_t runCount = 0;
+    size_t checkCursor = 0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ===========================
+// SobolSequence Class
+// ===========================
+// Sobol low-discrepancy sequence in base 2 with 32-bit resolution. Direction numbers for
+// the first kMaxDimensions dimensions (Joe & Kuo, new-joe-kuo-6.21201: every primitive
+// polynomial up to degree 8) are compiled in. Points are produced in Gray-code order, so
+// a block starting at any index costs one direct evaluation plus one XOR per point and
+// dimension, and blocks can be generated independently by different threads.
+class SobolSequence {
+public:
+    static constexpr size_t kMaxDimensions = 53;
+    static constexpr int kBits = 32;
+
+    explicit SobolSequence(size_t dimensions);
+
+    size_t dimensions() const { return dims; }
+
+    // Raw integer coordinates of point `index`; out has dimensions() entries
+    void point(uint64_t index, uint32_t* out) const;
+
+    // `count` consecutive points starting at `first`, XORed with `shift` (one word per
+    // dimension, may be null) and mapped to (0, 1). Layout is dimension-major:
+    // u[d * count + i] is coordinate d of point first + i.
+    void uniforms(uint64_t first, size_t count, const uint32_t* shift, double* u) const;
+
+private:
+    size_t dims;
+    std::vector<uint32_t> direction;   // dims x kBits, direction[d * kBits + bit]
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+#include "discount_table.h"
+#include "historical_var.h"
+#include "portfolio_valuer.h"
+#include "thread_pool.h"
+#include "exotic_batch_pricer.h"
+
+// ===========================
+// Stress Scenario Language
+// ===========================
+// One file row per move, "scenario;move;target;value1;value2", grouped by scenario name in
+// order of first appearance. Targets name a curve, vol or underlying; "*" means every one of
+// that kind in the market. Rate and absolute vol sizes are in absolute units (0.02 = 200bp);
+// spot and relative vol sizes are fractions (-0.3 = down 30%). Curve pillar times t are
+// years from the curve's first pillar.
+//   parallel;CURVE;size            every pillar moves by size
+//   short;CURVE;size               size * exp(-t / 4)        (IRRBB short-rate shape)
+//   long;CURVE;size                size * (1 - exp(-t / 4))  (IRRBB long-rate shape)
+//   twist;CURVE;shortSize;longSize linear in t from the first pillar to the last
+//   keyrate;CURVE;tenor;size       one pillar, e.g. 5Y
+//   vol_abs;VOL;size               vol curves, swaption cubes and vol surfaces of that name
+//   vol_rel;VOL;size               every quote times (1 + size)
+//   spot;UNDERLYING;size           relative spot move
+//   include;SCENARIO               all moves of another scenario (composites)
+enum class StressMoveType {
+    CurveParallel,
+    CurveShort,
+    CurveLong,
+    CurveTwist,
+    CurveKeyRate,
+    VolAbsolute,
+    VolRelative,
+    Spot
+};
+
+struct StressMove {
+    StressMoveType type = StressMoveType::CurveParallel;
+    std::string target;    // Upper-cased name, or "*"
+    std::string tenor;     // Key-rate pillar only
+    double size = 0.0;
+    double size2 = 0.0;    // Long end of a twist
+};
+
+struct StressScenario {
+    std::string name;
+    std::vector<StressMove> moves;   // Includes already expanded, applied in order
+
+    // Overlay on the base market; every moved curve, vol or surface is cloned once however
+    // many moves touch it, everything else stays shared with the base
+    Market apply(const Market& base) const;
+    // Factors apply() moves in this base market
+    std::vector<MarketFactor> movedFactors(const Market& base) const;
+};
+
+// Includes are resolved after the whole file is read, so they may refer forward
+std::vector<StressScenario> loadStressScenarios(const std::string& filename);
+
+// ===========================
+// StressTestEngine Class
+// ===========================
+// Runs a set of stress scenarios across the portfolio. Base PVs are computed once and shared
+// by every scenario; each scenario compiles into one market overlay and one discount table
+// evaluation, and only trades whose declared dependencies it moves are repriced (the rest
+// keep zero P&L). Scenarios run in parallel, trades in chunks within a scenario; P&L lands
+// in a trade-by-scenario cube.
+class StressTestEngine {
+public:
+    StressTestEngine(const Market& base,
+        const std::vector<std::shared_ptr<Trade>>& portfolio,
+        std::shared_ptr<const DiscountTable> table = nullptr,   // Built from the portfolio if null
+        ThreadPool& pool = ThreadPool::global());
+
+    void setScenarios(std::vector<StressScenario> scenarios);
+    void loadScenarios(const std::string& filename);
+    const std::vector<StressScenario>& getScenarios() const { return scenarios; }
+
+    // Revalue the affected trades under every scenario and fill the P&L cube
+    const PnlCube& run();
+    const PnlCube& getCube() const { return cube; }
+    const std::vector<double>& getBasePv() const { return basePv; }
+
+    std::vector<double> portfolioPnl() const { return cube.portfolioPnl(); }
+    std::map<std::string, std::vector<double>> pnlBy(AggregateBy level) const;
+
+    size_t revaluations() const { return revalCount; }   // Trade revaluations in the last run
+
+    // Trades the proxy covers are priced from it instead of the tree pricer (null: none)
+    void setProxy(ChebyshevProxy* p) { proxy = p; }
+
+private:
+    const Market& baseMarket;
+    const std::vector<std::shared_ptr<Trade>>& trades;
+    ThreadPool& pool;
+
+    std::shared_ptr<const DiscountTable> dfTable;
+    std::vector<StressScenario> scenarios;
+    std::vector<double> basePv;
+    PnlCube cube;
+    ChebyshevProxy* proxy = nullptr;
+    ExoticBatchPricer exoticPricer;     // Asians and barriers: one batch per market
+    size_t revalCount = 0;
+    size_t tradeChunk = 256;
+};
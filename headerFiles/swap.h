@@ -27,6 +27,8 @@ public:
     const std::string& getType() const override;
     const std::string& getUnderlying() const override;
     const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    uint64_t fingerprint() const override;
     const Date& getTradeDate() const override;
     const Date& getExpiry() const override;
     double getNotional() const override;
@@ -37,8 +39,26 @@ public:
     // === Factory/Risk Copy Support ===
     std::shared_ptr<Trade> clone() const override;
 
-    // === Internal Helpers ===
+    // === Discount Table Valuation ===
+    bool usesDiscountTable() const override { return true; }
+    void registerDates(DiscountTable& table) const override;
+    void bindDiscountTable(const DiscountTable& table) override;
+    double pvFromTable(const std::vector<double>& dfs, const Market& mkt) const override;
+
+    // === Forward Swap Measures (notional-scaled annuity, par rate of the fixed leg) ===
     double getAnnuity(const Market& mkt) const;
+    double getForwardRate(const Market& mkt) const;
+    double getAnnuityFromTable(const std::vector<double>& dfs, const Date& asOf) const;
+    double getForwardRateFromTable(const std::vector<double>& dfs, const Date& asOf) const;
+    double getForwardRateFromTable(const std::vector<double>& dfs, const Date& asOf, double annuity) const;
+
+    // === Schedule Access ===
+    const Date& getStartDate() const { return startDate; }
+    double getFrequency() const { return frequency; }
+    const std::vector<Date>& getSchedule() const { return swapSchedule; }
+    double getAccrual(size_t i) const;   // ACT/360 fraction of the period ending at schedule[i]
+
+    // === Internal Helpers ===
     void generateSchedule();
 
 private:
@@ -51,5 +71,8 @@ private:
     std::string rateCurve;
 
     std::vector<Date> swapSchedule;
+    std::vector<double> accruals;     // Year fraction per period, aligned with swapSchedule
+    std::vector<size_t> dfSlots;      // DiscountTable slot per schedule date
+    size_t maturitySlot = 0;
     bool isLong_ = true;
 };
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+#include "thread_pool.h"
+#include "discount_table.h"
+#include "swaption_trade.h"
+#include "swaption_pricer.h"
+
+// ===========================
+// SwaptionBatchPricer Class
+// ===========================
+// Values many swaptions from one evaluation of their discount factors. Construction lays
+// out every fixed-leg coupon of every swaption in flat arrays (DF slot, accrual, payment
+// date) over a private DiscountTable, so the trades' own portfolio bindings are untouched.
+// Each call evaluates each distinct (curve, date) once, then sweeps the coupon arrays to
+// get all annuities and forwards, and finishes with the closed form and analytic vega,
+// so vega costs no more than the PV itself. Dates are reduced to serial numbers up front;
+// the per-call sweep does no calendar arithmetic.
+class SwaptionBatchPricer {
+public:
+    // Non-swaption trades are ignored
+    explicit SwaptionBatchPricer(const std::vector<std::shared_ptr<Trade>>& trades,
+        ThreadPool& pool = ThreadPool::global());
+
+    // Quotes in the order the swaptions appeared in the constructor input
+    std::vector<SwaptionQuote> price(const Market& mkt) const;
+
+    // Same, from discount factors already evaluated on getDiscountTable() (e.g. a shocked curve)
+    std::vector<SwaptionQuote> price(const Market& mkt, const std::vector<double>& dfs) const;
+
+    size_t size() const { return swaptions.size(); }
+    const std::vector<std::shared_ptr<const Swaption>>& getSwaptions() const { return swaptions; }
+    const DiscountTable& getDiscountTable() const { return table; }
+
+    static constexpr size_t kChunk = 1024;   // Swaptions per pool task
+
+private:
+    std::vector<std::shared_ptr<const Swaption>> swaptions;
+    DiscountTable table;
+    ThreadPool& pool;
+
+    // Flattened fixed-leg coupons; swaption i owns [couponBegin[i], couponBegin[i + 1])
+    std::vector<size_t> couponBegin;
+    std::vector<size_t> couponSlot;
+    std::vector<double> couponAccrual;
+    std::vector<long> couponSerial;
+
+    std::vector<size_t> startSlot;
+    std::vector<size_t> endSlot;
+    std::vector<long> startSerial;
+    std::vector<long> expirySerial;
+    std::vector<double> tenor;
+    std::vector<double> notional;
+
+    // Distinct vol cubes, resolved once per call
+    std::vector<std::string> cubeNames;
+    std::vector<size_t> cubeIndex;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <memory>
+
+#include "pricer.h"
+#include "market.h"
+#include "types.h"
+#include "swaption_trade.h"
+#include "swaption_vol_cube.h"
+
+// ===========================
+// SwaptionQuote Structure
+// ===========================
+// Annuity-measure breakdown of one swaption. annuity is notional-scaled; pv and vega are
+// signed by the position, vega per unit of the cube's vol (normal or lognormal).
+struct SwaptionQuote {
+    double forward = 0.0;
+    double annuity = 0.0;
+    double vol = 0.0;
+    double pv = 0.0;
+    double vega = 0.0;
+};
+
+// ===========================
+// SwaptionPricer Class
+// ===========================
+// Black (lognormal) or Bachelier (normal) on the forward par swap rate, times the swap
+// annuity. The model follows the quote type of the swaption's vol cube. Lognormal quotes
+// need a positive forward and strike; otherwise the option is worth its intrinsic value.
+class SwaptionPricer : public Pricer {
+public:
+    double price(const Market& mkt, std::shared_ptr<Trade> trade) const override;
+
+    // Full quote from an annuity and forward the caller has already computed
+    static SwaptionQuote quote(const Swaption& trade, const SwaptionVolCube& cube, const Date& asOf,
+        double annuity, double forward);
+
+    // Same, with the option expiry and swap tenor already in years (no date arithmetic)
+    static SwaptionQuote quote(const Swaption& trade, const SwaptionVolCube& cube, double expiry,
+        double tenor, double annuity, double forward);
+
+    // Undiscounted unit-annuity option value and its derivative with respect to vol
+    static double blackUnit(OptionType optType, double F, double K, double vol, double T);
+    static double blackVega(double F, double K, double vol, double T);
+    static double bachelierUnit(OptionType optType, double F, double K, double vol, double T);
+    static double bachelierVega(double F, double K, double vol, double T);
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "trade.h"
+#include "types.h"
+#include "date.h"
+#include "swap.h"
+#include <string>
+#include <vector>
+
+// ===========================
+// Swaption Class
+// ===========================
+// European option to enter the fixed-for-floating swap that starts on the expiry date.
+// A call is a payer swaption (pay fixed at the strike), a put a receiver swaption.
+// Physically settled and valued under the annuity measure: the underlying Swap supplies
+// the annuity and forward par rate, the vol cube the Black or Bachelier volatility.
+class Swaption : public Trade {
+public:
+    Swaption(OptionType optType,
+        double notional,
+        double strike,
+        const Date& tradeDate,
+        const Date& expiryDate,
+        const Date& swapEndDate,
+        double frequency,
+        const std::string& rateCurve,
+        bool isLong = true,
+        const std::string& volCube = "");   // Defaults to <CCY>-SWPN for the curve's currency
+
+    std::shared_ptr<Trade> clone() const override;
+
+    // Trade overrides
+    const std::string& getType() const override;
+    const std::string& getUnderlying() const override;
+    double getNotional() const override;
+    double payoff(double swapRate) const override;        // Intrinsic on the annuity, per unit annuity
+    double payoff(const Market& market) const override;
+    double valueAtNode(double S, double t, double continuation) const override;
+    double price(const Market& mkt) const override;
+    double pv(const Market& mkt) const override;
+    uint64_t fingerprint() const override;
+
+    const Date& getExpiry() const override;
+    const Date& getTradeDate() const override;
+    const std::string& getRateCurve() const override;
+    std::vector<MarketFactor> getMarketDependencies() const override;
+    OptionType getOptionType() const override;
+    double getStrike() const override;
+
+    // Discount table valuation: annuity and forward gathered from the shared layout
+    bool usesDiscountTable() const override { return true; }
+    void registerDates(DiscountTable& table) const override;
+    void bindDiscountTable(const DiscountTable& table) override;
+    double pvFromTable(const std::vector<double>& dfs, const Market& mkt) const override;
+
+    // Swaption terms
+    bool isPayer() const { return optType == OptionType::Call; }
+    const Swap& getSwap() const { return swap; }
+    const Date& getSwapEnd() const { return swapEnd; }
+    const std::string& getVolCube() const { return volCube; }
+    double getSwapTenor() const;                          // Years from expiry to swap end
+
+private:
+    OptionType optType;
+    double strike;
+    Date expiryDate;
+    Date swapEnd;
+    std::string volCube;
+    Swap swap;      // Underlying swap at unit direction; the option carries the position sign
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// ===========================
+// SwaptionVolCube Class
+// ===========================
+// Swaption volatilities on an (option expiry, swap tenor, strike offset) grid. Expiries and
+// tenors are year fractions; strike offsets are absolute rate differences to the ATM forward
+// swap rate, shared by every smile. Quotes are either normal (Bachelier, absolute rate vol)
+// or lognormal (Black). Lookups interpolate linearly in all three axes and extrapolate flat.
+class SwaptionVolCube {
+public:
+    SwaptionVolCube();
+    SwaptionVolCube(const std::string& name, SwaptionVolType type);
+
+    // Strike offsets of every smile, e.g. { -0.01, -0.005, 0.0, 0.005, 0.01 }
+    void setStrikeOffsets(const std::vector<double>& offsets);
+
+    // Add or replace the smile of one (expiry, tenor) node; one vol per strike offset
+    void addSmile(double expiry, double tenor, const std::vector<double>& smileVols);
+
+    // Vol for a swaption with the given expiry and tenor struck at `strike` on `forward`
+    double getVol(double expiry, double tenor, double strike, double forward) const;
+
+    void shock(double delta);                 // Parallel shock of every quote
+    void scale(double factor);                // Relative shock: every quote times factor
+
+    const std::string& getName() const { return name; }
+    SwaptionVolType getType() const { return type; }
+    const std::vector<double>& getExpiries() const { return expiries; }
+    const std::vector<double>& getTenors() const { return tenors; }
+    const std::vector<double>& getStrikeOffsets() const { return offsets; }
+
+    void display() const;
+
+private:
+    std::string name;
+    SwaptionVolType type = SwaptionVolType::Normal;
+    std::vector<double> offsets;
+
+    // Nodes as loaded, and the dense expiry x tenor x offset grid rebuilt from them
+    std::map<std::pair<double, double>, std::vector<double>> smiles;
+    std::vector<double> expiries;
+    std::vector<double> tenors;
+    std::vector<double> grid;
+
+    void rebuildGrid();
+    double smileVol(size_t e, size_t t, size_t k, double w) const;
+};
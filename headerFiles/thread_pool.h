@@ -1,84 +1,185 @@
-// C++ Program to demonstrate thread pooling 
-
-#include <condition_variable> 
-#include <functional> 
-#include <iostream> 
-#include <mutex> 
-#include <queue> 
-#include <thread> 
-
-using namespace std; 
-
-// Class that represents a simple thread pool 
-class ThreadPool { 
-public: 
-	// Constructor to creates a thread pool with given number of threads 
-	ThreadPool(size_t num_threads= thread::hardware_concurrency()) { 
-		// Creating worker threads 
-		for (size_t i = 0; i < num_threads; ++i) { 
-			threads_.emplace_back([this] { 
-				while (true) { 
-					function<void()> task; 
-					// The reason for putting the below  here is to unlock the queue before executing the task so that other 
-					// threads can perform enqueue tasks 
-					{ 
-						// Locking the queue so that data can be shared safely 
-						unique_lock<mutex> lock(queue_mutex_); 
-						// Waiting until there is a task to execute or the pool is stopped 
-						cv_.wait(lock, [this] { 
-							return !tasks_.empty() || stop_; 
-						}); 
-						// exit the thread in case the pool is stopped and there are no tasks 
-						if (stop_ && tasks_.empty()) { 
-							return; 
-						} 
-						// Get the next task from the queue 
-						task = move(tasks_.front()); 
-						tasks_.pop(); 
-					} 
-					task(); 
-				} 
-			}); 
-		} 
-	} 
-
-	~ThreadPool() { 
-        { 
-            // Lock the queue to update the stop flag safely 
-            unique_lock<mutex> lock(queue_mutex_); 
-            stop_ = true; 
-        } 
-  
-        // Notify all threads 
-        cv_.notify_all(); 
-  
-        // Joining all worker threads to ensure they have completed their tasks 
-        for (auto& thread : threads_) { 
-            thread.join(); 
-        } 
-    } 
-  
-    // Enqueue task for execution by the thread pool 
-    void enqueue(function<void()> task)  { 
-        { 
-            unique_lock<std::mutex> lock(queue_mutex_); 
-            tasks_.push(std::move(task)); 
-        } 
-        cv_.notify_one(); 
-    } 
-  
-private: 
-    // Vector to store worker threads 
-    vector<thread> threads_;   
-    // Queue of tasks 
-    queue<function<void()> > tasks_;   
-    // Mutex to synchronize access to shared data 
-    mutex queue_mutex_;   
-    // Condition variable to signal changes in the state of the tasks queue 
-    condition_variable cv_; 
-  
-    // Flag to indicate whether the thread pool should stop or not 
-    bool stop_ = false; 
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ===========================
+// ThreadPool Class (work stealing)
+// ===========================
+// Each worker owns a deque: it pushes and pops its own tasks at the back (LIFO, cache warm)
+// while idle workers steal from the front of other deques (FIFO, oldest/largest work first).
+// Threads that block on a future or a parallel_for keep executing queued tasks while they
+// wait, so tasks may freely submit and wait on nested tasks without deadlocking the pool.
+// A waiter that finds nothing to run spins briefly, then parks until its work completes or
+// new tasks arrive, so a long task does not cost its waiter a core.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized to the hardware
+    static ThreadPool& global();
+
+    size_t size() const { return workers.size(); }
+
+    // === Task Submission ===
+    template <typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    // Block until the future is ready, running queued tasks in the meantime
+    template <typename T>
+    T wait(std::future<T>& fut);
+
+    // === Data Parallel Loops ===
+    // body(lo, hi) is called on contiguous chunks of at most `grain` indices
+    template <typename F>
+    void parallel_for_range(size_t begin, size_t end, size_t grain, F&& body);
+
+    // body(i) is called once per index; chunks of `grain` indices form one task
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F&& body);
+
+    // Grain that yields roughly `tasksPerWorker` chunks per worker
+    size_t defaultGrain(size_t count, size_t tasksPerWorker = 4) const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mtx;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void push(std::function<void()> task);
+    bool tryRunOne();                          // Pop own task or steal one; false if none found
+    void workerLoop(size_t index);
+
+    // Run queued tasks until done() holds, parking after kSpinRounds idle rounds
+    template <typename Done>
+    void helpUntil(Done&& done);
+    void notifyParked();                       // Called after anything a parked waiter may await
+
+    static constexpr int kSpinRounds = 64;
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCv;
+    std::condition_variable parkCv;            // Waiters with nothing left to steal
+    std::atomic<size_t> parked{ 0 };
+    std::atomic<size_t> pending{ 0 };
+    std::atomic<size_t> nextQueue{ 0 };        // Round robin target for external submitters
+    bool stop = false;
+
+    static thread_local ThreadPool* currentPool;
+    static thread_local size_t currentIndex;
 };
 
+// ===========================
+// Template Implementations
+// ===========================
+
+template <typename F, typename... Args>
+auto ThreadPool::submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+    using R = std::invoke_result_t<F, Args...>;
+    auto task = std::make_shared<std::packaged_task<R()>>(
+        std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+    std::future<R> fut = task->get_future();
+    push([this, task]() {
+        (*task)();
+        notifyParked();
+    });
+    return fut;
+}
+
+template <typename T>
+T ThreadPool::wait(std::future<T>& fut) {
+    helpUntil([&fut] { return fut.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+    return fut.get();
+}
+
+template <typename Done>
+void ThreadPool::helpUntil(Done&& done) {
+    int idle = 0;
+    while (!done()) {
+        if (tryRunOne()) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < kSpinRounds) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Pairs with the fence in notifyParked: either the notifier sees this waiter parked,
+        // or the predicate below sees the completion
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        parked.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        parkCv.wait(lock, [&] { return stop || pending.load(std::memory_order_acquire) > 0 || done(); });
+        parked.fetch_sub(1, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+template <typename F>
+void ThreadPool::parallel_for_range(size_t begin, size_t end, size_t grain, F&& body) {
+    if (end <= begin) return;
+    if (grain == 0) grain = defaultGrain(end - begin);
+
+    size_t nChunks = (end - begin + grain - 1) / grain;
+    if (nChunks == 1) {
+        body(begin, end);
+        return;
+    }
+
+    std::atomic<size_t> remaining{ nChunks };
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto runChunk = [&](size_t lo, size_t hi) {
+        try {
+            body(lo, hi);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+        ThreadPool* pool = this;   // The loop's frame may be gone once the count reaches zero
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            pool->notifyParked();
+    };
+
+    // Queue all but the first chunk, which the calling thread runs itself
+    for (size_t c = 1; c < nChunks; ++c) {
+        size_t lo = begin + c * grain;
+        size_t hi = std::min(end, lo + grain);
+        push([&runChunk, lo, hi]() { runChunk(lo, hi); });
+    }
+    runChunk(begin, std::min(end, begin + grain));
+
+    helpUntil([&remaining] { return remaining.load(std::memory_order_acquire) == 0; });
+
+    if (error) std::rethrow_exception(error);
+}
 
+template <typename F>
+void ThreadPool::parallel_for(size_t begin, size_t end, size_t grain, F&& body) {
+    parallel_for_range(begin, end, grain, [&body](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i)
+            body(i);
+    });
+}
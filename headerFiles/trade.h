@@ -2,10 +2,16 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
 #include "date.h"
+#include "helper.h"
 #include "Types.h"
+#include "market_factor.h"
 
 class Market;
+class DiscountTable;
 
 // Add enable_shared_from_this
 class Trade : public std::enable_shared_from_this<Trade> {
@@ -39,10 +45,49 @@ public:
     virtual const Date& getTradeDate() const = 0;
     virtual const Date& getExpiry() const = 0;
 
+    // === Booking Metadata ===
+    const std::string& getId() const { return tradeId; }
+    void setId(const std::string& id) { tradeId = id; }
+    const std::string& getBook() const { return book; }
+    void setBook(const std::string& name) { book = name; }
+    // Counterparty netting agreement; empty means the trade is netted on its own
+    const std::string& getNettingSet() const { return nettingSet; }
+    void setNettingSet(const std::string& name) { nettingSet = name; }
+
+    // === Economic Identity ===
+    // FNV-1a hash of the economic terms; changes whenever a trade is amended
+    virtual uint64_t fingerprint() const {
+        using util::hashMix;
+        uint64_t h = util::kHashSeed;
+        h = hashMix(hashMix(h, getType()), '|');
+        h = hashMix(hashMix(h, getUnderlying()), '|');
+        h = hashMix(hashMix(h, getRateCurve()), '|');
+        h = hashMix(h, getNotional());
+        h = hashMix(h, getStrike());
+        long serials[2] = { getTradeDate().getSerialDate(), getExpiry().getSerialDate() };
+        h = hashMix(h, serials);
+        int flags[2] = { static_cast<int>(getOptionType()), isLong() ? 1 : 0 };
+        return hashMix(h, flags);
+    }
+
+    // === Market Dependencies ===
+    // Market objects pv() and the risk bumps read; the valuer inverts these into an index so
+    // a market update reprices only dependent trades. The default wildcard reprices on every
+    // update, so a trade type that does not declare its inputs is never left stale.
+    virtual std::vector<MarketFactor> getMarketDependencies() const { return { MarketFactor() }; }
+
     // === Position Direction ===
     virtual bool isLong() const { return isLong_; }
     virtual void setLong(bool val) { isLong_ = val; }
 
+    // === Discount Table Support (rate trades only) ===
+    virtual bool usesDiscountTable() const { return false; }
+    virtual void registerDates(DiscountTable& /*table*/) const {}
+    virtual void bindDiscountTable(const DiscountTable& /*table*/) {}
+    virtual double pvFromTable(const std::vector<double>& /*dfs*/, const Market& /*mkt*/) const {
+        throw std::runtime_error("Discount table valuation not supported for " + getType());
+    }
+
     // === Cloning Support ===
     virtual std::shared_ptr<Trade> clone() const = 0;
 
@@ -50,4 +95,7 @@ protected:
     std::string tradeType;
     Date tradeDate;
     bool isLong_ = true; // default to long
+    std::string tradeId;
+    std::string book = "DEFAULT";
+    std::string nettingSet;
 };
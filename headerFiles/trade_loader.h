@@ -0,0 +1,16 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "trade.h"
+
+// ===========================
+// Trade Row Parsing
+// ===========================
+// One trade.txt row (id;type;trade_dt;start_dt;end_dt;notional;instrument;rate;strike;freq;
+// option;direction[;book[;netting_set]]) to a booked trade with id, direction, book and
+// netting set set. Shared by the batch loader and the pricing server, so a trade sent over
+// the wire is read exactly as the file would read it. Returns nullptr for an unknown type
+// and throws on a malformed row.
+std::shared_ptr<Trade> parseTradeRow(const std::string& line);
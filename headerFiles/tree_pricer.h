@@ -3,6 +3,7 @@
 #include <vector>
 #include <cmath>
 #include <memory>
+#include <functional>
 
 #include "pricer.h"
 #include "tree_product.h"
@@ -47,4 +48,26 @@ public:
 	explicit JRRNBinomialTreePricer(int N);
 
 	void modelSetup(double S0, double sigma, double rate, double dt) const override;
-};
\ No newline at end of file
+};
+
+// ===========================
+// Early-Exercise Lattice Pricer
+// ===========================
+// AmericanOption and AmerCallSpread on a CRR lattice with the Black-Scholes inputs (spot,
+// LOGVOL and the trade's curve at expiry); other trades fall back to their own pv. Holds no
+// mutable state, so one instance can be shared across threads.
+class EarlyExerciseLatticePricer : public Pricer {
+public:
+	explicit EarlyExerciseLatticePricer(int N);
+
+	double price(const Market& mkt, std::shared_ptr<Trade> trade) const override;
+
+	// Holder's time-0 value at spot S * ratio for every ratio, from one lattice widened so its
+	// first layer spans all of them; read off by quadratic interpolation in log spot. `exercise`
+	// is the holder's payoff, i.e. the long side's, whatever the trade's direction.
+	static std::vector<double> profile(const std::function<double(double)>& exercise,
+		double S, double T, double r, double sigma, int N, const std::vector<double>& ratios);
+
+private:
+	int nTimeSteps;
+};
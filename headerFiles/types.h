@@ -12,3 +12,32 @@ enum class OptionType
     None
 };
 
+
+// ===========================
+// AverageType Enumeration
+// ===========================
+enum class AverageType
+{
+    Arithmetic,
+    Geometric
+};
+
+// ===========================
+// BarrierType Enumeration
+// ===========================
+enum class BarrierType
+{
+    UpAndOut,
+    UpAndIn,
+    DownAndOut,
+    DownAndIn
+};
+
+// ===========================
+// SwaptionVolType Enumeration
+// ===========================
+enum class SwaptionVolType
+{
+    Normal,      // Bachelier, absolute rate vol
+    Lognormal    // Black, relative vol
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+
+// ===========================
+// ValuationKey
+// ===========================
+// What was valued (trade fingerprint), against which market content (Market::stateKey of the
+// trade's declared dependencies) and how (method tag: the same trade and market priced by
+// different methods must not share an entry).
+enum class ValuationMethod : uint32_t {
+    Pv,          // Trade::pv
+    TreePv       // CRR tree pricer
+};
+
+struct ValuationKey {
+    uint64_t trade = 0;
+    uint64_t market = 0;
+    ValuationMethod method = ValuationMethod::Pv;
+
+    bool operator==(const ValuationKey& o) const {
+        return trade == o.trade && market == o.market && method == o.method;
+    }
+
+    static ValuationKey of(const Trade& trade, const Market& mkt, ValuationMethod method) {
+        return { trade.fingerprint(), mkt.stateKey(trade.getMarketDependencies()), method };
+    }
+};
+
+struct ValuationKeyHash {
+    size_t operator()(const ValuationKey& k) const {
+        uint64_t h = k.trade * 0x9E3779B97F4A7C15ULL;
+        h ^= k.market + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2);
+        h ^= static_cast<uint64_t>(k.method) + (h << 6) + (h >> 2);
+        return static_cast<size_t>(h);
+    }
+};
+
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t entries = 0;
+
+    double hitRate() const { return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses); }
+};
+
+// ===========================
+// ValuationCache Class
+// ===========================
+// Memoized valuations keyed by ValuationKey. Market versions make keys content-exact: a bump,
+// tick or reload stamps new versions on the moved factors only, so trades that do not read
+// them keep hitting (a vol bump never evicts a swap's PV; a USD curve bump never touches SGD
+// trades). Greeks are rebuilt from cached bumped-market PVs, so an unchanged trade re-run
+// costs lookups only.
+//
+// Memory is bounded: entries are split over independently locked shards, each an LRU list
+// holding at most capacity / shards entries. Safe to share across pool workers; a value is
+// computed outside the lock, so two threads missing the same key may both compute it.
+class ValuationCache {
+public:
+    explicit ValuationCache(size_t capacity = 1 << 16, size_t shards = 16);
+
+    bool find(const ValuationKey& key, double& value);
+    void insert(const ValuationKey& key, double value);
+
+    // Cached value, or compute() stored under key
+    template <typename F>
+    double getOrCompute(const ValuationKey& key, F&& compute) {
+        double value;
+        if (find(key, value)) return value;
+        value = compute();
+        insert(key, value);
+        return value;
+    }
+
+    CacheStats stats() const;
+    void resetStats();
+    void clear();
+    size_t capacity() const { return shardCapacity * shards.size(); }
+
+    static ValuationCache& global();
+
+private:
+    struct Shard {
+        std::mutex mtx;
+        std::list<std::pair<ValuationKey, double>> lru;     // Most recently used first
+        std::unordered_map<ValuationKey, std::list<std::pair<ValuationKey, double>>::iterator, ValuationKeyHash> index;
+    };
+
+    Shard& shardOf(const ValuationKey& key);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    size_t shardCapacity;
+    std::atomic<uint64_t> hitCount{ 0 };
+    std::atomic<uint64_t> missCount{ 0 };
+    std::atomic<uint64_t> evictionCount{ 0 };
+};
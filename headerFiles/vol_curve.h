@@ -24,6 +24,7 @@ public:
 
     void shock(double delta);                // parallel shock all vols
     void shock(const Date& tenor, double delta);  // point shock
+    void scale(double factor);               // relative shock: every vol times factor
 
     // Load curve data from file relative to a valuation date (asOf)
     void loadFromFile(const std::string& filename, const Date& asOf);
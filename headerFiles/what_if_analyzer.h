@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "market.h"
+#include "trade.h"
+#include "historical_var.h"
+#include "rolling_var.h"
+#include "portfolio_valuer.h"
+#include "thread_pool.h"
+
+// ===========================
+// WhatIfResult
+// ===========================
+struct WhatIfResult {
+    TradeResult delta;                          // Change to PV, DV01, Vega and their buckets
+    AggregateResult before;                     // Booked portfolio
+    AggregateResult after;                      // Portfolio with the change applied
+    std::map<std::string, double> dv01Buckets;  // Portfolio buckets after the change
+    std::map<std::string, double> vegaBuckets;
+    std::vector<double> scenarioPnl;            // Change to the portfolio P&L, per VaR scenario
+    VarResult varBefore;
+    VarResult varAfter;
+    double varContribution = 0.0;               // Incremental VaR: varAfter.VaR - varBefore.VaR
+};
+
+// ===========================
+// WhatIfAnalyzer Class
+// ===========================
+// Pre-trade what-if against cached portfolio results. The booked portfolio's PV, risk
+// buckets and per-scenario VaR P&L are taken once from a PortfolioValuer and a VaR engine;
+// a query then prices only the candidate: base PV and bucketed risk through the valuer's
+// warm bumped markets, and one revaluation per VaR scenario against scenario markets built
+// once at attach time. Cancellations reuse the booked trade's stored results and reprice
+// nothing; an amendment is the cancellation of the old terms plus the new trade.
+//
+// Results stay valid until the valuer or the VaR engine moves; call refresh() / attach()
+// again after PortfolioValuer::update or a VaR roll.
+class WhatIfAnalyzer {
+public:
+    WhatIfAnalyzer(const PortfolioValuer& valuer, double confidence = 0.99, ThreadPool& pool = ThreadPool::global());
+
+    // Re-read booked PV and risk totals from the valuer
+    void refresh();
+
+    // Scenario P&L of the booked portfolio, scenarios in engine order
+    void attach(const HistoricalVarEngine& var);
+    void attach(const RollingVarEngine& var);
+
+    WhatIfResult addTrade(const std::shared_ptr<Trade>& candidate) const;
+    WhatIfResult amendTrade(const std::string& tradeId, const std::shared_ptr<Trade>& amended) const;
+    WhatIfResult cancelTrade(const std::string& tradeId) const;
+
+    size_t scenarioCount() const { return scenarioMarkets.size(); }
+
+private:
+    void attachScenarios(const std::vector<HistoricalScenario>& scenarios, std::vector<double> pnl);
+    WhatIfResult evaluate(const std::shared_ptr<Trade>& added, long removed) const;
+    std::vector<double> scenarioPnlOf(const std::shared_ptr<Trade>& trade) const;   // Candidate P&L per scenario
+    long indexOf(const std::string& tradeId) const;
+
+    const PortfolioValuer& valuer;
+    double confidence;
+    ThreadPool& pool;
+
+    AggregateResult baseTotal;
+    std::map<std::string, double> baseDv01;
+    std::map<std::string, double> baseVega;
+
+    std::vector<std::unique_ptr<Market>> scenarioMarkets;   // Overlays on the valuer's market
+    std::vector<double> portfolioPnl;
+    std::function<std::vector<double>(size_t)> bookedPnl;   // Trade index -> P&L per scenario
+    VarResult baseVar;
+    size_t scenarioChunk = 32;
+};
@@ -112,6 +112,12 @@ std::shared_ptr<Trade> AmerCallSpread::clone() const {
     return std::make_shared<AmerCallSpread>(*this);
 }
 
+uint64_t AmerCallSpread::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    double terms[2] = { strike1, strike2 };
+    return util::hashMix(h, terms);
+}
+
 const std::string& AmerCallSpread::getType() const { return tradeType; }
 const std::string& AmerCallSpread::getUnderlying() const { return underlying; }
 double AmerCallSpread::getNotional() const { return notional; }
@@ -157,4 +163,13 @@ double AmerCallSpread::getStrike() const {
 
 OptionType AmerCallSpread::getOptionType() const {
     return OptionType::Call;
-}
\ No newline at end of file
+}
+
+// Spot, discount rate and LOGVOL (tree inputs)
+std::vector<MarketFactor> AmericanOption::getMarketDependencies() const {
+    return { { FactorKind::Spot, getUnderlying() }, { FactorKind::Curve, getRateCurve() }, { FactorKind::Vol, "LOGVOL" } };
+}
+
+std::vector<MarketFactor> AmerCallSpread::getMarketDependencies() const {
+    return { { FactorKind::Spot, getUnderlying() }, { FactorKind::Curve, getRateCurve() }, { FactorKind::Vol, "LOGVOL" } };
+}
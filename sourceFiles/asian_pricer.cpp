@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "asian_pricer.h"
+#include "payoff.h"
+#include "helper.h"
+
+namespace {
+
+    // Inputs shared by every trade on one fixing schedule
+    struct AsianInputs {
+        GbmParams gbm;
+        double T = 0.0;
+        double df = 1.0;
+        size_t nFixings = 0;
+        size_t pastFixings = 0;             // Fixed at spot (no fixing history in the market)
+        std::vector<double> futureTimes;    // Year fractions of the fixings still to come
+    };
+
+    AsianInputs asianInputs(const Market& mkt, const AsianOption& trade) {
+        AsianInputs in;
+        in.gbm.spot = mkt.getStockPrice(trade.getUnderlying());
+        in.gbm.vol = mkt.getVolCurve("LOGVOL")->getVol(trade.getExpiry());
+        in.gbm.rate = mkt.getCurve(trade.getRateCurve())->getRate(trade.getExpiry());
+        in.T = trade.getExpiry() - mkt.asOf;
+        in.df = std::exp(-in.gbm.rate * std::max(in.T, 0.0));
+
+        const auto& fixings = trade.getFixingDates();
+        in.nFixings = fixings.size();
+        for (const auto& d : fixings) {
+            double tau = d - mkt.asOf;
+            if (tau <= 0.0) ++in.pastFixings;
+            else in.futureTimes.push_back(tau);
+        }
+        return in;
+    }
+
+    // Unit-notional, unsigned discounted geometric Asian (lognormal average)
+    double geometricUnit(const AsianInputs& in, OptionType optType, double strike) {
+        const double n = static_cast<double>(in.nFixings);
+        const double sigma = in.gbm.vol;
+        const size_t m = in.futureTimes.size();
+
+        double sumT = 0.0, sumMin = 0.0;
+        for (size_t i = 0; i < m; ++i) {
+            sumT += in.futureTimes[i];
+            sumMin += in.futureTimes[i] * static_cast<double>(2 * (m - i) - 1);   // sum_ij min(t_i, t_j)
+        }
+        const double mu = std::log(in.gbm.spot) + (in.gbm.rate - 0.5 * sigma * sigma) * sumT / n;
+        const double var = sigma * sigma * sumMin / (n * n);
+
+        if (var <= 0.0 || strike <= 0.0)
+            return in.df * PAYOFF::VanillaOption(optType, strike, std::exp(mu + 0.5 * std::max(var, 0.0)));
+
+        const double sd = std::sqrt(var);
+        const double fwd = std::exp(mu + 0.5 * var);
+        const double d1 = (mu - std::log(strike) + var) / sd;
+        const double d2 = d1 - sd;
+        if (optType == OptionType::Call)
+            return in.df * (fwd * util::normCdf(d1) - strike * util::normCdf(d2));
+        return in.df * (strike * util::normCdf(-d2) - fwd * util::normCdf(-d1));
+    }
+
+    // Per-thread path buffers, reused across blocks, groups and calls
+    struct PathScratch {
+        std::vector<double> z, w, s, arith, geo;
+    };
+    thread_local PathScratch scratch;
+}
+
+// ===========================
+// Constructor
+// ===========================
+AsianPricer::AsianPricer(size_t paths, uint64_t rngSeed, ThreadPool& threadPool)
+    : nPaths(paths), seed(rngSeed), pool(threadPool) {
+    if (nPaths == 0)
+        throw std::invalid_argument("Asian pricer needs at least one path");
+}
+
+void AsianPricer::setReplicates(size_t count) {
+    if (count == 0)
+        throw std::invalid_argument("Asian pricer needs at least one replicate");
+    replicates = count;
+}
+
+// ===========================
+// Closed Form
+// ===========================
+double AsianPricer::geometricClosedForm(const Market& mkt, const AsianOption& trade) {
+    AsianInputs in = asianInputs(mkt, trade);
+    double sign = trade.isLong() ? 1.0 : -1.0;
+    return sign * trade.getNotional() * geometricUnit(in, trade.getOptionType(), trade.getStrike());
+}
+
+// ===========================
+// Pricing
+// ===========================
+double AsianPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    return priceWithError(mkt, trade).price;
+}
+
+McResult AsianPricer::priceWithError(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    auto asian = std::dynamic_pointer_cast<AsianOption>(trade);
+    if (!asian)
+        throw std::runtime_error("Asian pricer only supports AsianOption");
+    return priceGroup(mkt, { asian.get() })[0];
+}
+
+std::vector<McResult> AsianPricer::priceGroup(const Market& mkt, const std::vector<const AsianOption*>& group) const {
+    std::vector<McResult> results(group.size());
+    if (group.empty()) return results;
+
+    const AsianOption& lead = *group[0];
+    for (const AsianOption* t : group) {
+        if (t->getUnderlying() != lead.getUnderlying() || t->getRateCurve() != lead.getRateCurve() ||
+            t->getFixingDates() != lead.getFixingDates())
+            throw std::invalid_argument("Asian pricing group mixes underlyings or fixing schedules");
+    }
+
+    const AsianInputs in = asianInputs(mkt, lead);
+    const size_t m = in.futureTimes.size();
+    const double nFix = static_cast<double>(in.nFixings);
+
+    // Geometric trades are closed form; deterministic paths need no simulation either
+    std::vector<size_t> simulated;
+    for (size_t j = 0; j < group.size(); ++j) {
+        const AsianOption& t = *group[j];
+        const double scale = (t.isLong() ? 1.0 : -1.0) * t.getNotional();
+        if (m == 0 || in.gbm.vol <= 0.0) {
+            std::vector<double> fixings(in.pastFixings, in.gbm.spot);
+            for (double tau : in.futureTimes) fixings.push_back(in.gbm.spot * std::exp(in.gbm.rate * tau));
+            results[j].price = in.df * t.payoffOnFixings(fixings.data(), fixings.size());
+        }
+        else if (t.getAverageType() == AverageType::Geometric) {
+            results[j].price = scale * geometricUnit(in, t.getOptionType(), t.getStrike());
+        }
+        else {
+            simulated.push_back(j);
+        }
+    }
+    if (simulated.empty()) return results;
+
+    PathGenerator gen(in.futureTimes, sampling, seed);
+    const size_t nRep = sampling == Sampling::Sobol ? replicates : 1;
+    const size_t perRep = (nPaths + nRep - 1) / nRep;
+    size_t blockPaths = 2;
+    while (blockPaths < perRep && blockPaths < kBlockPaths) blockPaths <<= 1;
+    const size_t nBlocks = (perRep + blockPaths - 1) / blockPaths;
+    const size_t nTasks = nRep * nBlocks;
+    const size_t nSim = simulated.size();
+
+    const double pastLog = static_cast<double>(in.pastFixings) * std::log(in.gbm.spot);
+    const double pastSum = static_cast<double>(in.pastFixings) * in.gbm.spot;
+
+    std::vector<McMoments> moments(nTasks * nSim);
+    pool.parallel_for(0, nTasks, 1, [&](size_t task) {
+        PathScratch& buf = scratch;
+        buf.z.resize(m * blockPaths);
+        buf.w.resize(m * blockPaths);
+        buf.s.resize(m * blockPaths);
+        buf.arith.assign(blockPaths, pastSum);
+        buf.geo.assign(blockPaths, pastLog);
+
+        const uint32_t rep = static_cast<uint32_t>(task / nBlocks);
+        const uint64_t block = task % nBlocks;
+        gen.normals(block * blockPaths, blockPaths, rep, buf.z.data());
+        gen.brownian(buf.z.data(), blockPaths, buf.w.data());
+        gen.spots(in.gbm, buf.w.data(), blockPaths, 1.0, buf.s.data());
+
+        // Averages once per path, shared by every trade in the group
+        for (size_t k = 0; k < m; ++k) {
+            const double* sk = buf.s.data() + k * blockPaths;
+            for (size_t p = 0; p < blockPaths; ++p) {
+                buf.arith[p] += sk[p];
+                buf.geo[p] += std::log(sk[p]);
+            }
+        }
+        for (size_t p = 0; p < blockPaths; ++p) {
+            buf.arith[p] /= nFix;
+            buf.geo[p] = std::exp(buf.geo[p] / nFix);
+        }
+
+        for (size_t j = 0; j < nSim; ++j) {
+            const AsianOption& t = *group[simulated[j]];
+            const OptionType type = t.getOptionType();
+            const double K = t.getStrike();
+            McMoments& mm = moments[task * nSim + j];
+            for (size_t p = 0; p < blockPaths; ++p)
+                mm.add(in.df * PAYOFF::VanillaOption(type, K, buf.arith[p]),
+                    in.df * PAYOFF::VanillaOption(type, K, buf.geo[p]));
+        }
+    });
+
+    // Fixed-order reduction per trade and replicate
+    for (size_t j = 0; j < nSim; ++j) {
+        const AsianOption& t = *group[simulated[j]];
+        std::vector<McMoments> reps(nRep);
+        for (size_t task = 0; task < nTasks; ++task)
+            reps[task / nBlocks].add(moments[task * nSim + j]);
+
+        const double exact = geometricUnit(in, t.getOptionType(), t.getStrike());
+        McResult unit = combineReplicates(reps, controlVariate, exact);
+
+        const double scale = (t.isLong() ? 1.0 : -1.0) * t.getNotional();
+        McResult& res = results[simulated[j]];
+        res.price = scale * unit.price;
+        res.stdError = std::abs(scale) * unit.stdError;
+        res.paths = nTasks * blockPaths;
+    }
+    return results;
+}
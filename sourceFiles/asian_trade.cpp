@@ -0,0 +1,113 @@
+#include "asian_trade.h"
+#include "asian_pricer.h"
+#include "payoff.h"
+#include "market.h"
+#include "helper.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using util::to_upper;
+
+// === AsianOption ===
+
+AsianOption::AsianOption(OptionType _optType,
+    AverageType _avgType,
+    double _notional,
+    double _strike,
+    const Date& _tradeDate,
+    const Date& _startDate,
+    const Date& _expiryDate,
+    double _fixingFreq,
+    const std::string& _underlying,
+    bool _isLong)
+    : Trade("AsianOption", _tradeDate),
+    optType(_optType),
+    avgType(_avgType),
+    notional(_notional),
+    strike(_strike),
+    underlying(to_upper(_underlying)),
+    rateCurve("USD-SOFR"),
+    startDate(_startDate),
+    expiryDate(_expiryDate) {
+    if (_optType != OptionType::Call && _optType != OptionType::Put)
+        throw std::invalid_argument("Asian option must be a call or a put.");
+    if (_strike < 0)
+        throw std::invalid_argument("Strike must be non-negative.");
+    if (_expiryDate <= _startDate)
+        throw std::invalid_argument("Expiry must be after averaging start.");
+    if (_underlying.empty())
+        throw std::invalid_argument("Underlying cannot be empty.");
+    isLong_ = _isLong;
+    generateSchedule(_fixingFreq);
+}
+
+void AsianOption::generateSchedule(double fixingFreq) {
+    if (fixingFreq <= 0.0 || fixingFreq > 1.0)
+        throw std::invalid_argument("Asian fixing frequency must be in (0, 1] years.");
+
+    // Monthly granularity, counted from the start date so month ends do not drift
+    int months = std::max(1, static_cast<int>(std::lround(fixingFreq * 12.0)));
+    for (int k = 1;; ++k) {
+        Date d = util::dateAddTenor(startDate, std::to_string(k * months) + "M");
+        if (d >= expiryDate) break;
+        fixingDates.push_back(d);
+    }
+    fixingDates.push_back(expiryDate);
+}
+
+std::shared_ptr<Trade> AsianOption::clone() const {
+    return std::make_shared<AsianOption>(*this);
+}
+
+const std::string& AsianOption::getType() const { return tradeType; }
+const std::string& AsianOption::getUnderlying() const { return underlying; }
+double AsianOption::getNotional() const { return notional; }
+OptionType AsianOption::getOptionType() const { return optType; }
+double AsianOption::getStrike() const { return strike; }
+AverageType AsianOption::getAverageType() const { return avgType; }
+const Date& AsianOption::getStartDate() const { return startDate; }
+const std::vector<Date>& AsianOption::getFixingDates() const { return fixingDates; }
+
+double AsianOption::payoffOnFixings(const double* fixings, size_t n) const {
+    double raw = notional * PAYOFF::VanillaOption(optType, strike, PAYOFF::Average(avgType, fixings, n));
+    return isLong_ ? raw : -raw;
+}
+
+double AsianOption::payoff(double S) const {
+    double raw = notional * PAYOFF::VanillaOption(optType, strike, S);
+    return isLong_ ? raw : -raw;
+}
+
+double AsianOption::payoff(const Market& market) const {
+    return payoff(market.getStockPrice(underlying));
+}
+
+double AsianOption::valueAtNode(double, double, double continuation) const {
+    return continuation;
+}
+
+double AsianOption::price(const Market& mkt) const {
+    return pv(mkt);
+}
+
+double AsianOption::pv(const Market& mkt) const {
+    AsianPricer pricer;
+    return pricer.price(mkt, std::const_pointer_cast<Trade>(shared_from_this()));
+}
+
+uint64_t AsianOption::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    long terms[3] = { static_cast<long>(avgType), startDate.getSerialDate(), static_cast<long>(fixingDates.size()) };
+    return util::hashMix(h, terms);
+}
+
+const Date& AsianOption::getExpiry() const { return expiryDate; }
+const Date& AsianOption::getTradeDate() const { return tradeDate; }
+const std::string& AsianOption::getRateCurve() const { return rateCurve; }
+
+// GBM inputs of AsianPricer
+std::vector<MarketFactor> AsianOption::getMarketDependencies() const {
+    return { { FactorKind::Spot, getUnderlying() }, { FactorKind::Curve, getRateCurve() }, { FactorKind::Vol, "LOGVOL" } };
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#include "backtest_valuer.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+
+// ========================
+// PvMatrix
+// ========================
+PvMatrix::PvMatrix(size_t trades, size_t nDays)
+    : nTrades(trades), nDates(nDays), data(trades * nDays, 0.0) {
+}
+
+vector<double> PvMatrix::portfolioPv() const
+{
+    vector<double> pv(nDates);
+    for (size_t d = 0; d < nDates; ++d)
+        pv[d] = util::pairwiseSum(&data[d * nTrades], nTrades);
+    return pv;
+}
+
+// ========================
+// BacktestValuer
+// ========================
+BacktestValuer::BacktestValuer(const vector<shared_ptr<Trade>>& portfolio,
+    shared_ptr<const DiscountTable> table,
+    ThreadPool& threadPool)
+    : trades(portfolio), pool(threadPool), dfTable(move(table))
+{
+    if (!dfTable)
+        dfTable = DiscountTable::build(trades);
+
+    // Live trades on any date are a suffix of this order, found by one binary search
+    byExpiry.resize(trades.size());
+    iota(byExpiry.begin(), byExpiry.end(), 0);
+    vector<long> serial(trades.size());
+    for (size_t t = 0; t < trades.size(); ++t)
+        serial[t] = trades[t]->getExpiry().getSerialDate();
+    stable_sort(byExpiry.begin(), byExpiry.end(), [&](size_t a, size_t b) { return serial[a] < serial[b]; });
+    expirySerials.resize(trades.size());
+    for (size_t k = 0; k < byExpiry.size(); ++k)
+        expirySerials[k] = serial[byExpiry[k]];
+}
+
+const PvMatrix& BacktestValuer::run(const vector<shared_ptr<const Market>>& snapshots)
+{
+    const size_t nTrades = trades.size();
+    const size_t nDates = snapshots.size();
+
+    dates.clear();
+    dates.reserve(nDates);
+    for (const auto& mkt : snapshots) dates.push_back(mkt->asOf);
+
+    matrix = PvMatrix(nTrades, nDates);
+    atomic<size_t> valuations{ 0 };
+
+    pool.parallel_for(0, nDates, 1, [&](size_t d) {
+        const Market& mkt = *snapshots[d];
+        vector<double> dfs;
+        dfTable->evaluate(mkt, dfs);
+
+        // A trade settles on its expiry date; earlier expiries stay at zero
+        const size_t first = upper_bound(expirySerials.begin(), expirySerials.end(), mkt.asOf.getSerialDate())
+            - expirySerials.begin();
+        valuations += nTrades - first;
+
+        pool.parallel_for_range(first, nTrades, tradeChunk, [&](size_t lo, size_t hi) {
+            CRRBinomialTreePricer pricer(50);
+            for (size_t k = lo; k < hi; ++k) {
+                const size_t t = byExpiry[k];
+                const auto& trade = trades[t];
+                matrix.at(t, d) = trade->usesDiscountTable() ? trade->pvFromTable(dfs, mkt) : pricer.price(mkt, trade);
+            }
+        });
+    });
+
+    stats.dates = nDates;
+    stats.valuations = valuations;
+    stats.matured = nTrades * nDates - stats.valuations;
+    return matrix;
+}
+
+void BacktestValuer::writeCsv(const string& filename) const
+{
+    vector<string> output;
+    output.reserve(trades.size() + 1);
+
+    ostringstream header;
+    header << "trade_id";
+    for (const auto& d : dates) header << ";" << d;
+    output.push_back(header.str());
+
+    for (size_t t = 0; t < trades.size(); ++t) {
+        ostringstream os;
+        os << trades[t]->getId() << setprecision(17);
+        for (size_t d = 0; d < dates.size(); ++d)
+            os << ";" << matrix.at(t, d);
+        output.push_back(os.str());
+    }
+    util::outputToFile(filename, output);
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "barrier_pricer.h"
+#include "payoff.h"
+#include "helper.h"
+
+namespace {
+
+    // Unit-notional, unsigned Black-Scholes vanilla for in-out parity
+    double vanillaUnit(OptionType optType, double S, double K, double T, double r, double sigma) {
+        const double df = std::exp(-r * T);
+        if (T <= 0.0 || sigma <= 0.0 || K <= 0.0)
+            return df * PAYOFF::VanillaOption(optType, K, S * std::exp(r * std::max(T, 0.0)));
+        const double sd = sigma * std::sqrt(T);
+        const double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / sd;
+        const double d2 = d1 - sd;
+        if (optType == OptionType::Call)
+            return S * util::normCdf(d1) - K * df * util::normCdf(d2);
+        return K * df * util::normCdf(-d2) - S * util::normCdf(-d1);
+    }
+
+    // Pre-factored constant-coefficient tridiagonal system (Thomas algorithm)
+    struct Tridiagonal {
+        double lower = 0.0, upper = 0.0;
+        std::vector<double> cPrime, invDenom;
+
+        void factor(double lo, double diag, double up, size_t n) {
+            lower = lo; upper = up;
+            cPrime.resize(n);
+            invDenom.resize(n);
+            double prev = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                const double denom = diag - lo * prev;
+                invDenom[i] = 1.0 / denom;
+                cPrime[i] = up * invDenom[i];
+                prev = cPrime[i];
+            }
+        }
+
+        // Solves in place for `width` right-hand sides stored node-major: rhs[i * width + j]
+        void solve(double* rhs, size_t n, size_t width) const {
+            for (size_t j = 0; j < width; ++j) rhs[j] *= invDenom[0];
+            for (size_t i = 1; i < n; ++i) {
+                double* row = rhs + i * width;
+                const double* prev = row - width;
+                for (size_t j = 0; j < width; ++j)
+                    row[j] = (row[j] - lower * prev[j]) * invDenom[i];
+            }
+            for (size_t i = n - 1; i-- > 0;) {
+                double* row = rhs + i * width;
+                const double* next = row + width;
+                for (size_t j = 0; j < width; ++j)
+                    row[j] -= cPrime[i] * next[j];
+            }
+        }
+    };
+
+    // Per-thread grid buffers, reused across groups and calls
+    struct GridScratch {
+        std::vector<double> x, values, rhs;
+    };
+    thread_local GridScratch scratch;
+}
+
+// ===========================
+// Constructor
+// ===========================
+BarrierPricer::BarrierPricer(size_t spaceSteps, size_t timeSteps)
+    : nSpace(spaceSteps), nTime(timeSteps) {
+    if (nSpace < 4 || nTime < 2)
+        throw std::invalid_argument("Barrier pricer needs at least 4 space and 2 time steps");
+}
+
+// ===========================
+// Pricing
+// ===========================
+double BarrierPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    auto barrier = std::dynamic_pointer_cast<BarrierOption>(trade);
+    if (!barrier)
+        throw std::runtime_error("Barrier pricer only supports BarrierOption");
+    return priceGroup(mkt, { barrier.get() })[0];
+}
+
+std::vector<double> BarrierPricer::priceGroup(const Market& mkt, const std::vector<const BarrierOption*>& group) const {
+    std::vector<double> results(group.size(), 0.0);
+    if (group.empty()) return results;
+
+    const BarrierOption& lead = *group[0];
+    for (const BarrierOption* t : group) {
+        if (t->getUnderlying() != lead.getUnderlying() || t->getRateCurve() != lead.getRateCurve() ||
+            !(t->getExpiry() == lead.getExpiry()) || t->getBarrier() != lead.getBarrier() ||
+            t->isUpBarrier() != lead.isUpBarrier())
+            throw std::invalid_argument("Barrier pricing group mixes underlyings, expiries or barriers");
+    }
+
+    const double S0 = mkt.getStockPrice(lead.getUnderlying());
+    const double sigma = mkt.getVolCurve("LOGVOL")->getVol(lead.getExpiry());
+    const double r = mkt.getCurve(lead.getRateCurve())->getRate(lead.getExpiry());
+    const double T = lead.getExpiry() - mkt.asOf;
+    const double B = lead.getBarrier();
+    const bool up = lead.isUpBarrier();
+
+    const size_t width = group.size();
+    std::vector<double> vanilla(width), knockOut(width, 0.0), scale(width);
+    for (size_t j = 0; j < width; ++j) {
+        const BarrierOption& t = *group[j];
+        vanilla[j] = vanillaUnit(t.getOptionType(), S0, t.getStrike(), T, r, sigma);
+        scale[j] = (t.isLong() ? 1.0 : -1.0) * t.getNotional();
+    }
+
+    const bool touched = up ? S0 >= B : S0 <= B;
+    if (!touched && (T <= 0.0 || sigma <= 0.0)) {
+        knockOut = vanilla;   // No diffusion left to reach the barrier
+    }
+    else if (!touched) {
+        // Log-spot grid with the barrier at one end and the spot exactly on a node
+        const double xB = std::log(B), x0 = std::log(S0);
+        const double dist = std::abs(xB - x0);
+        const double span = dist + 5.0 * sigma * std::sqrt(T);
+        const size_t N = nSpace;
+        size_t m = static_cast<size_t>(std::lround(dist / span * static_cast<double>(N)));
+        m = std::min(std::max<size_t>(m, 1), N - 1);
+        const double dx = dist / static_cast<double>(m);
+
+        GridScratch& buf = scratch;
+        buf.x.resize(N + 1);
+        for (size_t i = 0; i <= N; ++i) {
+            // Up: x_N = barrier, spot at N - m. Down: x_0 = barrier, spot at m.
+            buf.x[i] = up ? xB - static_cast<double>(N - i) * dx : xB + static_cast<double>(i) * dx;
+        }
+        const size_t iSpot = up ? N - m : m;
+        const size_t iFar = up ? 0 : N;
+
+        // Terminal knock-out values, node-major; zero on the barrier
+        buf.values.assign((N + 1) * width, 0.0);
+        for (size_t i = 0; i <= N; ++i) {
+            if (i == (up ? N : 0)) continue;
+            const double S = std::exp(buf.x[i]);
+            for (size_t j = 0; j < width; ++j)
+                buf.values[i * width + j] = PAYOFF::VanillaOption(group[j]->getOptionType(), group[j]->getStrike(), S);
+        }
+
+        // L V_i = alpha V_{i-1} + beta V_i + gamma V_{i+1}
+        const double dt = T / static_cast<double>(nTime);
+        const double a = 0.5 * sigma * sigma, b = r - 0.5 * sigma * sigma;
+        const double alpha = a / (dx * dx) - b / (2.0 * dx);
+        const double beta = -2.0 * a / (dx * dx) - r;
+        const double gamma = a / (dx * dx) + b / (2.0 * dx);
+
+        const size_t nInner = N - 1;
+        Tridiagonal implicitSys, cnSys;
+        implicitSys.factor(-dt * alpha, 1.0 - dt * beta, -dt * gamma, nInner);
+        cnSys.factor(-0.5 * dt * alpha, 1.0 - 0.5 * dt * beta, -0.5 * dt * gamma, nInner);
+
+        buf.rhs.resize(nInner * width);
+        const double SFar = std::exp(buf.x[iFar]);
+        for (size_t n = 1; n <= nTime; ++n) {
+            const bool rannacher = n <= 2;
+            const double theta = rannacher ? 1.0 : 0.5;
+            const double tau = dt * static_cast<double>(n);
+            const double* V = buf.values.data();
+
+            // Explicit part of the theta scheme
+            const double e = (1.0 - theta) * dt;
+            for (size_t i = 1; i <= nInner; ++i) {
+                double* row = buf.rhs.data() + (i - 1) * width;
+                const double* vm = V + (i - 1) * width;
+                const double* v0 = V + i * width;
+                const double* vp = V + (i + 1) * width;
+                for (size_t j = 0; j < width; ++j)
+                    row[j] = v0[j] + e * (alpha * vm[j] + beta * v0[j] + gamma * vp[j]);
+            }
+
+            // New boundary values: zero at the barrier, discounted forward payoff far away
+            double* farRow = buf.values.data() + iFar * width;
+            for (size_t j = 0; j < width; ++j)
+                farRow[j] = std::exp(-r * tau) *
+                    PAYOFF::VanillaOption(group[j]->getOptionType(), group[j]->getStrike(), SFar * std::exp(r * tau));
+            if (up) {
+                double* first = buf.rhs.data();
+                for (size_t j = 0; j < width; ++j) first[j] += theta * dt * alpha * farRow[j];
+            }
+            else {
+                double* last = buf.rhs.data() + (nInner - 1) * width;
+                for (size_t j = 0; j < width; ++j) last[j] += theta * dt * gamma * farRow[j];
+            }
+
+            (rannacher ? implicitSys : cnSys).solve(buf.rhs.data(), nInner, width);
+            std::copy(buf.rhs.begin(), buf.rhs.end(), buf.values.begin() + width);
+        }
+
+        for (size_t j = 0; j < width; ++j)
+            knockOut[j] = buf.values[iSpot * width + j];
+    }
+
+    for (size_t j = 0; j < width; ++j) {
+        double unit = group[j]->isKnockIn() ? vanilla[j] - knockOut[j] : knockOut[j];
+        results[j] = scale[j] * unit;
+    }
+    return results;
+}
@@ -0,0 +1,96 @@
+#include "barrier_trade.h"
+#include "barrier_pricer.h"
+#include "payoff.h"
+#include "market.h"
+#include "helper.h"
+
+#include <stdexcept>
+
+using util::to_upper;
+
+// === BarrierOption ===
+
+BarrierOption::BarrierOption(OptionType _optType,
+    BarrierType _barrierType,
+    double _notional,
+    double _strike,
+    double _barrier,
+    const Date& _tradeDate,
+    const Date& _expiryDate,
+    const std::string& _underlying,
+    bool _isLong)
+    : Trade("BarrierOption", _tradeDate),
+    optType(_optType),
+    barrierType(_barrierType),
+    notional(_notional),
+    strike(_strike),
+    barrier(_barrier),
+    underlying(to_upper(_underlying)),
+    rateCurve("USD-SOFR"),
+    expiryDate(_expiryDate) {
+    if (_optType != OptionType::Call && _optType != OptionType::Put)
+        throw std::invalid_argument("Barrier option must be a call or a put.");
+    if (_strike < 0)
+        throw std::invalid_argument("Strike must be non-negative.");
+    if (_barrier <= 0)
+        throw std::invalid_argument("Barrier must be positive.");
+    if (_expiryDate <= _tradeDate)
+        throw std::invalid_argument("Expiry must be after trade date.");
+    if (_underlying.empty())
+        throw std::invalid_argument("Underlying cannot be empty.");
+    isLong_ = _isLong;
+}
+
+std::shared_ptr<Trade> BarrierOption::clone() const {
+    return std::make_shared<BarrierOption>(*this);
+}
+
+const std::string& BarrierOption::getType() const { return tradeType; }
+const std::string& BarrierOption::getUnderlying() const { return underlying; }
+double BarrierOption::getNotional() const { return notional; }
+OptionType BarrierOption::getOptionType() const { return optType; }
+double BarrierOption::getStrike() const { return strike; }
+BarrierType BarrierOption::getBarrierType() const { return barrierType; }
+double BarrierOption::getBarrier() const { return barrier; }
+bool BarrierOption::isKnockIn() const { return PAYOFF::IsKnockIn(barrierType); }
+
+bool BarrierOption::isUpBarrier() const {
+    return barrierType == BarrierType::UpAndOut || barrierType == BarrierType::UpAndIn;
+}
+
+double BarrierOption::payoff(double S) const {
+    double raw = notional * PAYOFF::VanillaOption(optType, strike, S);
+    return isLong_ ? raw : -raw;
+}
+
+double BarrierOption::payoff(const Market& market) const {
+    return payoff(market.getStockPrice(underlying));
+}
+
+double BarrierOption::valueAtNode(double, double, double continuation) const {
+    return continuation;
+}
+
+double BarrierOption::price(const Market& mkt) const {
+    return pv(mkt);
+}
+
+double BarrierOption::pv(const Market& mkt) const {
+    BarrierPricer pricer;
+    return pricer.price(mkt, std::const_pointer_cast<Trade>(shared_from_this()));
+}
+
+uint64_t BarrierOption::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    h = util::hashMix(h, barrier);
+    return util::hashMix(h, static_cast<int>(barrierType));
+}
+
+const Date& BarrierOption::getExpiry() const { return expiryDate; }
+const Date& BarrierOption::getTradeDate() const { return tradeDate; }
+const std::string& BarrierOption::getRateCurve() const { return rateCurve; }
+
+// GBM inputs of BarrierPricer
+std::vector<MarketFactor> BarrierOption::getMarketDependencies() const {
+    return { { FactorKind::Spot, getUnderlying() }, { FactorKind::Curve, getRateCurve() }, { FactorKind::Vol, "LOGVOL" } };
+}
@@ -0,0 +1,83 @@
+#include "bermudan_swaption_trade.h"
+#include "hull_white_pricer.h"
+#include "payoff.h"
+#include "market.h"
+#include "helper.h"
+
+#include <stdexcept>
+
+// === BermudanSwaption ===
+
+BermudanSwaption::BermudanSwaption(OptionType _optType,
+    double _notional,
+    double _strike,
+    const Date& _tradeDate,
+    const Date& _firstExercise,
+    const Date& _swapEndDate,
+    double _frequency,
+    const std::string& _rateCurve,
+    bool _isLong)
+    : Trade("BermudanSwaption", _tradeDate),
+    optType(_optType),
+    strike(_strike),
+    swap(_rateCurve, _firstExercise, _swapEndDate, _notional, _strike, _frequency) {
+    if (_optType != OptionType::Call && _optType != OptionType::Put)
+        throw std::invalid_argument("Bermudan swaption must be a call (payer) or a put (receiver).");
+    if (_firstExercise <= _tradeDate)
+        throw std::invalid_argument("First exercise must be after trade date.");
+    if (_swapEndDate <= _firstExercise)
+        throw std::invalid_argument("Swap end must be after the first exercise date.");
+    if (_rateCurve.empty())
+        throw std::invalid_argument("Rate curve cannot be empty.");
+
+    const auto& schedule = swap.getSchedule();
+    exerciseDates.assign(schedule.begin(), schedule.end() - 1);
+    isLong_ = _isLong;
+}
+
+std::shared_ptr<Trade> BermudanSwaption::clone() const {
+    return std::make_shared<BermudanSwaption>(*this);
+}
+
+const std::string& BermudanSwaption::getType() const { return tradeType; }
+const std::string& BermudanSwaption::getUnderlying() const { return swap.getUnderlying(); }
+double BermudanSwaption::getNotional() const { return swap.getNotional(); }
+OptionType BermudanSwaption::getOptionType() const { return optType; }
+double BermudanSwaption::getStrike() const { return strike; }
+
+double BermudanSwaption::payoff(double swapRate) const {
+    double raw = PAYOFF::VanillaOption(optType, strike, swapRate);
+    return isLong_ ? raw : -raw;
+}
+
+double BermudanSwaption::payoff(const Market& market) const {
+    return payoff(swap.getForwardRate(market)) * swap.getAnnuity(market);
+}
+
+double BermudanSwaption::valueAtNode(double, double, double continuation) const {
+    return continuation;   // Exercise is handled on the rate lattice
+}
+
+double BermudanSwaption::price(const Market& mkt) const {
+    return pv(mkt);
+}
+
+double BermudanSwaption::pv(const Market& mkt) const {
+    return HullWhitePricer::global().price(mkt, std::const_pointer_cast<Trade>(shared_from_this()));
+}
+
+uint64_t BermudanSwaption::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    long serials[2] = { getFirstExercise().getSerialDate(), getSwapEnd().getSerialDate() };
+    h = util::hashMix(h, serials);
+    return util::hashMix(h, swap.getFrequency());
+}
+
+const Date& BermudanSwaption::getExpiry() const { return exerciseDates.back(); }
+const Date& BermudanSwaption::getTradeDate() const { return tradeDate; }
+const std::string& BermudanSwaption::getRateCurve() const { return swap.getRateCurve(); }
+
+// Hull-White lattice fitted to the curve
+std::vector<MarketFactor> BermudanSwaption::getMarketDependencies() const {
+    return { { FactorKind::Curve, getRateCurve() } };
+}
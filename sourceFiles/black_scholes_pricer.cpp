@@ -1,5 +1,6 @@
 #include "black_scholes_pricer.h"
 #include "european_trade.h"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
@@ -7,6 +8,20 @@ inline double norm_cdf(double x) {
     return 0.5 * std::erfc(-x / std::sqrt(2.0));
 }
 
+double blackScholesPrice(OptionType type, double S, double K, double T, double r, double sigma) {
+    if (T <= 0.0 || sigma <= 0.0)
+        return type == OptionType::Call ? std::max(S - K, 0.0) : std::max(K - S, 0.0);
+
+    double sqrtT = std::sqrt(T);
+    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / (sigma * sqrtT);
+    double d2 = d1 - sigma * sqrtT;
+    double df = std::exp(-r * T);
+
+    if (type == OptionType::Call)
+        return S * norm_cdf(d1) - K * df * norm_cdf(d2);
+    return K * df * norm_cdf(-d2) - S * norm_cdf(-d1);
+}
+
 double BlackScholesPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
     // Cast to EuropeanOption only
     auto opt = std::dynamic_pointer_cast<EuropeanOption>(trade);
@@ -16,7 +31,7 @@ double BlackScholesPricer::price(const Market& mkt, std::shared_ptr<Trade> trade
     // Fetch input data
     double S = mkt.getStockPrice(opt->getUnderlying());
     double K = opt->getStrike();
-    double T = (opt->getExpiry() - mkt.asOf) / 365.0;
+    double T = opt->getExpiry() - mkt.asOf;  // Date difference is already an ACT/365 year fraction
     double sigma = mkt.getVolCurve("LOGVOL")->getVol(opt->getVolTenor());
     double r = mkt.getCurve(opt->getRateCurve())->getRate(opt->getExpiry());
 
@@ -24,17 +39,7 @@ double BlackScholesPricer::price(const Market& mkt, std::shared_ptr<Trade> trade
     if (T <= 0.0 || sigma <= 0.0)
         return opt->payoff(S);
 
-    // Compute Black-Scholes formula
-    double sqrtT = std::sqrt(T);
-    double d1 = (std::log(S / K) + (r + 0.5 * sigma * sigma) * T) / (sigma * sqrtT);
-    double d2 = d1 - sigma * sqrtT;
-    double df = std::exp(-r * T);
-
-    double bsPrice;
-    if (opt->getOptionType() == OptionType::Call)
-        bsPrice = S * norm_cdf(d1) - K * df * norm_cdf(d2);
-    else
-        bsPrice = K * df * norm_cdf(-d2) - S * norm_cdf(-d1);
+    double bsPrice = blackScholesPrice(opt->getOptionType(), S, K, T, r, sigma);
 
     // Apply sign and notional
     double sign = opt->isLong() ? 1.0 : -1.0;
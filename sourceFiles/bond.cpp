@@ -2,9 +2,12 @@
 #include "bond.h"
 #include "market.h"
 #include "helper.h"
+#include "discount_table.h"
+#include "hull_white_pricer.h"
 #include <stdexcept>
 #include <cmath>
 #include <iostream>
+#include <algorithm>
 
 using util::dateAddTenor;
 using util::to_upper;
@@ -65,6 +68,9 @@ double Bond::pv(const Market& mkt) const {
     if (bondSchedule.empty())
         const_cast<Bond*>(this)->generateSchedule();
 
+    if (isCallable())
+        return HullWhitePricer::global().price(mkt, std::const_pointer_cast<Trade>(shared_from_this()));
+
     double pv = 0.0;
     double coupon = notional * couponRate;
     auto rc = mkt.getCurve(rateCurve);
@@ -74,9 +80,8 @@ double Bond::pv(const Market& mkt) const {
         Date dt = bondSchedule[i];
         if (dt < valueDate) continue;
 
-        double tau = (bondSchedule[i] - bondSchedule[i - 1]) / 365.0; // ACT/365
         double df = rc->getDf(dt);
-        pv += coupon * tau * df;
+        pv += coupon * getAccrual(i) * df;
     }
 
     // Add discounted notional
@@ -86,6 +91,81 @@ double Bond::pv(const Market& mkt) const {
     return isLong_ ? pv : -pv;
 }
 
+// ===== Discount Table Valuation =====
+
+void Bond::registerDates(DiscountTable& table) const
+{
+    for (const auto& dt : bondSchedule)
+        table.addDate(rateCurve, dt);
+}
+
+void Bond::bindDiscountTable(const DiscountTable& table)
+{
+    accruals.assign(bondSchedule.size(), 0.0);
+    dfSlots.assign(bondSchedule.size(), 0);
+    for (size_t i = 0; i < bondSchedule.size(); ++i) {
+        dfSlots[i] = table.getSlot(rateCurve, bondSchedule[i]);
+        accruals[i] = getAccrual(i);
+    }
+    maturitySlot = table.getSlot(rateCurve, maturityDate);
+}
+
+double Bond::pvFromTable(const std::vector<double>& dfs, const Market& mkt) const
+{
+    const Date& asOf = mkt.asOf;
+    if (dfSlots.size() != bondSchedule.size())
+        throw std::runtime_error("Bond not bound to a DiscountTable.");
+
+    double pv = 0.0;
+    double coupon = notional * couponRate;
+    for (size_t i = 1; i < bondSchedule.size(); ++i) {
+        if (bondSchedule[i] < asOf) continue;
+        pv += coupon * accruals[i] * dfs[dfSlots[i]];
+    }
+
+    // Add discounted notional
+    pv += notional * dfs[maturitySlot];
+
+    return isLong_ ? pv : -pv;
+}
+
+double Bond::getAccrual(size_t i) const
+{
+    if (i == 0 || i >= bondSchedule.size())
+        return 0.0;
+    return bondSchedule[i] - bondSchedule[i - 1];  // ACT/365 year fraction
+}
+
+// ===== Issuer Call =====
+
+void Bond::setCallSchedule(const std::vector<Date>& dates, double price)
+{
+    if (price <= 0.0)
+        throw std::invalid_argument("Call price must be positive.");
+
+    callDates.clear();
+    for (const auto& dt : dates) {
+        if (dt < maturityDate && startDate < dt)
+            callDates.push_back(dt);
+        else
+            std::cerr << "[WARN] Ignoring call date outside the bond's life: " << dt << std::endl;
+    }
+    std::sort(callDates.begin(), callDates.end());
+    callDates.erase(std::unique(callDates.begin(), callDates.end()), callDates.end());
+    callPrice = price;
+    tradeType = isCallable() ? "CallableBond" : "Bond";
+}
+
+uint64_t Bond::fingerprint() const
+{
+    uint64_t h = Trade::fingerprint();
+    h = util::hashMix(h, frequency);
+    h = util::hashMix(h, callPrice);
+    for (const auto& dt : callDates)
+        h = util::hashMix(h, dt.getSerialDate());
+    return h;
+}
+
 double Bond::price(const Market& mkt) const {
     return pv(mkt);
 }
@@ -112,4 +192,9 @@ std::shared_ptr<Trade> Bond::clone() const {
 
 OptionType Bond::getOptionType() const {
     return OptionType::None;
-}
\ No newline at end of file
+}
+
+// Discount curve; the callable lattice is fitted to the same curve
+std::vector<MarketFactor> Bond::getMarketDependencies() const {
+    return { { FactorKind::Curve, rateCurve } };
+}
@@ -0,0 +1,81 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "brownian_bridge.h"
+
+// ===========================
+// Constructor
+// ===========================
+BrownianBridge::BrownianBridge(const std::vector<double>& times) {
+    const size_t n = times.size();
+    if (n == 0)
+        throw std::invalid_argument("Brownian bridge needs at least one time step");
+    for (size_t i = 0; i < n; ++i)
+        if (times[i] <= (i ? times[i - 1] : 0.0))
+            throw std::invalid_argument("Brownian bridge times must be positive and strictly increasing");
+
+    bridgeIndex.assign(n, 0);
+    leftIndex.assign(n, 0);
+    rightIndex.assign(n, 0);
+    leftWeight.assign(n, 0.0);
+    rightWeight.assign(n, 0.0);
+    stdDev.assign(n, 0.0);
+
+    // filled[k] marks time points already constructed
+    std::vector<char> filled(n, 0);
+    filled[n - 1] = 1;
+    bridgeIndex[0] = n - 1;
+    stdDev[0] = std::sqrt(times[n - 1]);
+
+    size_t j = 0;
+    for (size_t i = 1; i < n; ++i) {
+        // Next gap [j, k): j first unfilled point, k the filled point closing the gap
+        while (filled[j]) ++j;
+        size_t k = j;
+        while (!filled[k]) ++k;
+
+        const size_t l = j + ((k - 1 - j) >> 1);
+        filled[l] = 1;
+        bridgeIndex[i] = l;
+        leftIndex[i] = j;
+        rightIndex[i] = k;
+
+        const double tLeft = j ? times[j - 1] : 0.0;
+        const double span = times[k] - tLeft;
+        leftWeight[i] = (times[k] - times[l]) / span;
+        rightWeight[i] = (times[l] - tLeft) / span;
+        stdDev[i] = std::sqrt((times[l] - tLeft) * (times[k] - times[l]) / span);
+
+        j = k + 1;
+        if (j >= n) j = 0;
+    }
+}
+
+// ===========================
+// Path Construction
+// ===========================
+void BrownianBridge::build(const double* z, size_t count, double* w) const {
+    const size_t n = size();
+
+    double* last = w + (n - 1) * count;
+    for (size_t p = 0; p < count; ++p)
+        last[p] = stdDev[0] * z[p];
+
+    for (size_t i = 1; i < n; ++i) {
+        const double* zi = z + i * count;
+        const double* right = w + rightIndex[i] * count;
+        double* mid = w + bridgeIndex[i] * count;
+        const double wr = rightWeight[i], sd = stdDev[i];
+
+        if (leftIndex[i] == 0) {
+            for (size_t p = 0; p < count; ++p)
+                mid[p] = wr * right[p] + sd * zi[p];
+        }
+        else {
+            const double* left = w + (leftIndex[i] - 1) * count;
+            const double wl = leftWeight[i];
+            for (size_t p = 0; p < count; ++p)
+                mid[p] = wl * left[p] + wr * right[p] + sd * zi[p];
+        }
+    }
+}
@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+
+#include "chebyshev_proxy.h"
+
+using namespace std;
+
+namespace {
+    constexpr size_t kMaxNodes = 64;
+    const double kPi = acos(-1.0);
+
+    // In-place Chebyshev transform of node values along one axis of an n[0] x n[1] x n[2]
+    // tensor: c_m = (2 / len) * sum_k f_k * cos(pi * m * (k + 1/2) / len), c_0 halved
+    void transformAxis(double* f, const size_t n[3], size_t axis) {
+        const size_t len = n[axis];
+        if (len == 1) return;
+        const size_t stride = axis == 0 ? n[1] * n[2] : axis == 1 ? n[2] : 1;
+        const size_t total = n[0] * n[1] * n[2];
+
+        vector<double> cosTab(len * len), line(len);
+        for (size_t m = 0; m < len; ++m)
+            for (size_t k = 0; k < len; ++k)
+                cosTab[m * len + k] = cos(kPi * double(m) * (double(k) + 0.5) / double(len));
+
+        for (size_t start = 0; start < total; ++start) {
+            if ((start / stride) % len != 0) continue;   // Not the first element of a line
+            for (size_t k = 0; k < len; ++k) line[k] = f[start + k * stride];
+            for (size_t m = 0; m < len; ++m) {
+                double s = 0.0;
+                for (size_t k = 0; k < len; ++k) s += line[k] * cosTab[m * len + k];
+                f[start + m * stride] = s * (m == 0 ? 1.0 : 2.0) / double(len);
+            }
+        }
+    }
+}
+
+// ========================
+// Constructor
+// ========================
+ChebyshevProxy::ChebyshevProxy(shared_ptr<const Pricer> exactPricer, ProxyConfig cfg, ThreadPool& threadPool)
+    : exact(move(exactPricer)), config(cfg), pool(threadPool),
+    n{ max<size_t>(cfg.spotNodes, 1), max<size_t>(cfg.volNodes, 1), max<size_t>(cfg.rateNodes, 1) },
+    coeffCount(n[0] * n[1] * n[2])
+{
+    if (!exact)
+        throw invalid_argument("Chebyshev proxy needs an exact pricer");
+    if (n[0] > kMaxNodes || n[1] > kMaxNodes || n[2] > kMaxNodes)
+        throw invalid_argument("Chebyshev proxy: at most " + to_string(kMaxNodes) + " nodes per axis");
+    if (coeffCount > config.maxCoefficients)
+        throw invalid_argument("Chebyshev proxy: " + to_string(coeffCount) + " coefficients per trade exceeds the limit of "
+            + to_string(config.maxCoefficients));
+}
+
+// ========================
+// Box
+// ========================
+ChebyshevProxy::Point ChebyshevProxy::inputsOf(const Market& mkt, const Group& g) const
+{
+    return { { mkt.getStockPrice(g.underlying),
+        mkt.getVolCurve("LOGVOL")->getVol(g.expiry),
+        mkt.getCurve(g.rateCurve)->getRate(g.expiry) } };
+}
+
+ChebyshevProxy::Box ChebyshevProxy::boxAround(const Point& p) const
+{
+    const double spotWidth = min(config.spotWidth, 0.95);
+    Box box{ { p.x[0] * (1.0 - spotWidth), max(p.x[1] * (1.0 - config.volWidth), 1e-4), p.x[2] - config.rateWidth },
+        { p.x[0] * (1.0 + spotWidth), p.x[1] * (1.0 + config.volWidth), p.x[2] + config.rateWidth } };
+    for (size_t a = 0; a < 3; ++a)
+        if (n[a] == 1) box.lo[a] = box.hi[a] = p.x[a];   // Dropped axis: pinned to the fit market
+    return box;
+}
+
+bool ChebyshevProxy::inside(const Box& box, const Point& p) const
+{
+    for (size_t a = 0; a < 3; ++a) {
+        if (n[a] == 1) continue;
+        const double tol = 1e-12 * max(1.0, fabs(p.x[a]));
+        if (p.x[a] < box.lo[a] - tol || p.x[a] > box.hi[a] + tol) return false;
+    }
+    return true;
+}
+
+// ========================
+// Fitting
+// ========================
+ChebyshevProxy::Fit ChebyshevProxy::fitGroup(const Group& g, const Market& mkt, const Box& box, bool parallel) const
+{
+    const Point p0 = inputsOf(mkt, g);
+    const size_t nTrades = g.trades.size();
+
+    // Chebyshev nodes of the first kind per axis, mapped onto the box
+    vector<double> axis[3];
+    for (size_t a = 0; a < 3; ++a) {
+        const double mid = 0.5 * (box.lo[a] + box.hi[a]), half = 0.5 * (box.hi[a] - box.lo[a]);
+        axis[a].resize(n[a]);
+        for (size_t k = 0; k < n[a]; ++k)
+            axis[a][k] = n[a] == 1 ? p0.x[a] : mid + half * cos(kPi * (double(k) + 0.5) / double(n[a]));
+    }
+
+    // Parallel shifts hit the node vol and rate exactly at expiry; built once per level
+    vector<shared_ptr<VolCurve>> vols(n[1]);
+    for (size_t j = 0; j < n[1]; ++j) {
+        vols[j] = make_shared<VolCurve>(*mkt.getVolCurve("LOGVOL"));
+        vols[j]->shock(axis[1][j] - p0.x[1]);
+    }
+    vector<shared_ptr<RateCurve>> curves(n[2]);
+    for (size_t k = 0; k < n[2]; ++k) {
+        curves[k] = make_shared<RateCurve>(*mkt.getCurve(g.rateCurve));
+        curves[k]->shock(axis[2][k] - p0.x[2]);
+    }
+
+    Fit out;
+    out.coeffs.assign(nTrades * coeffCount, 0.0);
+    auto priceNode = [&](size_t node) {
+        const size_t i = node / (n[1] * n[2]), j = (node / n[2]) % n[1], k = node % n[2];
+        Market m = mkt.overlay();
+        m.addStockPrice(g.underlying, axis[0][i]);
+        m.addVolCurve("LOGVOL", vols[j]);
+        m.addCurve(g.rateCurve, curves[k]);
+        for (size_t t = 0; t < nTrades; ++t)
+            out.coeffs[t * coeffCount + node] = exact->price(m, g.trades[t]);
+    };
+    if (parallel) pool.parallel_for(0, coeffCount, 1, priceNode);
+    else for (size_t node = 0; node < coeffCount; ++node) priceNode(node);
+
+    out.errors.assign(nTrades, 0.0);
+    for (size_t t = 0; t < nTrades; ++t) {
+        double* c = &out.coeffs[t * coeffCount];
+        for (size_t a = 0; a < 3; ++a) transformAxis(c, n, a);
+
+        // Truncation estimate: magnitude of the top-order terms along every kept axis
+        for (size_t idx = 0; idx < coeffCount; ++idx) {
+            const size_t i = idx / (n[1] * n[2]), j = (idx / n[2]) % n[1], k = idx % n[2];
+            if ((n[0] > 1 && i == n[0] - 1) || (n[1] > 1 && j == n[1] - 1) || (n[2] > 1 && k == n[2] - 1))
+                out.errors[t] += fabs(c[idx]);
+        }
+    }
+
+    ++fitCount;
+    nodeCount += coeffCount * nTrades;
+    return out;
+}
+
+size_t ChebyshevProxy::fit(const Market& mkt, const vector<shared_ptr<Trade>>& trades)
+{
+    groups.clear();
+    groupIndex.clear();
+    slots.clear();
+
+    for (const auto& trade : trades) {
+        if (trade->getExpiry() <= mkt.asOf) continue;   // PV is the payoff: nothing to smooth
+        auto key = make_tuple(trade->getUnderlying(), trade->getExpiry().getSerialDate(), trade->getRateCurve());
+        auto it = groupIndex.find(key);
+        if (it == groupIndex.end()) {
+            auto g = make_unique<Group>();
+            g->underlying = trade->getUnderlying();
+            g->rateCurve = trade->getRateCurve();
+            g->expiry = trade->getExpiry();
+            try {
+                inputsOf(mkt, *g);
+            }
+            catch (const exception& e) {
+                cerr << "[WARN] No Chebyshev proxy for trade " << trade->getId() << ": " << e.what() << endl;
+                continue;
+            }
+            it = groupIndex.emplace(key, groups.size()).first;
+            groups.push_back(move(g));
+        }
+        Group& g = *groups[it->second];
+        slots[trade.get()] = { it->second, g.trades.size() };
+        g.trades.push_back(trade);
+    }
+
+    size_t fitted = 0;
+    for (auto& g : groups) {
+        g->asOf = mkt.asOf;
+        g->box = boxAround(inputsOf(mkt, *g));
+        Fit f = fitGroup(*g, mkt, g->box, true);
+        g->coeffs = move(f.coeffs);
+        g->errors = move(f.errors);
+        fitted += g->trades.size();
+    }
+    return fitted;
+}
+
+size_t ChebyshevProxy::fitEnvelope(const Market& base, size_t count, const function<Market(size_t)>& scenario)
+{
+    // Start from the current box on the same day, else from base's own
+    vector<Box> boxes(groups.size());
+    vector<char> grew(groups.size(), 0);
+    for (size_t i = 0; i < groups.size(); ++i) {
+        const Group& g = *groups[i];
+        grew[i] = !(g.asOf == base.asOf);
+        boxes[i] = grew[i] ? boxAround(inputsOf(base, g)) : g.box;
+    }
+    for (size_t s = 0; s < count; ++s) {
+        const Market mkt = scenario(s);
+        if (!(mkt.asOf == base.asOf)) continue;
+        for (size_t i = 0; i < groups.size(); ++i) {
+            const Point p = inputsOf(mkt, *groups[i]);
+            if (inside(boxes[i], p)) continue;
+            const Box around = boxAround(p);
+            for (size_t a = 0; a < 3; ++a) {
+                if (n[a] == 1) continue;
+                boxes[i].lo[a] = min(boxes[i].lo[a], around.lo[a]);
+                boxes[i].hi[a] = max(boxes[i].hi[a], around.hi[a]);
+            }
+            grew[i] = 1;
+        }
+    }
+
+    size_t refitted = 0;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (!grew[i]) continue;
+        Group& g = *groups[i];
+        Fit f = fitGroup(g, base, boxes[i], true);
+        unique_lock<shared_mutex> write(g.lock);
+        g.asOf = base.asOf;
+        g.box = boxes[i];
+        g.coeffs = move(f.coeffs);
+        g.errors = move(f.errors);
+        ++refitCount;
+        ++refitted;
+    }
+    return refitted;
+}
+
+// ========================
+// Evaluation
+// ========================
+double ChebyshevProxy::interpolate(const Group& g, size_t slot, const Point& p) const
+{
+    double T[3][kMaxNodes];
+    for (size_t a = 0; a < 3; ++a) {
+        const double mid = 0.5 * (g.box.lo[a] + g.box.hi[a]), half = 0.5 * (g.box.hi[a] - g.box.lo[a]);
+        const double x = half > 0.0 ? min(max((p.x[a] - mid) / half, -1.0), 1.0) : 0.0;
+        T[a][0] = 1.0;
+        if (n[a] > 1) T[a][1] = x;
+        for (size_t m = 2; m < n[a]; ++m) T[a][m] = 2.0 * x * T[a][m - 1] - T[a][m - 2];
+    }
+
+    const double* c = &g.coeffs[slot * coeffCount];
+    double pv = 0.0;
+    for (size_t i = 0; i < n[0]; ++i) {
+        double plane = 0.0;
+        for (size_t j = 0; j < n[1]; ++j) {
+            double line = 0.0;
+            for (size_t k = 0; k < n[2]; ++k) line += c[(i * n[1] + j) * n[2] + k] * T[2][k];
+            plane += line * T[1][j];
+        }
+        pv += plane * T[0][i];
+    }
+    return pv;
+}
+
+double ChebyshevProxy::price(const Market& mkt, const shared_ptr<Trade>& trade)
+{
+    auto it = slots.find(trade.get());
+    if (it == slots.end()) {
+        ++fallbackCount;
+        return exact->price(mkt, trade);
+    }
+    Group& g = *groups[it->second.first];
+    const size_t slot = it->second.second;
+    const Point p = inputsOf(mkt, g);
+
+    Box box = boxAround(p);
+    {
+        shared_lock<shared_mutex> read(g.lock);
+        if (g.asOf == mkt.asOf) {
+            if (inside(g.box, p)) {
+                ++evalCount;
+                return interpolate(g, slot, p);
+            }
+            for (size_t a = 0; a < 3; ++a) {
+                if (n[a] == 1) continue;
+                box.lo[a] = min(box.lo[a], g.box.lo[a]);
+                box.hi[a] = max(box.hi[a], g.box.hi[a]);
+            }
+        }
+    }
+    if (!config.autoRefit) {
+        ++fallbackCount;
+        return exact->price(mkt, trade);
+    }
+
+    // Fit serially and outside the lock, so no pool task ever waits on the group while holding
+    // it; if a racing refit already covers the point, that one is kept
+    Fit fresh = fitGroup(g, mkt, box, false);
+    unique_lock<shared_mutex> write(g.lock);
+    if (!(g.asOf == mkt.asOf && inside(g.box, p))) {
+        g.asOf = mkt.asOf;
+        g.box = box;
+        g.coeffs = move(fresh.coeffs);
+        g.errors = move(fresh.errors);
+        ++refitCount;
+    }
+    ++evalCount;
+    return interpolate(g, slot, p);
+}
+
+bool ChebyshevProxy::evaluate(const Trade& trade, const Date& asOf, double spot, double vol, double rate, double& pv) const
+{
+    auto it = slots.find(&trade);
+    if (it == slots.end()) return false;
+    const Group& g = *groups[it->second.first];
+    const Point p{ { spot, vol, rate } };
+
+    shared_lock<shared_mutex> read(g.lock);
+    if (!(g.asOf == asOf) || !inside(g.box, p)) return false;
+    pv = interpolate(g, it->second.second, p);
+    ++evalCount;
+    return true;
+}
+
+// ========================
+// Diagnostics
+// ========================
+double ChebyshevProxy::errorEstimate(const Trade& trade) const
+{
+    auto it = slots.find(&trade);
+    if (it == slots.end()) return 0.0;
+    const Group& g = *groups[it->second.first];
+    shared_lock<shared_mutex> read(g.lock);
+    return g.errors[it->second.second];
+}
+
+double ChebyshevProxy::maxErrorEstimate() const
+{
+    double worst = 0.0;
+    for (const auto& g : groups) {
+        shared_lock<shared_mutex> read(g->lock);
+        for (double e : g->errors) worst = max(worst, e);
+    }
+    return worst;
+}
+
+size_t ChebyshevProxy::memoryBytes() const
+{
+    size_t bytes = 0;
+    for (const auto& g : groups)
+        bytes += g->trades.size() * (coeffCount + 1) * sizeof(double);
+    return bytes;
+}
+
+ProxyStats ChebyshevProxy::getStats() const
+{
+    ProxyStats s;
+    s.groups = groups.size();
+    s.trades = slots.size();
+    s.fits = fitCount;
+    s.refits = refitCount;
+    s.nodePricings = nodeCount;
+    s.evaluations = evalCount;
+    s.fallbacks = fallbackCount;
+    return s;
+}
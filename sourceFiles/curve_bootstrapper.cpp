@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "curve_bootstrapper.h"
+#include "market.h"
+#include "swap.h"
+#include "helper.h"
+
+using namespace std;
+using util::dateAddTenor;
+
+namespace {
+    constexpr size_t kMaxNewton = 50;
+    constexpr double kNewtonTol = 1e-14;
+}
+
+// ===========================
+// CurveBootstrapper
+// ===========================
+CurveBootstrapper::CurveBootstrapper(const string& curveName, const Date& asOf, const vector<CurveQuote>& _quotes)
+    : name(util::to_upper(curveName)), valueDate(asOf), quotes(_quotes) {
+    if (quotes.empty())
+        throw invalid_argument("Curve " + name + ": no quotes to bootstrap.");
+
+    pillars.push_back(valueDate);
+    for (const auto& q : quotes) {
+        Date maturity = dateAddTenor(valueDate, q.tenor);
+        if (!(pillars.back() < maturity))
+            throw invalid_argument("Curve " + name + ": quote " + q.tenor +
+                " must mature after the valuation date and the previous quote.");
+        pillars.push_back(maturity);
+    }
+    zeros.assign(pillars.size(), 0.0);
+
+    // Interpolation weights of a cashflow date between its bracketing pillars, as RateCurve::getRate
+    auto makeNode = [&](const Date& d, double fixedCoef, double quoteCoef) {
+        Node n{ d - valueDate, 0, 0, 0.0, fixedCoef, quoteCoef };
+        const long s = d.getSerialDate();
+        size_t r = 0;
+        while (r < pillars.size() && pillars[r].getSerialDate() < s) ++r;
+        if (r == pillars.size()) {
+            n.left = n.right = pillars.size() - 1;     // Flat beyond the last pillar
+        }
+        else if (pillars[r].getSerialDate() == s || r == 0) {
+            n.left = n.right = r;
+        }
+        else {
+            const double x0 = static_cast<double>(pillars[r - 1].getSerialDate());
+            const double x1 = static_cast<double>(pillars[r].getSerialDate());
+            n.left = r - 1;
+            n.right = r;
+            n.w = (static_cast<double>(s) - x0) / (x1 - x0);
+        }
+        return n;
+    };
+
+    for (size_t k = 0; k < quotes.size(); ++k) {
+        const Date& maturity = pillars[k + 1];
+        Instrument inst;
+        if (quotes[k].type == CurveInstrument::Deposit) {
+            // (1 + q tau) P(T) - 1 = 0
+            const double tau = maturity.diffDays(valueDate) / 360.0;
+            inst.constant = -1.0;
+            inst.nodes.push_back(makeNode(maturity, 1.0, tau));
+        }
+        else {
+            // 1 - P(T_end) - q sum tau_i P(T_i) = 0, schedule and accruals from Swap
+            Swap swap(name, valueDate, maturity, 1.0, quotes[k].rate, quotes[k].frequency);
+            const auto& schedule = swap.getSchedule();
+            inst.constant = 1.0;
+            for (size_t i = 1; i < schedule.size(); ++i)
+                inst.nodes.push_back(makeNode(schedule[i], i + 1 == schedule.size() ? -1.0 : 0.0, -swap.getAccrual(i)));
+        }
+        instruments.push_back(move(inst));
+    }
+}
+
+double CurveBootstrapper::dZero(const Node& n, size_t quotePillar) const {
+    double d = 0.0;
+    if (n.left == quotePillar || (n.left == 0 && quotePillar == 1)) d += 1.0 - n.w;
+    if (n.right == quotePillar || (n.right == 0 && quotePillar == 1)) d += n.w;
+    return d;
+}
+
+double CurveBootstrapper::residual(size_t k, double* dfdz, double* dfdq) const {
+    const Instrument& inst = instruments[k];
+    const double q = quotes[k].rate;
+    double f = inst.constant, dz = 0.0, dq = 0.0;
+    for (const Node& n : inst.nodes) {
+        const double P = exp(-zeroAt(n) * n.T);
+        const double coef = n.fixedCoef + q * n.quoteCoef;
+        f += coef * P;
+        dz -= coef * n.T * P * dZero(n, k + 1);
+        dq += n.quoteCoef * P;
+    }
+    if (dfdz) *dfdz = dz;
+    if (dfdq) *dfdq = dq;
+    return f;
+}
+
+void CurveBootstrapper::solveFrom(size_t first) {
+    solvedCount = 0;
+    iterationCount = 0;
+    for (size_t k = first; k < quotes.size(); ++k) {
+        const size_t p = k + 1;
+        if (!built)
+            zeros[p] = k == 0 ? quotes[0].rate : zeros[p - 1];   // Cold start; ticks keep the last solution
+
+        bool converged = false;
+        for (size_t it = 0; it < kMaxNewton && !converged; ++it) {
+            double slope;
+            const double f = residual(k, &slope);
+            ++iterationCount;
+            if (slope == 0.0 || !isfinite(f)) break;
+            const double step = f / slope;
+            zeros[p] -= step;
+            converged = fabs(step) < kNewtonTol;
+        }
+        if (!converged) {
+            cerr << "[ERROR] Curve " << name << ": bootstrap failed at " << quotes[k].tenor << endl;
+            throw runtime_error("Curve " + name + ": bootstrap did not converge at " + quotes[k].tenor);
+        }
+        ++solvedCount;
+    }
+    zeros[0] = zeros[1];
+    built = true;
+}
+
+shared_ptr<RateCurve> CurveBootstrapper::makeCurve() const {
+    auto curve = make_shared<RateCurve>(name);
+    for (size_t p = 0; p < pillars.size(); ++p)
+        curve->addRate(pillars[p], zeros[p]);
+    return curve;
+}
+
+shared_ptr<RateCurve> CurveBootstrapper::build() {
+    built = false;
+    solveFrom(0);
+    return makeCurve();
+}
+
+shared_ptr<RateCurve> CurveBootstrapper::updateQuote(size_t i, double rate) {
+    if (i >= quotes.size())
+        throw out_of_range("Curve " + name + ": quote index out of range.");
+    quotes[i].rate = rate;
+    if (!built) return build();
+    solveFrom(i);
+    return makeCurve();
+}
+
+shared_ptr<RateCurve> CurveBootstrapper::getCurve() {
+    if (!built) return build();
+    return makeCurve();
+}
+
+// ===== Risk =====
+
+double CurveBootstrapper::parRate(size_t i) const {
+    if (i >= quotes.size())
+        throw out_of_range("Curve " + name + ": quote index out of range.");
+    // The pricing equation is affine in q: q = -(constant + fixed leg) / (quote leg)
+    const Instrument& inst = instruments[i];
+    double fixed = inst.constant, perQuote = 0.0;
+    for (const Node& n : inst.nodes) {
+        const double P = exp(-zeroAt(n) * n.T);
+        fixed += n.fixedCoef * P;
+        perQuote += n.quoteCoef * P;
+    }
+    return -fixed / perQuote;
+}
+
+vector<double> CurveBootstrapper::parJacobian() const {
+    const size_t n = quotes.size();
+    vector<double> J(n * n, 0.0);
+    for (size_t k = 0; k < n; ++k) {
+        const Instrument& inst = instruments[k];
+        const double q = quotes[k].rate;
+        double dfdq = 0.0;
+        vector<double> dfdz(k + 1, 0.0);
+        for (const Node& nd : inst.nodes) {
+            const double P = exp(-zeroAt(nd) * nd.T);
+            const double g = -(nd.fixedCoef + q * nd.quoteCoef) * nd.T * P;
+            dfdq += nd.quoteCoef * P;
+            for (size_t j = 0; j <= k; ++j)
+                dfdz[j] += g * dZero(nd, j + 1);
+        }
+        for (size_t j = 0; j <= k; ++j)
+            J[k * n + j] = -dfdz[j] / dfdq;
+    }
+    return J;
+}
+
+vector<double> CurveBootstrapper::zeroJacobian() const {
+    // Inverse of the lower-triangular par Jacobian by forward substitution, column by column
+    const size_t n = quotes.size();
+    const vector<double> J = parJacobian();
+    vector<double> X(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        X[i * n + i] = 1.0 / J[i * n + i];
+        for (size_t j = i + 1; j < n; ++j) {
+            double s = 0.0;
+            for (size_t m = i; m < j; ++m) s += J[j * n + m] * X[m * n + i];
+            X[j * n + i] = -s / J[j * n + j];
+        }
+    }
+    return X;
+}
+
+vector<double> CurveBootstrapper::parRisk(const vector<double>& zeroRisk) const {
+    const size_t n = quotes.size();
+    if (zeroRisk.size() != pillars.size())
+        throw invalid_argument("Curve " + name + ": zero risk must have one entry per pillar.");
+
+    vector<double> g(zeroRisk.begin() + 1, zeroRisk.end());
+    g[0] += zeroRisk[0];
+    const vector<double> X = zeroJacobian();
+    vector<double> out(n, 0.0);
+    for (size_t j = 0; j < n; ++j)
+        for (size_t i = 0; i <= j; ++i)
+            out[i] += g[j] * X[j * n + i];
+    return out;
+}
+
+// ===========================
+// MultiCurveBootstrapper
+// ===========================
+MultiCurveBootstrapper::MultiCurveBootstrapper(ThreadPool& threadPool) : pool(threadPool) {}
+
+void MultiCurveBootstrapper::addCurve(const string& curveName, const Date& asOf, const vector<CurveQuote>& quotes) {
+    curves[util::to_upper(curveName)] = make_unique<CurveBootstrapper>(curveName, asOf, quotes);
+}
+
+bool MultiCurveBootstrapper::hasCurve(const string& curveName) const {
+    return curves.count(util::to_upper(curveName)) > 0;
+}
+
+CurveBootstrapper& MultiCurveBootstrapper::getBootstrapper(const string& curveName) {
+    auto it = curves.find(util::to_upper(curveName));
+    if (it == curves.end()) {
+        cerr << "[ERROR] No bootstrapped curve: " << curveName << endl;
+        throw runtime_error("Bootstrapped curve not found: " + curveName);
+    }
+    return *it->second;
+}
+
+void MultiCurveBootstrapper::addAlias(const string& curveName, const string& alias) {
+    const CurveBootstrapper& b = getBootstrapper(curveName);
+    vector<string>& names = aliases[b.getName()];
+    const string name = util::to_upper(alias);
+    if (find(names.begin(), names.end(), name) == names.end())
+        names.push_back(name);
+}
+
+vector<MarketFactor> MultiCurveBootstrapper::movedFactors(const string& curveName) const {
+    const string name = util::to_upper(curveName);
+    vector<MarketFactor> out = { { FactorKind::Curve, name } };
+    auto it = aliases.find(name);
+    if (it != aliases.end())
+        for (const auto& alias : it->second) out.push_back({ FactorKind::Curve, alias });
+    return out;
+}
+
+void MultiCurveBootstrapper::install(Market& mkt, const CurveBootstrapper& b, const shared_ptr<RateCurve>& curve) const {
+    mkt.addCurve(b.getName(), curve);
+    auto it = aliases.find(b.getName());
+    if (it != aliases.end())
+        for (const auto& alias : it->second) mkt.addCurve(alias, curve);
+}
+
+void MultiCurveBootstrapper::buildAll(Market& mkt) {
+    vector<CurveBootstrapper*> tasks;
+    for (auto& [_, b] : curves) tasks.push_back(b.get());
+
+    vector<shared_ptr<RateCurve>> built(tasks.size());
+    pool.parallel_for(0, tasks.size(), 1, [&](size_t i) {
+        built[i] = tasks[i]->build();
+    });
+    for (size_t i = 0; i < tasks.size(); ++i)
+        install(mkt, *tasks[i], built[i]);
+}
+
+size_t MultiCurveBootstrapper::updateQuote(Market& mkt, const string& curveName, size_t quote, double rate) {
+    CurveBootstrapper& b = getBootstrapper(curveName);
+    install(mkt, b, b.updateQuote(quote, rate));
+    return b.lastSolved();
+}
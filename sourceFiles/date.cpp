@@ -19,6 +19,16 @@ static int daysInMonth(int year, int month) {
     return daysPerMonth[month - 1];
 }
 
+// Days since 1970-01-01 in the proleptic Gregorian calendar, O(1)
+static long daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const long era = (y >= 0 ? y : y - 399) / 400;
+    const long yoe = y - era * 400;
+    const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
 // ===== Constructors & Setters =====
 Date::Date() : year(0), month(0), day(0) {}
 
@@ -89,17 +99,8 @@ Date Date::addYears(int yearsToAdd) const {
 }
 
 int Date::diffDays(const Date& other) const {
-    std::tm t1 = this->toTm();
-    std::tm t2 = other.toTm();
-    time_t time1 = mktime(&t1);
-    time_t time2 = mktime(&t2);
-
-    if (time1 == -1 || time2 == -1) {
-        throw std::runtime_error("Invalid date for day difference calculation");
-    }
-
-    double diffSeconds = difftime(time1, time2);
-    return static_cast<int>(diffSeconds / 86400.0);
+    // Calendar day count; mktime is slow (global timezone lock) and shifts across DST changes
+    return static_cast<int>(daysFromCivil(year, month, day) - daysFromCivil(other.year, other.month, other.day));
 }
 
 // ===== Year Fraction Calculation =====
@@ -109,19 +110,10 @@ double Date::yearFraction(const Date& other) const {
 
 // ===== Excel Serial Date Logic =====
 long Date::getSerialDate() const {
-    int daysSinceEpoch = 0;
-    for (int y = 1900; y < year; ++y)
-        daysSinceEpoch += isLeapYear(y) ? 366 : 365;
-
-    static const int daysPerMonth[] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
-    bool leap = isLeapYear(year);
-    for (int m = 1; m < month; ++m)
-        daysSinceEpoch += (m == 2 && leap) ? 29 : daysPerMonth[m - 1];
-
-    daysSinceEpoch += day;
-    if (year > 1900) daysSinceEpoch += 1;
-
-    return daysSinceEpoch;
+    // Excel counts 1900-02-29, so serials after 1900 are one day ahead
+    long serial = daysFromCivil(year, month, day) - daysFromCivil(1900, 1, 1) + 1;
+    if (year > 1900) serial += 1;
+    return serial;
 }
 
 void Date::serialToDate(int serial) {
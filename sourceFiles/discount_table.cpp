@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "discount_table.h"
+#include "market.h"
+#include "trade.h"
+#include "helper.h"
+
+using namespace std;
+using util::to_upper;
+
+// ===== Layout Construction =====
+
+void DiscountTable::addDate(const string& curveName, const Date& date) {
+    if (finalized)
+        throw runtime_error("DiscountTable already finalized; cannot add " + curveName + " dates.");
+
+    string key = to_upper(curveName);
+    auto it = blockIndex.find(key);
+    if (it == blockIndex.end()) {
+        it = blockIndex.emplace(key, blocks.size()).first;
+        blocks.push_back(CurveBlock{ key, {}, 0 });
+    }
+    blocks[it->second].dates.push_back(date);
+}
+
+void DiscountTable::finalize() {
+    totalSlots = 0;
+    for (auto& block : blocks) {
+        sort(block.dates.begin(), block.dates.end());
+        block.dates.erase(unique(block.dates.begin(), block.dates.end()), block.dates.end());
+        block.offset = totalSlots;
+        totalSlots += block.dates.size();
+    }
+    finalized = true;
+}
+
+size_t DiscountTable::getSlot(const string& curveName, const Date& date) const {
+    if (!finalized)
+        throw runtime_error("DiscountTable must be finalized before slot lookup.");
+
+    auto it = blockIndex.find(to_upper(curveName));
+    if (it == blockIndex.end())
+        throw runtime_error("Curve not registered in DiscountTable: " + curveName);
+
+    const CurveBlock& block = blocks[it->second];
+    auto pos = lower_bound(block.dates.begin(), block.dates.end(), date);
+    if (pos == block.dates.end() || !(*pos == date))
+        throw runtime_error("Date not registered in DiscountTable for curve: " + curveName);
+
+    return block.offset + static_cast<size_t>(pos - block.dates.begin());
+}
+
+// ===== Evaluation =====
+
+vector<double> DiscountTable::evaluate(const Market& mkt) const {
+    vector<double> dfs;
+    evaluate(mkt, dfs);
+    return dfs;
+}
+
+void DiscountTable::evaluate(const Market& mkt, vector<double>& dfs) const {
+    if (!finalized)
+        throw runtime_error("DiscountTable must be finalized before evaluation.");
+
+    dfs.resize(totalSlots);
+    for (const auto& block : blocks) {
+        auto curve = mkt.getCurve(block.curveName);
+        for (size_t i = 0; i < block.dates.size(); ++i)
+            dfs[block.offset + i] = curve->getDf(block.dates[i]);
+    }
+}
+
+// ===== Portfolio Builder =====
+
+shared_ptr<DiscountTable> DiscountTable::build(const vector<shared_ptr<Trade>>& portfolio) {
+    auto table = make_shared<DiscountTable>();
+    for (const auto& trade : portfolio) {
+        if (trade && trade->usesDiscountTable())
+            trade->registerDates(*table);
+    }
+    table->finalize();
+
+    for (const auto& trade : portfolio) {
+        if (trade && trade->usesDiscountTable())
+            trade->bindDiscountTable(*table);
+    }
+    return table;
+}
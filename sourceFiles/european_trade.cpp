@@ -119,6 +119,12 @@ std::shared_ptr<Trade> EuroCallSpread::clone() const {
     return std::make_shared<EuroCallSpread>(*this);
 }
 
+uint64_t EuroCallSpread::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    double terms[2] = { strike1, strike2 };
+    return util::hashMix(h, terms);
+}
+
 const std::string& EuroCallSpread::getType() const { return tradeType; }
 const std::string& EuroCallSpread::getUnderlying() const { return underlying; }
 double EuroCallSpread::getNotional() const { return notional; }
@@ -164,4 +170,13 @@ double EuroCallSpread::getStrike() const {
 
 OptionType EuroCallSpread::getOptionType() const {
     return OptionType::Call;
-}
\ No newline at end of file
+}
+
+// Spot, discount rate and LOGVOL (tree and Black-Scholes inputs)
+std::vector<MarketFactor> EuropeanOption::getMarketDependencies() const {
+    return { { FactorKind::Spot, getUnderlying() }, { FactorKind::Curve, getRateCurve() }, { FactorKind::Vol, "LOGVOL" } };
+}
+
+std::vector<MarketFactor> EuroCallSpread::getMarketDependencies() const {
+    return { { FactorKind::Spot, getUnderlying() }, { FactorKind::Curve, getRateCurve() }, { FactorKind::Vol, "LOGVOL" } };
+}
@@ -0,0 +1,76 @@
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "exotic_batch_pricer.h"
+
+// ===========================
+// Constructor
+// ===========================
+ExoticBatchPricer::ExoticBatchPricer(const AsianPricer& asian, const BarrierPricer& barrier, ThreadPool& threadPool)
+    : asianPricer(asian), barrierPricer(barrier), pool(threadPool) {
+}
+
+// ===========================
+// Batch Pricing
+// ===========================
+bool ExoticBatchPricer::batches(const Trade& trade) {
+    return dynamic_cast<const AsianOption*>(&trade) || dynamic_cast<const BarrierOption*>(&trade);
+}
+
+std::vector<double> ExoticBatchPricer::price(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades,
+    size_t* groups) const {
+    std::map<std::string, std::vector<size_t>> asianGroups, barrierGroups;
+    std::vector<size_t> others;
+
+    for (size_t i = 0; i < trades.size(); ++i) {
+        std::ostringstream key;
+        key.precision(17);
+        if (auto a = std::dynamic_pointer_cast<AsianOption>(trades[i])) {
+            key << a->getUnderlying() << "|" << a->getRateCurve();
+            for (const auto& d : a->getFixingDates()) key << "|" << d.getSerialDate();
+            asianGroups[key.str()].push_back(i);
+        }
+        else if (auto b = std::dynamic_pointer_cast<BarrierOption>(trades[i])) {
+            key << b->getUnderlying() << "|" << b->getRateCurve() << "|" << b->getExpiry().getSerialDate()
+                << "|" << b->getBarrier() << "|" << (b->isUpBarrier() ? "UP" : "DOWN");
+            barrierGroups[key.str()].push_back(i);
+        }
+        else {
+            others.push_back(i);
+        }
+    }
+
+    // One task per group, in key order; every other trade is its own task
+    std::vector<const std::vector<size_t>*> asianTasks, barrierTasks;
+    for (const auto& [_, idx] : asianGroups) asianTasks.push_back(&idx);
+    for (const auto& [_, idx] : barrierGroups) barrierTasks.push_back(&idx);
+    if (groups) *groups = asianTasks.size() + barrierTasks.size();
+
+    std::vector<double> pv(trades.size(), 0.0);
+    const size_t nTasks = asianTasks.size() + barrierTasks.size() + others.size();
+    pool.parallel_for(0, nTasks, 1, [&](size_t task) {
+        if (task < asianTasks.size()) {
+            const auto& idx = *asianTasks[task];
+            std::vector<const AsianOption*> group;
+            for (size_t i : idx) group.push_back(static_cast<const AsianOption*>(trades[i].get()));
+            std::vector<McResult> res = asianPricer.priceGroup(mkt, group);
+            for (size_t k = 0; k < idx.size(); ++k) pv[idx[k]] = res[k].price;
+            return;
+        }
+        task -= asianTasks.size();
+        if (task < barrierTasks.size()) {
+            const auto& idx = *barrierTasks[task];
+            std::vector<const BarrierOption*> group;
+            for (size_t i : idx) group.push_back(static_cast<const BarrierOption*>(trades[i].get()));
+            std::vector<double> res = barrierPricer.priceGroup(mkt, group);
+            for (size_t k = 0; k < idx.size(); ++k) pv[idx[k]] = res[k];
+            return;
+        }
+        task -= barrierTasks.size();
+        size_t i = others[task];
+        pv[i] = trades[i]->pv(mkt);
+    });
+    return pv;
+}
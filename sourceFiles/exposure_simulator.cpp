@@ -0,0 +1,459 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "exposure_simulator.h"
+#include "swap.h"
+#include "philox.h"
+#include "helper.h"
+
+namespace {
+
+    // Per-thread block buffers, reused across blocks and runs
+    struct BlockScratch {
+        std::vector<double> u, z;       // Uniforms / normals, [(f * steps + k) * count + p]
+        std::vector<double> x;          // Factor states, [f * count + p]
+        std::vector<double> value;      // Netted values, [set * count + p]
+        std::vector<double> bond;       // P(t, T) of one bucket across the block
+    };
+    thread_local BlockScratch scratch;
+
+    double bondB(double a, double tau) {
+        return a > 1e-12 ? (1.0 - std::exp(-a * tau)) / a : tau;
+    }
+
+    double stateVariance(double a, double sigma, double t) {
+        return a > 1e-12 ? sigma * sigma * (1.0 - std::exp(-2.0 * a * t)) / (2.0 * a) : sigma * sigma * t;
+    }
+
+    // Variance of the integral of x over [t, T] (Brigo & Mercurio V(t, T))
+    double integralVariance(double a, double sigma, double tau) {
+        if (a < 1e-6) return sigma * sigma * tau * tau * tau / 3.0;
+        return sigma * sigma / (a * a) * (tau + 2.0 / a * std::exp(-a * tau)
+            - 0.5 / a * std::exp(-2.0 * a * tau) - 1.5 / a);
+    }
+}
+
+// ===========================
+// Constructor
+// ===========================
+ExposureSimulator::ExposureSimulator(const ExposureConfig& cfg, ThreadPool& threadPool)
+    : config(cfg), pool(threadPool) {
+    if (config.paths == 0)
+        throw std::invalid_argument("Exposure simulation needs at least one path");
+    if (config.model.stepDays <= 0 || config.model.volatility <= 0.0 || config.model.meanReversion < 0.0)
+        throw std::invalid_argument("Exposure simulation needs positive step, vol and non-negative mean reversion");
+    for (double q : config.pfeQuantiles) {
+        if (q <= 0.0 || q >= 1.0)
+            throw std::invalid_argument("PFE quantiles must lie in (0, 1)");
+    }
+    if (!config.pfeQuantiles.empty() && config.pfeBins == 0)
+        throw std::invalid_argument("PFE quantiles need at least one histogram bin");
+}
+
+void ExposureSimulator::setCredit(const std::string& nettingSet, const CounterpartyCredit& credit) {
+    if (credit.recovery < 0.0 || credit.recovery >= 1.0 || credit.spread < 0.0)
+        throw std::invalid_argument("Invalid credit for netting set " + nettingSet);
+    credits[nettingSet] = credit;
+}
+
+// ===========================
+// Simulation
+// ===========================
+std::vector<ExposureProfile> ExposureSimulator::run(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades) const {
+    const HullWhiteParams& model = config.model;
+
+    // Netting sets in name order, swaps only
+    std::vector<std::shared_ptr<const Swap>> swaps;
+    std::vector<std::string> setOf;
+    std::map<std::string, uint32_t> setIndex;
+    for (size_t i = 0; i < trades.size(); ++i) {
+        auto swap = std::dynamic_pointer_cast<const Swap>(trades[i]);
+        if (!swap) continue;
+        std::string name = swap->getNettingSet();
+        if (name.empty())
+            name = "TRADE-" + (swap->getId().empty() ? std::to_string(i + 1) : swap->getId());
+        swaps.push_back(swap);
+        setOf.push_back(name);
+        setIndex[name] = 0;
+    }
+    if (swaps.empty()) return {};
+
+    std::vector<ExposureProfile> profiles;
+    for (auto& [name, idx] : setIndex) {
+        idx = static_cast<uint32_t>(profiles.size());
+        profiles.emplace_back();
+        profiles.back().nettingSet = name;
+    }
+    const size_t nSets = profiles.size();
+
+    // Grid from today to the last maturity
+    Date horizon = mkt.asOf;
+    for (const auto& s : swaps)
+        if (horizon < s->getExpiry()) horizon = s->getExpiry();
+    const size_t nDates = HullWhiteTree::stepsToCover(mkt.asOf, horizon, model.stepDays);
+    const double dt = model.stepDays / 365.0;   // ACT/365, as Date::operator-
+    std::vector<Date> dates(nDates);
+    std::vector<double> times(nDates);
+    for (size_t k = 0; k < nDates; ++k) {
+        dates[k] = mkt.asOf.addDays(static_cast<int>(k) * model.stepDays);
+        times[k] = k * dt;
+    }
+
+    // One factor per distinct curve object (aliases such as USD-GOV share their curve)
+    std::vector<Factor> factors;
+    std::vector<const RateCurve*> factorCurve;
+    std::vector<const RateCurve*> setCurve(nSets, nullptr);    // CVA discounting
+    std::vector<std::unordered_map<uint64_t, size_t>> slotOf;
+    std::vector<std::vector<Flow>> raw;                          // Accumulated flows per factor
+    std::vector<std::vector<long>> rawSerial;
+
+    for (size_t i = 0; i < swaps.size(); ++i) {
+        const Swap& swap = *swaps[i];
+        const RateCurve* curve = mkt.getCurve(swap.getRateCurve()).get();
+        const uint32_t set = setIndex[setOf[i]];
+        ++profiles[set].trades;
+        if (!setCurve[set]) setCurve[set] = curve;
+
+        size_t f = std::find(factorCurve.begin(), factorCurve.end(), curve) - factorCurve.begin();
+        if (f == factorCurve.size()) {
+            factorCurve.push_back(curve);
+            slotOf.emplace_back();
+            raw.emplace_back();
+            rawSerial.emplace_back();
+        }
+
+        // Swap::pv = N + sum_i N K tau_i P(T_i) - N P(T_end), payments on or after the date
+        auto add = [&](const Date& d, double fixed, double bond) {
+            const long serial = d.getSerialDate();
+            if (serial < mkt.asOf.getSerialDate()) return;
+            const uint64_t key = (static_cast<uint64_t>(serial) << 32) | set;
+            auto it = slotOf[f].find(key);
+            if (it == slotOf[f].end()) {
+                it = slotOf[f].emplace(key, raw[f].size()).first;
+                raw[f].push_back(Flow{ set, 0.0, 0.0 });
+                rawSerial[f].push_back(serial);
+            }
+            raw[f][it->second].fixed += fixed;
+            raw[f][it->second].bond += bond;
+        };
+        const double sign = swap.isLong() ? 1.0 : -1.0;
+        const double N = sign * swap.getNotional();
+        const auto& schedule = swap.getSchedule();
+        for (size_t j = 1; j < schedule.size(); ++j)
+            add(schedule[j], 0.0, N * swap.getStrike() * swap.getAccrual(j));
+        add(swap.getExpiry(), N, -N);
+    }
+
+    // Sort each factor's flows by payment date into buckets, then the per-date bond terms
+    factors.resize(factorCurve.size());
+    for (size_t f = 0; f < factors.size(); ++f) {
+        std::vector<size_t> order(raw[f].size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](size_t l, size_t r) {
+            return rawSerial[f][l] != rawSerial[f][r] ? rawSerial[f][l] < rawSerial[f][r] : raw[f][l].set < raw[f][r].set;
+        });
+
+        Factor& fac = factors[f];
+        for (size_t i : order) {
+            if (fac.serials.empty() || fac.serials.back() != rawSerial[f][i]) {
+                fac.serials.push_back(rawSerial[f][i]);
+                fac.flowStart.push_back(fac.flows.size());
+            }
+            fac.flows.push_back(raw[f][i]);
+        }
+        fac.flowStart.push_back(fac.flows.size());
+
+        fac.zero.resize(fac.serials.size());
+        Date d = mkt.asOf;
+        for (size_t j = 0; j < fac.serials.size(); ++j) {
+            d.serialToDate(fac.serials[j]);
+            fac.zero[j] = factorCurve[f]->getDf(d);
+        }
+        buildCoefficients(fac, *factorCurve[f], dates, times);
+    }
+    raw.clear();
+    slotOf.clear();
+
+    // First block alone: its exposures set each histogram's range
+    const size_t nPaths = config.paths;
+    const size_t nBlocks = (nPaths + kBlockPaths - 1) / kBlockPaths;
+    const size_t nRows = nSets * nDates;
+    const bool wantPfe = !config.pfeQuantiles.empty();
+    std::vector<double> posSum(nRows, 0.0), negSum(nRows, 0.0);
+    std::vector<double> floor(nRows, 0.0), peak(nRows, 0.0);
+    auto fold = [&](const BlockSums& blk) {
+        for (size_t r = 0; r < nRows; ++r) {
+            posSum[r] += blk.pos[r];
+            negSum[r] += blk.neg[r];
+            if (blk.peak[r] > 0.0) {
+                floor[r] = floor[r] > 0.0 ? std::min(floor[r], blk.floor[r]) : blk.floor[r];
+                peak[r] = std::max(peak[r], blk.peak[r]);
+            }
+        }
+    };
+
+    PfeHistogram hist;
+    {
+        BlockSums first;
+        std::vector<double> pilot;
+        const size_t count = std::min(kBlockPaths, nPaths);
+        simulateBlock(factors, nSets, nDates, dt, 0, count, first, nullptr, wantPfe ? &pilot : nullptr);
+        fold(first);
+
+        if (wantPfe) {
+            // Pilot range widened by its own span each side; a row with no positive pilot
+            // exposure borrows its netting set's widest
+            hist.bins = config.pfeBins;
+            hist.lo.assign(nRows, 0.0);
+            hist.hi.assign(nRows, 0.0);
+            hist.counts = std::vector<std::atomic<uint32_t>>(nRows * hist.slots());
+            for (size_t s = 0; s < nSets; ++s) {
+                double setPeak = 0.0;
+                for (size_t k = 0; k < nDates; ++k) setPeak = std::max(setPeak, peak[s * nDates + k]);
+                for (size_t k = 0; k < nDates; ++k) {
+                    const size_t r = s * nDates + k;
+                    const double span = peak[r] - floor[r];
+                    if (peak[r] <= 0.0) {
+                        hist.hi[r] = 2.0 * setPeak;
+                    }
+                    else if (span <= 0.0) {
+                        hist.lo[r] = 0.5 * peak[r];
+                        hist.hi[r] = 1.5 * peak[r];
+                    }
+                    else {
+                        hist.lo[r] = std::max(0.0, floor[r] - span);
+                        hist.hi[r] = peak[r] + span;
+                    }
+                    hist.add(r, pilot.data() + r * count, count);
+                }
+            }
+        }
+    }
+
+    // Remaining blocks in waves of one per thread, each folded in block order
+    const size_t wave = std::max<size_t>(1, pool.size());
+    std::vector<BlockSums> blocks(std::min(wave, nBlocks));
+    for (size_t b0 = 1; b0 < nBlocks; b0 += wave) {
+        const size_t n = std::min(wave, nBlocks - b0);
+        pool.parallel_for(0, n, 1, [&](size_t i) {
+            const size_t first = (b0 + i) * kBlockPaths;
+            const size_t count = std::min(kBlockPaths, nPaths - first);
+            simulateBlock(factors, nSets, nDates, dt, first, count, blocks[i], wantPfe ? &hist : nullptr, nullptr);
+        });
+        for (size_t i = 0; i < n; ++i) fold(blocks[i]);
+    }
+
+    const double invPaths = 1.0 / static_cast<double>(nPaths);
+    for (size_t s = 0; s < nSets; ++s) {
+        ExposureProfile& prof = profiles[s];
+        prof.dates = dates;
+        prof.times = times;
+        prof.ee.assign(nDates, 0.0);
+        prof.ene.assign(nDates, 0.0);
+        for (size_t k = 0; k < nDates; ++k) {
+            prof.ee[k] = posSum[s * nDates + k] * invPaths;
+            prof.ene[k] = negSum[s * nDates + k] * invPaths;
+        }
+        if (wantPfe) {
+            prof.pfe.assign(config.pfeQuantiles.size(), std::vector<double>(nDates, 0.0));
+            for (size_t q = 0; q < config.pfeQuantiles.size(); ++q) {
+                for (size_t k = 0; k < nDates; ++k) {
+                    const size_t r = s * nDates + k;
+                    prof.pfe[q][k] = hist.quantile(r, config.pfeQuantiles[q], nPaths, floor[r], peak[r]);
+                }
+            }
+        }
+    }
+
+    // EPE and a unilateral CVA, (1 - R) * sum P(0, t_k) EE(t_k) PD(t_{k-1}, t_k)
+    for (size_t s = 0; s < nSets; ++s) {
+        ExposureProfile& prof = profiles[s];
+        auto it = credits.find(prof.nettingSet);
+        const CounterpartyCredit& credit = it != credits.end() ? it->second : defaultCredit;
+        const double lambda = credit.spread / (1.0 - credit.recovery);
+
+        double area = 0.0, cva = 0.0;
+        for (size_t k = 1; k < nDates; ++k) {
+            area += prof.ee[k] * dt;
+            const double pd = std::exp(-lambda * times[k - 1]) - std::exp(-lambda * times[k]);
+            cva += setCurve[s]->getDf(dates[k]) * prof.ee[k] * pd;
+        }
+        prof.epe = nDates > 1 ? area / times.back() : prof.ee[0];
+        prof.cva = (1.0 - credit.recovery) * cva;
+    }
+    return profiles;
+}
+
+// ===========================
+// PFE Histogram
+// ===========================
+// Counts go to a per-thread row first, so a block costs one atomic add per occupied slot
+void ExposureSimulator::PfeHistogram::add(size_t row, const double* value, size_t n) {
+    thread_local std::vector<uint32_t> local;
+    local.assign(slots(), 0);
+    const double low = lo[row], high = hi[row];
+    const double scale = high > low ? static_cast<double>(bins) / (high - low) : 0.0;
+    for (size_t p = 0; p < n; ++p) {
+        const double e = value[p];
+        size_t slot;
+        if (e <= 0.0) slot = 0;
+        else if (e < low) slot = 1;
+        else if (e >= high) slot = bins + 2;
+        else slot = 2 + std::min(bins - 1, static_cast<size_t>((e - low) * scale));
+        ++local[slot];
+    }
+    std::atomic<uint32_t>* out = counts.data() + row * slots();
+    for (size_t slot = 0; slot < local.size(); ++slot)
+        if (local[slot]) out[slot].fetch_add(local[slot], std::memory_order_relaxed);
+}
+
+// The ceil(q n)-th smallest sample, as the exact order statistic would pick, placed at the
+// matching fraction of its slot's range (zero, [floor, lo), a bin, or [hi, peak]) and kept
+// within the extremes seen
+double ExposureSimulator::PfeHistogram::quantile(size_t row, double q, size_t n, double floor, double peak) const {
+    const double rank = std::max(1.0, std::ceil(q * static_cast<double>(n)));
+    const std::atomic<uint32_t>* c = counts.data() + row * slots();
+    const double width = (hi[row] - lo[row]) / static_cast<double>(bins);
+    double below = 0.0;
+    for (size_t slot = 0; slot < slots(); ++slot) {
+        const double count = c[slot].load(std::memory_order_relaxed);
+        if (count == 0.0 || below + count < rank) {
+            below += count;
+            continue;
+        }
+        if (slot == 0) return 0.0;
+        double from, to;
+        if (slot == 1) {
+            from = floor;
+            to = lo[row];
+        }
+        else if (slot == bins + 2) {
+            from = hi[row];
+            to = peak;
+        }
+        else {
+            from = lo[row] + width * static_cast<double>(slot - 2);
+            to = from + width;
+        }
+        return std::min(peak, std::max(floor, from + (to - from) * (rank - below - 0.5) / count));
+    }
+    return peak;
+}
+
+// ln A(t_k, T) and B(t_k, T) of every bucket still live at t_k:
+// P(t, T) = exp(lnA - B x(t)), lnA = ln(P(0, T) / P(0, t)) + [V(t, T) - V(0, T) + V(0, t)] / 2
+void ExposureSimulator::buildCoefficients(Factor& f, const RateCurve& curve, const std::vector<Date>& dates,
+    const std::vector<double>& times) const {
+    const double a = config.model.meanReversion;
+    const double sigma = config.model.volatility;
+    const size_t nDates = dates.size();
+
+    f.firstLive.resize(nDates);
+    f.coefStart.resize(nDates + 1);
+    size_t total = 0;
+    for (size_t k = 0; k < nDates; ++k) {
+        f.firstLive[k] = std::lower_bound(f.serials.begin(), f.serials.end(), dates[k].getSerialDate()) - f.serials.begin();
+        f.coefStart[k] = total;
+        total += f.serials.size() - f.firstLive[k];
+    }
+    f.coefStart[nDates] = total;
+    f.lnA.resize(total);
+    f.B.resize(total);
+
+    for (size_t k = 0; k < nDates; ++k) {
+        const double lnP0t = std::log(curve.getDf(dates[k]));
+        const double v0t = integralVariance(a, sigma, times[k]);
+        const long serial = dates[k].getSerialDate();
+        for (size_t j = f.firstLive[k], c = f.coefStart[k]; j < f.serials.size(); ++j, ++c) {
+            const double tau = (f.serials[j] - serial) / 365.0;
+            const double convexity = integralVariance(a, sigma, tau) - integralVariance(a, sigma, times[k] + tau) + v0t;
+            f.B[c] = bondB(a, tau);
+            f.lnA[c] = std::log(f.zero[j]) - lnP0t + 0.5 * convexity;
+        }
+    }
+}
+
+void ExposureSimulator::simulateBlock(const std::vector<Factor>& factors, size_t nSets, size_t nDates, double dt,
+    uint64_t firstPath, size_t count, BlockSums& sums, PfeHistogram* hist, std::vector<double>* pilot) const {
+    const double a = config.model.meanReversion;
+    const double decay = std::exp(-a * dt);
+    const double stepSd = std::sqrt(stateVariance(a, config.model.volatility, dt));
+    const size_t nF = factors.size();
+    const size_t steps = nDates - 1;
+
+    BlockScratch& buf = scratch;
+    buf.u.resize(nF * steps * count);
+    buf.z.resize(buf.u.size());
+    buf.x.assign(nF * count, 0.0);
+    buf.value.resize(nSets * count);
+    buf.bond.resize(count);
+    sums.pos.assign(nSets * nDates, 0.0);
+    sums.neg.assign(nSets * nDates, 0.0);
+    sums.floor.assign(nSets * nDates, 0.0);
+    sums.peak.assign(nSets * nDates, 0.0);
+    if (pilot) pilot->assign(nSets * nDates * count, 0.0);
+
+    // Normals of path g on factor f depend only on (seed, f, g)
+    Philox4x32 rng(config.seed);
+    double u4[4];
+    for (size_t f = 0; f < nF; ++f) {
+        for (size_t p = 0; p < count; ++p) {
+            for (size_t k = 0; k < steps; k += 4) {
+                rng.uniforms(static_cast<uint32_t>(f), firstPath + p, static_cast<uint32_t>(k / 4), u4);
+                for (size_t c = 0; c < 4 && k + c < steps; ++c)
+                    buf.u[(f * steps + k + c) * count + p] = u4[c];
+            }
+        }
+    }
+    util::invNormCdf(buf.u.data(), buf.z.data(), buf.u.size());
+
+    for (size_t k = 0; k < nDates; ++k) {
+        if (k > 0) {
+            for (size_t f = 0; f < nF; ++f) {
+                double* x = buf.x.data() + f * count;
+                const double* z = buf.z.data() + (f * steps + k - 1) * count;
+                for (size_t p = 0; p < count; ++p)
+                    x[p] = x[p] * decay + stepSd * z[p];
+            }
+        }
+
+        std::fill(buf.value.begin(), buf.value.end(), 0.0);
+        for (size_t f = 0; f < nF; ++f) {
+            const Factor& fac = factors[f];
+            const double* x = buf.x.data() + f * count;
+            for (size_t j = fac.firstLive[k], c = fac.coefStart[k]; j < fac.serials.size(); ++j, ++c) {
+                const double lnA = fac.lnA[c], B = fac.B[c];
+                for (size_t p = 0; p < count; ++p)
+                    buf.bond[p] = std::exp(lnA - B * x[p]);
+                for (size_t e = fac.flowStart[j]; e < fac.flowStart[j + 1]; ++e) {
+                    const Flow& fl = fac.flows[e];
+                    double* v = buf.value.data() + fl.set * count;
+                    for (size_t p = 0; p < count; ++p)
+                        v[p] += fl.fixed + fl.bond * buf.bond[p];
+                }
+            }
+        }
+
+        for (size_t s = 0; s < nSets; ++s) {
+            const double* v = buf.value.data() + s * count;
+            const size_t row = s * nDates + k;
+            double pos = 0.0, neg = 0.0, lo = 0.0, hi = 0.0;
+            for (size_t p = 0; p < count; ++p) {
+                pos += std::max(v[p], 0.0);
+                neg += std::min(v[p], 0.0);
+                if (v[p] > 0.0) {
+                    lo = lo > 0.0 ? std::min(lo, v[p]) : v[p];
+                    hi = std::max(hi, v[p]);
+                }
+            }
+            sums.pos[row] = pos;
+            sums.neg[row] = neg;
+            sums.floor[row] = lo;
+            sums.peak[row] = hi;
+            if (hist) hist->add(row, v, count);
+            if (pilot) std::copy(v, v + count, pilot->data() + row * count);
+        }
+    }
+}
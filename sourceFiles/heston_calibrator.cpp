@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "heston_calibrator.h"
+
+namespace {
+
+    const size_t kParams = 5;
+    const double kRhoBound = 0.999;
+
+    HestonParams toParams(const double* u) {
+        HestonParams p;
+        p.v0 = std::exp(u[0]);
+        p.kappa = std::exp(u[1]);
+        p.theta = std::exp(u[2]);
+        p.sigma = std::exp(u[3]);
+        p.rho = kRhoBound * std::tanh(u[4]);
+        return p;
+    }
+
+    void fromParams(const HestonParams& p, double* u) {
+        u[0] = std::log(std::max(p.v0, 1e-8));
+        u[1] = std::log(p.kappa);
+        u[2] = std::log(p.theta);
+        u[3] = std::log(p.sigma);
+        u[4] = std::atanh(std::clamp(p.rho / kRhoBound, -0.999999, 0.999999));
+    }
+
+    // Cholesky solve of the damped 5x5 normal equations; false if not positive definite
+    bool solveSpd(const double* A, const double* g, double* x) {
+        double L[kParams * kParams] = {};
+        for (size_t j = 0; j < kParams; ++j) {
+            double diag = A[j * kParams + j];
+            for (size_t k = 0; k < j; ++k) diag -= L[j * kParams + k] * L[j * kParams + k];
+            if (diag <= 0.0) return false;
+            L[j * kParams + j] = std::sqrt(diag);
+            for (size_t i = j + 1; i < kParams; ++i) {
+                double v = A[i * kParams + j];
+                for (size_t k = 0; k < j; ++k) v -= L[i * kParams + k] * L[j * kParams + k];
+                L[i * kParams + j] = v / L[j * kParams + j];
+            }
+        }
+        double y[kParams];
+        for (size_t i = 0; i < kParams; ++i) {
+            double v = g[i];
+            for (size_t k = 0; k < i; ++k) v -= L[i * kParams + k] * y[k];
+            y[i] = v / L[i * kParams + i];
+        }
+        for (size_t i = kParams; i-- > 0;) {
+            double v = y[i];
+            for (size_t k = i + 1; k < kParams; ++k) v -= L[k * kParams + i] * x[k];
+            x[i] = v / L[i * kParams + i];
+        }
+        return true;
+    }
+
+    double halfSquares(const std::vector<double>& r) {
+        double s = 0.0;
+        for (double v : r) s += v * v;
+        return 0.5 * s;
+    }
+}
+
+// ===========================
+// Constructor
+// ===========================
+HestonCalibrator::HestonCalibrator(const HestonPricer& p, size_t maxIterations, double tolerance)
+    : pricer(p), maxIter(maxIterations), tol(tolerance) {
+}
+
+// ===========================
+// Calibration
+// ===========================
+void HestonCalibrator::residuals(const HestonParams& p, double spot, const std::vector<Chain>& chains,
+    const std::vector<HestonQuote>& quotes, std::vector<double>& r) const {
+    for (const auto& c : chains) {
+        const std::vector<double> model = pricer.priceChain(p, spot, c.rate, c.expiry, c.strikes, c.types);
+        for (size_t j = 0; j < c.quotes.size(); ++j) {
+            const HestonQuote& q = quotes[c.quotes[j]];
+            r[c.quotes[j]] = q.weight * (model[j] - q.price);
+        }
+    }
+}
+
+HestonCalibration HestonCalibrator::calibrate(double spot, const std::vector<HestonQuote>& quotes,
+    const HestonParams& initial) const {
+    if (quotes.size() < kParams)
+        throw std::invalid_argument("Heston calibration needs at least five quotes");
+    HestonPricer::validate(initial);
+
+    // One chain per (expiry, rate)
+    std::map<std::pair<double, double>, size_t> chainOf;
+    std::vector<Chain> chains;
+    for (size_t i = 0; i < quotes.size(); ++i) {
+        const HestonQuote& q = quotes[i];
+        if (q.expiry <= 0.0 || q.strike <= 0.0)
+            throw std::invalid_argument("Heston quotes need a positive expiry and strike");
+        auto it = chainOf.emplace(std::make_pair(q.expiry, q.rate), chains.size()).first;
+        if (it->second == chains.size())
+            chains.push_back(Chain{ q.expiry, q.rate, {}, {}, {} });
+        Chain& c = chains[it->second];
+        c.strikes.push_back(q.strike);
+        c.types.push_back(q.type);
+        c.quotes.push_back(i);
+    }
+
+    const size_t m = quotes.size();
+    HestonCalibration result;
+    double u[kParams];
+    fromParams(initial, u);
+
+    std::vector<double> r(m), rTrial(m), J(m * kParams);
+    residuals(toParams(u), spot, chains, quotes, r);
+    double cost = halfSquares(r);
+    size_t evals = 1;
+
+    double A[kParams * kParams], g[kParams];
+    auto linearize = [&]() {
+        for (size_t p = 0; p < kParams; ++p) {
+            const double h = 1e-6 * std::max(1.0, std::abs(u[p]));
+            double up[kParams];
+            std::copy(u, u + kParams, up);
+            up[p] += h;
+            residuals(toParams(up), spot, chains, quotes, rTrial);
+            for (size_t i = 0; i < m; ++i) J[i * kParams + p] = (rTrial[i] - r[i]) / h;
+        }
+        evals += kParams;
+        std::fill(A, A + kParams * kParams, 0.0);
+        std::fill(g, g + kParams, 0.0);
+        for (size_t i = 0; i < m; ++i) {
+            const double* row = &J[i * kParams];
+            for (size_t a = 0; a < kParams; ++a) {
+                g[a] += row[a] * r[i];
+                for (size_t b = 0; b < kParams; ++b) A[a * kParams + b] += row[a] * row[b];
+            }
+        }
+    };
+
+    linearize();
+    double mu = 1e-3;
+    double nu = 2.0;
+    size_t iter = 0;
+    bool converged = false;
+    while (iter < maxIter) {
+        ++iter;
+        double gMax = 0.0;
+        for (double v : g) gMax = std::max(gMax, std::abs(v));
+        if (gMax < tol || cost < tol * tol) {
+            converged = true;
+            break;
+        }
+
+        // (A + mu diag(A)) delta = -g
+        double damped[kParams * kParams], negG[kParams], delta[kParams];
+        for (size_t a = 0; a < kParams; ++a) {
+            negG[a] = -g[a];
+            for (size_t b = 0; b < kParams; ++b) damped[a * kParams + b] = A[a * kParams + b];
+            damped[a * kParams + a] += mu * std::max(A[a * kParams + a], 1e-12);
+        }
+        if (!solveSpd(damped, negG, delta)) {
+            mu *= nu;
+            nu *= 2.0;
+            continue;
+        }
+
+        double stepNorm = 0.0, uNorm = 0.0;
+        for (size_t a = 0; a < kParams; ++a) {
+            stepNorm += delta[a] * delta[a];
+            uNorm += u[a] * u[a];
+        }
+        if (std::sqrt(stepNorm) < tol * (std::sqrt(uNorm) + tol)) {
+            converged = true;
+            break;
+        }
+
+        double uTrial[kParams];
+        for (size_t a = 0; a < kParams; ++a) uTrial[a] = u[a] + delta[a];
+        residuals(toParams(uTrial), spot, chains, quotes, rTrial);
+        ++evals;
+        const double trialCost = halfSquares(rTrial);
+
+        // Gain ratio against the linear model: L(0) - L(delta) = -delta'g - delta'A delta / 2
+        double predicted = 0.0;
+        for (size_t a = 0; a < kParams; ++a) {
+            double Ad = 0.0;
+            for (size_t b = 0; b < kParams; ++b) Ad += A[a * kParams + b] * delta[b];
+            predicted -= delta[a] * (g[a] + 0.5 * Ad);
+        }
+        const double gain = predicted > 0.0 ? (cost - trialCost) / predicted : -1.0;
+
+        if (std::isfinite(trialCost) && gain > 0.0) {
+            std::copy(uTrial, uTrial + kParams, u);
+            r.swap(rTrial);
+            const bool small = cost - trialCost < tol * cost;
+            cost = trialCost;
+            mu *= std::max(1.0 / 3.0, 1.0 - std::pow(2.0 * gain - 1.0, 3));
+            nu = 2.0;
+            if (small) {
+                converged = true;
+                break;
+            }
+            linearize();
+        }
+        else {
+            mu *= nu;
+            nu *= 2.0;
+        }
+    }
+
+    result.params = toParams(u);
+    result.rmse = std::sqrt(2.0 * cost / static_cast<double>(m));
+    result.iterations = iter;
+    result.evaluations = evals;
+    result.converged = converged;
+    return result;
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tuple>
+
+#include "heston_pricer.h"
+#include "european_trade.h"
+#include "helper.h"
+
+namespace {
+
+    const double kPi = 3.14159265358979323846;
+
+    // First two cumulants of ln(S_T / S_0) (Fang & Oosterlee 2008, Table 11)
+    void cumulants(const HestonParams& p, double r, double T, double& c1, double& c2) {
+        const double k = p.kappa, th = p.theta, s = p.sigma, rho = p.rho, v0 = p.v0;
+        const double e1 = std::exp(-k * T), e2 = std::exp(-2.0 * k * T);
+        c1 = r * T + (1.0 - e1) * (th - v0) / (2.0 * k) - 0.5 * th * T;
+        c2 = (s * T * k * e1 * (v0 - th) * (8.0 * k * rho - 4.0 * s)
+            + k * rho * s * (1.0 - e1) * (16.0 * th - 8.0 * v0)
+            + 2.0 * th * k * T * (-4.0 * k * rho * s + s * s + 4.0 * k * k)
+            + s * s * ((th - 2.0 * v0) * e2 + th * (6.0 * e1 - 7.0) + 2.0 * v0)
+            + 8.0 * k * k * (v0 - th) * (1.0 - e1)) / (8.0 * k * k * k);
+        c2 = std::abs(c2);
+    }
+
+    // Per-thread expansion buffers, reused across chains
+    struct CosScratch {
+        std::vector<std::complex<double>> coef;
+        std::vector<double> logMoneyness;
+    };
+    thread_local CosScratch scratch;
+}
+
+// ===========================
+// Constructor / Parameters
+// ===========================
+HestonPricer::HestonPricer(const HestonParams& defaults, size_t terms, double truncation)
+    : nTerms(terms), L(truncation), defaultParams(defaults) {
+    if (nTerms < 16)
+        throw std::invalid_argument("COS expansion needs at least 16 terms");
+    if (L <= 0.0)
+        throw std::invalid_argument("COS truncation width must be positive");
+    validate(defaults);
+}
+
+void HestonPricer::validate(const HestonParams& p) {
+    if (p.v0 < 0.0 || p.kappa <= 0.0 || p.theta <= 0.0 || p.sigma <= 0.0 || p.rho <= -1.0 || p.rho >= 1.0)
+        throw std::invalid_argument("Invalid Heston parameters");
+}
+
+void HestonPricer::setParams(const std::string& underlying, const HestonParams& p) {
+    validate(p);
+    params[util::to_upper(underlying)] = p;
+}
+
+const HestonParams& HestonPricer::getParams(const std::string& underlying) const {
+    auto it = params.find(util::to_upper(underlying));
+    return it != params.end() ? it->second : defaultParams;
+}
+
+// ===========================
+// Characteristic Function
+// ===========================
+std::complex<double> HestonPricer::characteristic(const HestonParams& p, double r, double T, double u) {
+    using cd = std::complex<double>;
+    const cd iu(0.0, u);
+    const double s2 = p.sigma * p.sigma;
+    const cd xi = p.kappa - p.rho * p.sigma * iu;
+    const cd d = std::sqrt(xi * xi + s2 * (u * u + iu));
+    const cd g = (xi - d) / (xi + d);
+    const cd e = std::exp(-d * T);
+    const cd C = iu * r * T + p.kappa * p.theta / s2 * ((xi - d) * T - 2.0 * std::log((1.0 - g * e) / (1.0 - g)));
+    const cd D = (xi - d) / s2 * (1.0 - e) / (1.0 - g * e);
+    return std::exp(C + D * p.v0);
+}
+
+// ===========================
+// Pricing
+// ===========================
+std::vector<double> HestonPricer::priceChain(const HestonParams& p, double spot, double rate, double T,
+    const std::vector<double>& strikes, const std::vector<OptionType>& types) const {
+    if (strikes.size() != types.size())
+        throw std::invalid_argument("Strike and option type counts differ");
+    const size_t n = strikes.size();
+    std::vector<double> out(n, 0.0);
+    if (n == 0) return out;
+
+    if (T <= 0.0) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = types[i] == OptionType::Put ? std::max(strikes[i] - spot, 0.0) : std::max(spot - strikes[i], 0.0);
+        return out;
+    }
+
+    // One interval [a, b] for y = ln(S_T / K) that covers every strike
+    CosScratch& buf = scratch;
+    buf.logMoneyness.resize(n);
+    double xMin = HUGE_VAL, xMax = -HUGE_VAL;
+    for (size_t i = 0; i < n; ++i) {
+        if (strikes[i] <= 0.0)
+            throw std::invalid_argument("Heston chain strikes must be positive");
+        buf.logMoneyness[i] = std::log(spot / strikes[i]);
+        xMin = std::min(xMin, buf.logMoneyness[i]);
+        xMax = std::max(xMax, buf.logMoneyness[i]);
+    }
+    double c1, c2;
+    cumulants(p, rate, T, c1, c2);
+    const double a = xMin + c1 - L * std::sqrt(c2);
+    const double b = xMax + c1 + L * std::sqrt(c2);
+    const double width = b - a;
+
+    // coef_k = phi(u_k) e^{-i u_k a} * 2/(b-a) (psi_k - chi_k) on [a, 0], the put payoff per unit strike
+    buf.coef.resize(nTerms);
+    const double ea = std::exp(a);
+    for (size_t k = 0; k < nTerms; ++k) {
+        const double u = k * kPi / width;
+        const double ca = std::cos(-u * a), sa = std::sin(-u * a);   // Phase at y = 0
+        double chi, psi;
+        if (k == 0) {
+            chi = 1.0 - ea;
+            psi = -a;
+        }
+        else {
+            chi = (ca - ea + u * sa) / (1.0 + u * u);
+            psi = sa / u;
+        }
+        const double vk = 2.0 / width * (psi - chi);
+        buf.coef[k] = characteristic(p, rate, T, u) * std::complex<double>(ca, sa) * vk;
+    }
+    buf.coef[0] *= 0.5;
+
+    const double df = std::exp(-rate * T);
+    for (size_t i = 0; i < n; ++i) {
+        const double theta = kPi * buf.logMoneyness[i] / width;
+        const std::complex<double> step(std::cos(theta), std::sin(theta));
+        std::complex<double> phase(1.0, 0.0), sum(0.0, 0.0);
+        for (size_t k = 0; k < nTerms; ++k) {
+            sum += buf.coef[k] * phase;
+            phase *= step;
+        }
+        const double K = strikes[i];
+        const double put = std::max(K * df * sum.real(), std::max(K * df - spot, 0.0));
+        out[i] = types[i] == OptionType::Put ? put : put + spot - K * df;
+    }
+    return out;
+}
+
+double HestonPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    auto opt = std::dynamic_pointer_cast<EuropeanOption>(trade);
+    if (!opt)
+        throw std::runtime_error("Heston pricer only supports EuropeanOption");
+    return priceBatch(mkt, { trade }).front();
+}
+
+std::vector<double> HestonPricer::priceBatch(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades) const {
+    // (underlying, curve, expiry serial) -> trade indices
+    std::map<std::tuple<std::string, std::string, long>, std::vector<size_t>> chains;
+    for (size_t i = 0; i < trades.size(); ++i) {
+        auto opt = std::dynamic_pointer_cast<EuropeanOption>(trades[i]);
+        if (!opt)
+            throw std::runtime_error("Heston pricer only supports EuropeanOption");
+        chains[{ opt->getUnderlying(), opt->getRateCurve(), opt->getExpiry().getSerialDate() }].push_back(i);
+    }
+
+    std::vector<double> results(trades.size(), 0.0);
+    std::vector<double> strikes;
+    std::vector<OptionType> types;
+    for (const auto& [key, idx] : chains) {
+        const Trade& first = *trades[idx.front()];
+        const double S = mkt.getStockPrice(first.getUnderlying());
+        const double T = first.getExpiry() - mkt.asOf;   // ACT/365, as BlackScholesPricer
+        const double r = mkt.getCurve(first.getRateCurve())->getRate(first.getExpiry());
+
+        strikes.clear();
+        types.clear();
+        for (size_t i : idx) {
+            strikes.push_back(trades[i]->getStrike());
+            types.push_back(trades[i]->getOptionType());
+        }
+        const std::vector<double> unit = priceChain(getParams(first.getUnderlying()), S, r, T, strikes, types);
+        for (size_t j = 0; j < idx.size(); ++j) {
+            const Trade& t = *trades[idx[j]];
+            results[idx[j]] = (t.isLong() ? 1.0 : -1.0) * t.getNotional() * unit[j];
+        }
+    }
+    return results;
+}
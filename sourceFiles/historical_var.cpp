@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "historical_var.h"
+#include "chebyshev_proxy.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+using util::dateAddTenor;
+using util::split;
+using util::to_upper;
+
+// ========================
+// HistoricalScenario
+// ========================
+Market HistoricalScenario::apply(const Market& base) const
+{
+    Market mkt = base.overlay();
+
+    // Clone each moved curve once, however many of its pillars move
+    map<string, shared_ptr<RateCurve>> curves;
+    for (const auto& mv : curveMoves) {
+        auto& curve = curves[mv.name];
+        if (!curve) curve = make_shared<RateCurve>(*base.getCurve(mv.name));
+        if (mv.tenor.empty()) curve->shock(mv.move);
+        else curve->shock(dateAddTenor(base.asOf, mv.tenor), mv.move);
+    }
+    for (const auto& [name, curve] : curves)
+        mkt.addCurve(name, curve);
+
+    map<string, shared_ptr<VolCurve>> vols;
+    for (const auto& mv : volMoves) {
+        auto& vol = vols[mv.name];
+        if (!vol) vol = make_shared<VolCurve>(*base.getVolCurve(mv.name));
+        if (mv.tenor.empty()) vol->shock(mv.move);
+        else vol->shock(dateAddTenor(base.asOf, mv.tenor), mv.move);
+    }
+    for (const auto& [name, vol] : vols)
+        mkt.addVolCurve(name, vol);
+
+    for (const auto& mv : spotMoves)
+        mkt.shockPrice(mv.name, mv.move);
+
+    return mkt;
+}
+
+HistoricalScenario HistoricalScenario::inverse() const
+{
+    HistoricalScenario undo = *this;
+    for (auto& mv : undo.curveMoves) mv.move = -mv.move;
+    for (auto& mv : undo.volMoves) mv.move = -mv.move;
+    for (auto& mv : undo.spotMoves) mv.move = 1.0 / (1.0 + mv.move) - 1.0;
+    return undo;
+}
+
+vector<HistoricalScenario> loadHistoricalScenarios(const string& filename)
+{
+    string header;
+    vector<string> lines;
+    util::readFromFile(filename, header, lines);
+
+    vector<HistoricalScenario> scenarios;
+    if (header.empty()) {
+        cerr << "[WARN] No historical scenarios loaded from: " << filename << endl;
+        return scenarios;
+    }
+
+    // Column layout: kind (0 curve, 1 vol, 2 spot), factor name and tenor
+    struct Column { int kind; string name; string tenor; };
+    vector<Column> columns;
+    auto headerTokens = split(header, ";");
+    for (size_t c = 1; c < headerTokens.size(); ++c) {
+        auto parts = split(headerTokens[c], ":");
+        string kind = to_upper(parts[0]);
+        Column col{ -1, parts.size() > 1 ? to_upper(parts[1]) : "", parts.size() > 2 ? to_upper(parts[2]) : "" };
+        if (kind == "CURVE") col.kind = 0;
+        else if (kind == "VOL") col.kind = 1;
+        else if (kind == "SPOT") col.kind = 2;
+        else cerr << "[WARN] Unknown scenario factor column: " << headerTokens[c] << endl;
+        columns.push_back(col);
+    }
+
+    for (const auto& line : lines) {
+        if (line.empty()) continue;
+        auto t = split(line, ";");
+        if (t.size() != headerTokens.size()) {
+            cerr << "[WARN] Skipping malformed scenario line: " << line << endl;
+            continue;
+        }
+
+        try {
+            HistoricalScenario sc;
+            sc.date = util::parseDate(t[0]);
+            for (size_t c = 0; c < columns.size(); ++c) {
+                if (t[c + 1].empty()) continue;
+                FactorMove mv{ columns[c].name, columns[c].tenor, stod(t[c + 1]) };
+                if (mv.move == 0.0) continue;
+                if (columns[c].kind == 0) sc.curveMoves.push_back(mv);
+                else if (columns[c].kind == 1) sc.volMoves.push_back(mv);
+                else if (columns[c].kind == 2) sc.spotMoves.push_back(mv);
+            }
+            scenarios.push_back(move(sc));
+        }
+        catch (const exception& e) {
+            cerr << "[ERROR] Parsing scenario failed: " << line << " => " << e.what() << endl;
+        }
+    }
+
+    return scenarios;
+}
+
+// ========================
+// PnlCube
+// ========================
+PnlCube::PnlCube(size_t trades, size_t scens)
+    : nTrades(trades), nScenarios(scens), data(trades * scens, 0.0) {
+}
+
+map<string, vector<double>> PnlCube::reduce(const function<string(size_t)>& keyOf) const
+{
+    // Trade indices per key, in trade order
+    map<string, vector<size_t>> members;
+    for (size_t t = 0; t < nTrades; ++t)
+        members[keyOf(t)].push_back(t);
+
+    map<string, vector<double>> out;
+    vector<double> buffer;
+    for (const auto& [key, idx] : members) {
+        vector<double>& pnl = out[key];
+        pnl.resize(nScenarios);
+        buffer.resize(idx.size());
+        for (size_t s = 0; s < nScenarios; ++s) {
+            const double* row = &data[s * nTrades];
+            for (size_t k = 0; k < idx.size(); ++k)
+                buffer[k] = row[idx[k]];
+            pnl[s] = util::pairwiseSum(buffer);
+        }
+    }
+    return out;
+}
+
+vector<double> PnlCube::portfolioPnl() const
+{
+    vector<double> pnl(nScenarios);
+    for (size_t s = 0; s < nScenarios; ++s)
+        pnl[s] = util::pairwiseSum(&data[s * nTrades], nTrades);
+    return pnl;
+}
+
+// ========================
+// VaR / ES
+// ========================
+VarResult computeVaR(const vector<double>& pnl, double confidence)
+{
+    VarResult res;
+    if (pnl.empty()) return res;
+    if (confidence <= 0.0 || confidence >= 1.0)
+        throw invalid_argument("VaR confidence must be in (0, 1).");
+
+    vector<double> sorted(pnl);
+    sort(sorted.begin(), sorted.end());
+
+    // Number of tail observations at or beyond the quantile
+    size_t k = static_cast<size_t>(ceil((1.0 - confidence) * sorted.size() - 1e-9));
+    k = max<size_t>(1, min(k, sorted.size()));
+
+    res.VaR = -sorted[k - 1];
+    res.ES = -util::pairwiseSum(sorted.data(), k) / static_cast<double>(k);
+    return res;
+}
+
+// ========================
+// HistoricalVarEngine
+// ========================
+HistoricalVarEngine::HistoricalVarEngine(const Market& base,
+    const vector<shared_ptr<Trade>>& portfolio,
+    shared_ptr<const DiscountTable> table,
+    ThreadPool& threadPool)
+    : baseMarket(base), trades(portfolio), pool(threadPool), dfTable(move(table))
+{
+    if (!dfTable)
+        dfTable = DiscountTable::build(trades);
+    dfTable->evaluate(baseMarket, baseDfs);
+}
+
+void HistoricalVarEngine::setScenarios(vector<HistoricalScenario> scens)
+{
+    scenarios = move(scens);
+}
+
+void HistoricalVarEngine::loadScenarios(const string& filename)
+{
+    setScenarios(loadHistoricalScenarios(filename));
+}
+
+double HistoricalVarEngine::revalue(size_t i, const Market& mkt, const vector<double>& dfs,
+    const BinomialTreePricer& pricer) const
+{
+    const auto& trade = trades[i];
+    if (trade->usesDiscountTable())
+        return trade->pvFromTable(dfs, mkt);
+    if (proxy && proxy->covers(*trade))
+        return proxy->price(mkt, trade);
+    return pricer.price(mkt, trade);
+}
+
+double HistoricalVarEngine::revalue(size_t i, const Market& mkt, const vector<double>& dfs) const
+{
+    CRRBinomialTreePricer pricer(50);
+    return revalue(i, mkt, dfs, pricer);
+}
+
+void HistoricalVarEngine::revalueAll(const vector<size_t>& todo, const Market& mkt, const vector<double>& dfs,
+    vector<double>& pv) const
+{
+    pv.assign(todo.size(), 0.0);
+    vector<shared_ptr<Trade>> batch;
+    vector<size_t> batchSlots, others;
+    for (size_t k = 0; k < todo.size(); ++k) {
+        if (ExoticBatchPricer::batches(*trades[todo[k]])) {
+            batch.push_back(trades[todo[k]]);
+            batchSlots.push_back(k);
+        }
+        else {
+            others.push_back(k);
+        }
+    }
+
+    if (!batch.empty()) {
+        const vector<double> batchPv = exoticPricer.price(mkt, batch);
+        for (size_t j = 0; j < batchSlots.size(); ++j) pv[batchSlots[j]] = batchPv[j];
+    }
+    pool.parallel_for_range(0, others.size(), tradeChunk, [&](size_t lo, size_t hi) {
+        CRRBinomialTreePricer pricer(50);
+        for (size_t j = lo; j < hi; ++j)
+            pv[others[j]] = revalue(todo[others[j]], mkt, dfs, pricer);
+    });
+}
+
+void HistoricalVarEngine::prepareProxy(const vector<HistoricalScenario>& scenarioSet) const
+{
+    if (!proxy) return;
+    proxy->fitEnvelope(baseMarket, scenarioSet.size(), [&](size_t s) { return scenarioSet[s].apply(baseMarket); });
+}
+
+const PnlCube& HistoricalVarEngine::run()
+{
+    size_t nTrades = trades.size();
+    size_t nScen = scenarios.size();
+    prepareProxy(scenarios);
+
+    vector<size_t> all(nTrades);
+    for (size_t t = 0; t < nTrades; ++t) all[t] = t;
+    revalueAll(all, baseMarket, baseDfs, basePv);
+
+    cube = PnlCube(nTrades, nScen);
+    pool.parallel_for(0, nScen, 1, [&](size_t s) {
+        // One overlay and one discount table evaluation per scenario, shared by all trades
+        Market mkt = scenarios[s].apply(baseMarket);
+        vector<double> dfs;
+        dfTable->evaluate(mkt, dfs);
+
+        vector<double> pv;
+        revalueAll(all, mkt, dfs, pv);
+        for (size_t t = 0; t < nTrades; ++t)
+            cube.at(t, s) = pv[t] - basePv[t];
+    });
+
+    return cube;
+}
+
+VarResult HistoricalVarEngine::portfolioVaR(double confidence) const
+{
+    return computeVaR(cube.portfolioPnl(), confidence);
+}
+
+map<string, VarResult> HistoricalVarEngine::varBy(AggregateBy level, double confidence) const
+{
+    map<string, VarResult> out;
+    auto pnlByKey = cube.reduce([&](size_t t) { return aggregateKey(*trades[t], level); });
+    for (const auto& [key, pnl] : pnlByKey)
+        out.emplace(key, computeVaR(pnl, confidence));
+    return out;
+}
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "hull_white_pricer.h"
+
+namespace {
+
+    // Per-thread induction buffers and per-step event arrays, reused across trades and calls
+    struct InductionScratch {
+        std::vector<double> cur, next;
+        std::vector<double> flowA, flowB, exercise;
+        std::vector<char> isExercise;
+
+        void reset(size_t steps, size_t nodes) {
+            cur.resize(nodes);
+            next.resize(nodes);
+            flowA.assign(steps + 1, 0.0);
+            flowB.assign(steps + 1, 0.0);
+            exercise.assign(steps + 1, 0.0);
+            isExercise.assign(steps + 1, 0);
+        }
+    };
+    thread_local InductionScratch scratch;
+}
+
+// ===========================
+// Constructor
+// ===========================
+HullWhitePricer::HullWhitePricer(const HullWhiteParams& p, HullWhiteLatticeCache& latticeCache, ThreadPool& threadPool)
+    : params(p), cache(latticeCache), pool(threadPool) {
+}
+
+const HullWhitePricer& HullWhitePricer::global() {
+    static const HullWhitePricer pricer;
+    return pricer;
+}
+
+// ===========================
+// Pricing
+// ===========================
+Date HullWhitePricer::lastEventDate(const Trade& trade) {
+    if (auto berm = dynamic_cast<const BermudanSwaption*>(&trade))
+        return berm->getSwapEnd();
+    if (dynamic_cast<const Bond*>(&trade))
+        return trade.getExpiry();
+    throw std::runtime_error("Hull-White pricer does not support " + trade.getType());
+}
+
+void HullWhitePricer::eventDates(const Trade& trade, std::vector<Date>& dates) {
+    if (auto berm = dynamic_cast<const BermudanSwaption*>(&trade)) {
+        const auto& s = berm->getSwap().getSchedule();
+        dates.insert(dates.end(), s.begin(), s.end());
+    }
+    else if (auto bond = dynamic_cast<const Bond*>(&trade)) {
+        const auto& s = bond->getSchedule();
+        dates.insert(dates.end(), s.begin(), s.end());
+        dates.insert(dates.end(), bond->getCallDates().begin(), bond->getCallDates().end());
+    }
+}
+
+double HullWhitePricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    if (!trade) throw std::invalid_argument("Null trade pointer");
+
+    size_t steps = HullWhiteTree::stepsToCover(mkt.asOf, lastEventDate(*trade), params.stepDays);
+    auto tree = cache.get(mkt, trade->getRateCurve(), params, steps);
+    auto curve = mkt.getCurve(trade->getRateCurve());
+    return priceOnTree(mkt.asOf, *tree, *trade, [&curve](const Date& d) { return curve->getDf(d); });
+}
+
+std::vector<double> HullWhitePricer::priceBatch(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades) const {
+    // Longest horizon per curve, then one lattice per curve
+    std::map<std::string, size_t> horizon;
+    for (const auto& t : trades) {
+        size_t steps = HullWhiteTree::stepsToCover(mkt.asOf, lastEventDate(*t), params.stepDays);
+        size_t& h = horizon[t->getRateCurve()];
+        h = std::max(h, steps);
+    }
+    std::map<std::string, std::shared_ptr<const HullWhiteTree>> trees;
+    for (const auto& [curve, steps] : horizon)
+        trees[curve] = cache.get(mkt, curve, params, steps);
+
+    // Each distinct (curve, date) discounted once; trades then only look it up
+    std::map<std::string, std::unordered_map<long, double>> dfs;
+    std::vector<Date> dates;
+    for (const auto& t : trades) {
+        auto curve = mkt.getCurve(t->getRateCurve());
+        auto& byDate = dfs[t->getRateCurve()];
+        dates.clear();
+        eventDates(*t, dates);
+        for (const auto& d : dates) {
+            long serial = d.getSerialDate();
+            if (byDate.find(serial) == byDate.end())
+                byDate.emplace(serial, curve->getDf(d));
+        }
+    }
+
+    std::vector<double> results(trades.size(), 0.0);
+    pool.parallel_for(0, trades.size(), 8, [&](size_t i) {
+        const auto& byDate = dfs.at(trades[i]->getRateCurve());
+        results[i] = priceOnTree(mkt.asOf, *trees.at(trades[i]->getRateCurve()), *trades[i],
+            [&byDate](const Date& d) { return byDate.at(d.getSerialDate()); });
+    });
+    return results;
+}
+
+double HullWhitePricer::priceOnTree(const Date& asOf, const HullWhiteTree& tree, const Trade& trade, const DfLookup& df) const {
+    if (auto berm = dynamic_cast<const BermudanSwaption*>(&trade))
+        return bermudan(asOf, tree, *berm, df);
+    if (auto bond = dynamic_cast<const Bond*>(&trade))
+        return callableBond(asOf, tree, *bond, df);
+    throw std::runtime_error("Hull-White pricer does not support " + trade.getType());
+}
+
+// ===========================
+// Bermudan Swaption
+// ===========================
+// Three payoffs rolled back together, per unit notional: ZB (the swap end notional),
+// ANN (fixed coupons) and OPT. At an exercise step the swap starting there is worth
+// w * (float notional at the reset - ZB - K * ANN), w = +1 payer, -1 receiver.
+double HullWhitePricer::bermudan(const Date& asOf, const HullWhiteTree& tree, const BermudanSwaption& trade, const DfLookup& df) const {
+    const Swap& swap = trade.getSwap();
+    const auto& schedule = swap.getSchedule();
+    if (schedule.back() < asOf) return 0.0;
+
+    const size_t M = tree.stepOf(schedule.back());
+    if (M > tree.steps())
+        throw std::runtime_error("Hull-White lattice does not cover " + trade.getType());
+
+    InductionScratch& buf = scratch;
+    buf.reset(M, tree.maxWidth() * 3);
+
+    // flowA: fixed coupons, flowB: end notional, exercise: float notional at the reset
+    for (size_t i = 1; i < schedule.size(); ++i) {
+        if (schedule[i] < asOf) continue;
+        const size_t m = tree.stepOf(schedule[i]);
+        const double c = df(schedule[i]) / tree.zeroPrice(m);
+        buf.flowA[m] += swap.getAccrual(i) * c;
+        if (i + 1 == schedule.size()) buf.flowB[m] += c;
+    }
+    bool anyExercise = false;
+    for (const auto& d : trade.getExerciseDates()) {
+        if (d < asOf) continue;
+        const size_t m = tree.stepOf(d);
+        if (buf.isExercise[m]) continue;    // Keep the earliest date snapped to a step
+        buf.isExercise[m] = 1;
+        buf.exercise[m] = df(d) / tree.zeroPrice(m);
+        anyExercise = true;
+    }
+    if (!anyExercise) return 0.0;
+
+    const double w = trade.isPayer() ? 1.0 : -1.0;
+    const double K = trade.getStrike();
+
+    std::fill(buf.cur.begin(), buf.cur.begin() + tree.width(M) * 3, 0.0);
+    for (size_t m = M + 1; m-- > 0;) {
+        double* v = buf.cur.data();
+        const size_t nodes = tree.width(m);
+        if (buf.isExercise[m]) {
+            const double fl = buf.exercise[m];
+            for (size_t j = 0; j < nodes; ++j) {
+                double* row = v + 3 * j;
+                row[2] = std::max(row[2], w * (fl - row[0] - K * row[1]));
+            }
+        }
+        if (buf.flowA[m] != 0.0 || buf.flowB[m] != 0.0) {
+            for (size_t j = 0; j < nodes; ++j) {
+                v[3 * j] += buf.flowB[m];
+                v[3 * j + 1] += buf.flowA[m];
+            }
+        }
+        if (m > 0) {
+            tree.rollback(m - 1, buf.cur.data(), buf.next.data(), 3);
+            buf.cur.swap(buf.next);
+        }
+    }
+
+    const double sign = trade.isLong() ? 1.0 : -1.0;
+    return sign * swap.getNotional() * buf.cur[2];
+}
+
+// ===========================
+// Callable Bond
+// ===========================
+// Holder's value per unit notional; on a call date the issuer redeems at the call price
+// whenever that is cheaper than keeping the bond alive.
+double HullWhitePricer::callableBond(const Date& asOf, const HullWhiteTree& tree, const Bond& bond, const DfLookup& df) const {
+    const auto& schedule = bond.getSchedule();
+    if (schedule.back() < asOf) return 0.0;
+
+    const size_t M = tree.stepOf(schedule.back());
+    if (M > tree.steps())
+        throw std::runtime_error("Hull-White lattice does not cover " + bond.getType());
+
+    InductionScratch& buf = scratch;
+    buf.reset(M, tree.maxWidth());
+
+    // Same cashflows as Bond::pv: coupons from today on plus the principal
+    for (size_t i = 1; i < schedule.size(); ++i) {
+        if (schedule[i] < asOf) continue;
+        const size_t m = tree.stepOf(schedule[i]);
+        buf.flowA[m] += bond.getCouponRate() * bond.getAccrual(i) * df(schedule[i]) / tree.zeroPrice(m);
+    }
+    const size_t mEnd = tree.stepOf(bond.getExpiry());
+    buf.flowA[mEnd] += df(bond.getExpiry()) / tree.zeroPrice(mEnd);
+
+    for (const auto& d : bond.getCallDates()) {
+        if (d < asOf) continue;
+        const size_t m = tree.stepOf(d);
+        if (buf.isExercise[m]) continue;
+        buf.isExercise[m] = 1;
+        buf.exercise[m] = bond.getCallPrice() * df(d) / tree.zeroPrice(m);
+    }
+
+    std::fill(buf.cur.begin(), buf.cur.begin() + tree.width(M), 0.0);
+    for (size_t m = M + 1; m-- > 0;) {
+        double* v = buf.cur.data();
+        const size_t nodes = tree.width(m);
+        if (buf.isExercise[m]) {
+            const double call = buf.exercise[m];
+            for (size_t j = 0; j < nodes; ++j) v[j] = std::min(v[j], call);
+        }
+        if (buf.flowA[m] != 0.0) {
+            for (size_t j = 0; j < nodes; ++j) v[j] += buf.flowA[m];
+        }
+        if (m > 0) {
+            tree.rollback(m - 1, buf.cur.data(), buf.next.data(), 1);
+            buf.cur.swap(buf.next);
+        }
+    }
+
+    const double sign = bond.isLong() ? 1.0 : -1.0;
+    return sign * bond.getNotional() * buf.cur[0];
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "hull_white_tree.h"
+#include "market.h"
+#include "helper.h"
+
+using namespace std;
+
+// ===========================
+// HullWhiteTree
+// ===========================
+HullWhiteTree::HullWhiteTree(const RateCurve& curve, const Date& valueDate, size_t steps, const HullWhiteParams& p)
+    : asOf(valueDate), asOfSerial(valueDate.getSerialDate()), params(p), nSteps(steps) {
+    if (nSteps == 0)
+        throw invalid_argument("Hull-White tree needs at least one step");
+    if (params.stepDays <= 0 || params.volatility <= 0.0 || params.meanReversion < 0.0)
+        throw invalid_argument("Hull-White tree needs positive step, vol and non-negative mean reversion");
+
+    stepDt = params.stepDays / 365.0;   // ACT/365, as Date::operator-
+    dx = params.volatility * sqrt(3.0 * stepDt);
+    const double M = exp(-params.meanReversion * stepDt) - 1.0;
+
+    // Without mean reversion the tree never needs edge branching
+    jmax = nSteps;
+    if (M < 0.0)
+        jmax = min(nSteps, static_cast<size_t>(ceil(0.184 / -M)));
+    jmax = max<size_t>(jmax, 1);
+
+    branches.resize(2 * jmax + 1);
+    for (long j = -static_cast<long>(jmax); j <= static_cast<long>(jmax); ++j) {
+        const double jm = j * M, jm2 = jm * jm;
+        Branch& b = branches[j + jmax];
+        if (j == static_cast<long>(jmax) && jmax < nSteps) {
+            b = { j - 1, 7.0 / 6.0 + 0.5 * (jm2 + 3.0 * jm), -1.0 / 3.0 - jm2 - 2.0 * jm, 1.0 / 6.0 + 0.5 * (jm2 + jm) };
+        }
+        else if (j == -static_cast<long>(jmax) && jmax < nSteps) {
+            b = { j + 1, 1.0 / 6.0 + 0.5 * (jm2 - jm), -1.0 / 3.0 - jm2 + 2.0 * jm, 7.0 / 6.0 + 0.5 * (jm2 - 3.0 * jm) };
+        }
+        else {
+            b = { j, 1.0 / 6.0 + 0.5 * (jm2 + jm), 2.0 / 3.0 - jm2, 1.0 / 6.0 + 0.5 * (jm2 - jm) };
+        }
+    }
+
+    zero.resize(nSteps + 1);
+    for (size_t m = 0; m <= nSteps; ++m)
+        zero[m] = curve.getDf(asOf.addDays(static_cast<int>(m) * params.stepDays));
+
+    discOffset.resize(nSteps + 1);
+    size_t total = 0;
+    for (size_t m = 0; m <= nSteps; ++m) {
+        discOffset[m] = total;
+        total += width(m);
+    }
+    disc.resize(total);
+    alpha.resize(nSteps);
+
+    // Forward induction on Arrow-Debreu prices
+    vector<double> q(1, 1.0), qNext;
+    for (size_t m = 0; m < nSteps; ++m) {
+        const long J = static_cast<long>(halfWidth(m));
+        const long Jn = static_cast<long>(halfWidth(m + 1));
+
+        double sum = 0.0;
+        for (long j = -J; j <= J; ++j)
+            sum += q[j + J] * exp(-j * dx * stepDt);
+        alpha[m] = (log(sum) - log(zero[m + 1])) / stepDt;
+
+        qNext.assign(2 * Jn + 1, 0.0);
+        double* d = disc.data() + discOffset[m];
+        for (long j = -J; j <= J; ++j) {
+            d[j + J] = exp(-(alpha[m] + j * dx) * stepDt);
+            const Branch& b = branches[j + jmax];
+            const double w = q[j + J] * d[j + J];
+            qNext[b.center + 1 + Jn] += w * b.pu;
+            qNext[b.center + Jn] += w * b.pm;
+            qNext[b.center - 1 + Jn] += w * b.pd;
+        }
+        q.swap(qNext);
+    }
+}
+
+size_t HullWhiteTree::stepsToCover(const Date& valueDate, const Date& last, int stepDays) {
+    if (last <= valueDate) return 1;
+    const long days = last.getSerialDate() - valueDate.getSerialDate();
+    return static_cast<size_t>((days + stepDays - 1) / stepDays) + 1;
+}
+
+size_t HullWhiteTree::stepOf(const Date& date) const {
+    if (date <= asOf) return 0;
+    const long m = lround(static_cast<double>(date.getSerialDate() - asOfSerial) / params.stepDays);
+    return min(static_cast<size_t>(m), nSteps + 1);
+}
+
+double HullWhiteTree::shortRate(size_t m, long j) const {
+    return alpha[m] + j * dx;
+}
+
+void HullWhiteTree::rollback(size_t m, const double* next, double* out, size_t w) const {
+    const long J = static_cast<long>(halfWidth(m));
+    const long Jn = static_cast<long>(halfWidth(m + 1));
+    const double* d = disc.data() + discOffset[m];
+
+    for (long j = -J; j <= J; ++j) {
+        const Branch& b = branches[j + jmax];
+        const double df = d[j + J];
+        const double* up = next + (b.center + 1 + Jn) * w;
+        const double* mid = next + (b.center + Jn) * w;
+        const double* dn = next + (b.center - 1 + Jn) * w;
+        double* row = out + (j + J) * w;
+        for (size_t k = 0; k < w; ++k)
+            row[k] = df * (b.pu * up[k] + b.pm * mid[k] + b.pd * dn[k]);
+    }
+}
+
+// ===========================
+// HullWhiteLatticeCache
+// ===========================
+shared_ptr<const HullWhiteTree> HullWhiteLatticeCache::get(const Market& mkt, const string& curveName,
+    const HullWhiteParams& params, size_t steps) {
+    auto curve = mkt.getCurve(curveName);
+    const uint64_t hash = curve->fingerprint();
+    Key key{ util::to_upper(curveName), mkt.asOf.getSerialDate(), params.meanReversion, params.volatility, params.stepDays };
+
+    {
+        lock_guard<mutex> lock(mtx);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.curveHash == hash && it->second.tree->steps() >= steps)
+            return it->second.tree;
+    }
+
+    // Calibrate outside the lock; cover at least whole years so nearby maturities share it
+    const size_t perYear = static_cast<size_t>(ceil(365.0 / params.stepDays));
+    const size_t covered = ((steps + perYear - 1) / perYear) * perYear;
+    auto tree = make_shared<const HullWhiteTree>(*curve, mkt.asOf, covered, params);
+
+    lock_guard<mutex> lock(mtx);
+    ++buildCount;
+    auto it = entries.find(key);
+    if (it != entries.end() && it->second.curveHash == hash && it->second.tree->steps() >= steps)
+        return it->second.tree;      // Another thread got there first
+    if (it == entries.end() && entries.size() >= kMaxEntries)
+        entries.clear();
+    entries[key] = Entry{ hash, tree };
+    return tree;
+}
+
+size_t HullWhiteLatticeCache::size() const {
+    lock_guard<mutex> lock(mtx);
+    return entries.size();
+}
+
+size_t HullWhiteLatticeCache::builds() const {
+    lock_guard<mutex> lock(mtx);
+    return buildCount;
+}
+
+void HullWhiteLatticeCache::clear() {
+    lock_guard<mutex> lock(mtx);
+    entries.clear();
+}
+
+HullWhiteLatticeCache& HullWhiteLatticeCache::global() {
+    static HullWhiteLatticeCache cache;
+    return cache;
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "implied_vol_surface.h"
+#include "helper.h"
+
+using namespace std;
+
+// ===== Constructors =====
+
+ImpliedVolSurface::ImpliedVolSurface() = default;
+
+ImpliedVolSurface::ImpliedVolSurface(const string& _name)
+    : name(_name) {
+}
+
+// ===== Construction =====
+
+void ImpliedVolSurface::setMoneyness(const vector<double>& moneyness) {
+    if (moneyness.empty())
+        throw invalid_argument("Implied vol surface needs at least one moneyness node.");
+    if (!is_sorted(moneyness.begin(), moneyness.end()) ||
+        adjacent_find(moneyness.begin(), moneyness.end()) != moneyness.end() || moneyness.front() <= 0.0)
+        throw invalid_argument("Implied vol surface moneyness must be positive and strictly increasing.");
+    if (!smiles.empty() && moneyness.size() != logMoneyness.size())
+        throw invalid_argument("Cannot change the number of moneyness nodes once smiles are loaded.");
+
+    logMoneyness.resize(moneyness.size());
+    for (size_t j = 0; j < moneyness.size(); ++j)
+        logMoneyness[j] = log(moneyness[j]);
+    rebuild();
+}
+
+void ImpliedVolSurface::addSmile(double expiry, const vector<double>& smileVols) {
+    if (logMoneyness.empty())
+        throw runtime_error("Implied vol surface " + name + ": set moneyness before adding smiles.");
+    if (smileVols.size() != logMoneyness.size())
+        throw invalid_argument("Implied vol surface " + name + ": smile size does not match moneyness.");
+    if (expiry <= 0.0)
+        throw invalid_argument("Implied vol surface " + name + ": expiry must be positive.");
+    for (double v : smileVols) {
+        if (!(v > 0.0))
+            throw invalid_argument("Implied vol surface " + name + ": vols must be positive.");
+    }
+
+    smiles[expiry] = smileVols;
+    rebuild();
+}
+
+void ImpliedVolSurface::rebuild() {
+    const size_t n = logMoneyness.size();
+    expiries.clear();
+    w.clear();
+    w2.clear();
+    if (n == 0) return;
+
+    for (const auto& [T, vols] : smiles) {
+        expiries.push_back(T);
+        const size_t e = expiries.size() - 1;
+        for (size_t j = 0; j < n; ++j) {
+            double v = vols[j] * vols[j] * T;
+            if (e > 0) {
+                const double prev = w[(e - 1) * n + j];
+                if (v < prev) {
+                    cerr << "[WARN] Implied vol surface " << name << ": total variance falls at T=" << T
+                        << ", node " << j << "; floored to the previous expiry" << endl;
+                    v = prev;
+                }
+            }
+            w.push_back(v);
+        }
+    }
+
+    // Natural cubic spline second derivatives per slice (Thomas algorithm)
+    w2.assign(w.size(), 0.0);
+    if (n < 3) return;
+    vector<double> c(n), d(n);
+    for (size_t e = 0; e < expiries.size(); ++e) {
+        const double* we = w.data() + e * n;
+        double* m = w2.data() + e * n;
+        c[0] = 0.0;
+        d[0] = 0.0;
+        for (size_t j = 1; j + 1 < n; ++j) {
+            const double h0 = logMoneyness[j] - logMoneyness[j - 1];
+            const double h1 = logMoneyness[j + 1] - logMoneyness[j];
+            const double rhs = 6.0 * ((we[j + 1] - we[j]) / h1 - (we[j] - we[j - 1]) / h0);
+            const double denom = 2.0 * (h0 + h1) - h0 * c[j - 1];
+            c[j] = h1 / denom;
+            d[j] = (rhs - h0 * d[j - 1]) / denom;
+        }
+        for (size_t j = n - 1; j-- > 1;)
+            m[j] = d[j] - c[j] * m[j + 1];
+    }
+}
+
+// ===== Lookup =====
+
+double ImpliedVolSurface::slice(size_t e, double y, double* d1, double* d2) const {
+    const size_t n = logMoneyness.size();
+    const double* we = w.data() + e * n;
+    const double* m = w2.data() + e * n;
+
+    // Flat vol beyond the outer nodes
+    if (n == 1 || y <= logMoneyness.front() || y >= logMoneyness.back()) {
+        if (d1) *d1 = 0.0;
+        if (d2) *d2 = 0.0;
+        return n == 1 || y <= logMoneyness.front() ? we[0] : we[n - 1];
+    }
+
+    const size_t j = static_cast<size_t>(upper_bound(logMoneyness.begin(), logMoneyness.end(), y) - logMoneyness.begin()) - 1;
+    const double h = logMoneyness[j + 1] - logMoneyness[j];
+    const double A = (logMoneyness[j + 1] - y) / h, B = 1.0 - A;
+    if (d1) *d1 = (we[j + 1] - we[j]) / h - (3.0 * A * A - 1.0) / 6.0 * h * m[j] + (3.0 * B * B - 1.0) / 6.0 * h * m[j + 1];
+    if (d2) *d2 = A * m[j] + B * m[j + 1];
+    return A * we[j] + B * we[j + 1] + ((A * A * A - A) * m[j] + (B * B * B - B) * m[j + 1]) * h * h / 6.0;
+}
+
+double ImpliedVolSurface::totalVariance(double T, double y, double* dwdT, double* dwdy, double* d2wdy2) const {
+    if (expiries.empty())
+        throw runtime_error("Implied vol surface " + name + " has no smiles.");
+    T = max(T, 0.0);
+
+    double a1, a2, b1, b2;
+    // Flat vol in time outside the quoted expiries: w scales with T
+    if (T <= expiries.front() || T >= expiries.back() || expiries.size() == 1) {
+        const size_t e = T <= expiries.front() ? 0 : expiries.size() - 1;
+        const double scale = T / expiries[e];
+        const double we = slice(e, y, &a1, &a2);
+        if (dwdT) *dwdT = we / expiries[e];
+        if (dwdy) *dwdy = scale * a1;
+        if (d2wdy2) *d2wdy2 = scale * a2;
+        return scale * we;
+    }
+
+    const size_t e = static_cast<size_t>(upper_bound(expiries.begin(), expiries.end(), T) - expiries.begin()) - 1;
+    const double dT = expiries[e + 1] - expiries[e];
+    const double lam = (T - expiries[e]) / dT;
+    const double w0 = slice(e, y, &a1, &a2);
+    const double w1 = slice(e + 1, y, &b1, &b2);
+    if (dwdT) *dwdT = (w1 - w0) / dT;
+    if (dwdy) *dwdy = (1.0 - lam) * a1 + lam * b1;
+    if (d2wdy2) *d2wdy2 = (1.0 - lam) * a2 + lam * b2;
+    return (1.0 - lam) * w0 + lam * w1;
+}
+
+double ImpliedVolSurface::getVol(double expiry, double strike, double forward) const {
+    if (strike <= 0.0 || forward <= 0.0)
+        throw invalid_argument("Implied vol surface " + name + ": strike and forward must be positive.");
+    expiry = max(expiry, 1.0 / 365.0);   // Expired options read the one-day vol
+    return sqrt(totalVariance(expiry, log(strike / forward)) / expiry);
+}
+
+// ===== Shocks =====
+
+void ImpliedVolSurface::shock(double delta) {
+    for (auto& [_, vols] : smiles)
+        for (auto& v : vols) v = max(v + delta, 1e-6);
+    rebuild();
+}
+
+void ImpliedVolSurface::scale(double factor) {
+    for (auto& [_, vols] : smiles)
+        for (auto& v : vols) v = max(v * factor, 1e-6);
+    rebuild();
+}
+
+uint64_t ImpliedVolSurface::fingerprint() const {
+    uint64_t h = util::hashBytes(util::kHashSeed, logMoneyness.data(), logMoneyness.size() * sizeof(double));
+    for (const auto& [T, vols] : smiles) {
+        h = util::hashMix(h, T);
+        h = util::hashBytes(h, vols.data(), vols.size() * sizeof(double));
+    }
+    return h;
+}
+
+// ===== Display =====
+
+void ImpliedVolSurface::display() const {
+    cout << "ImpliedVolSurface: " << name << " (" << expiries.size() << " expiries x "
+        << logMoneyness.size() << " moneyness)" << endl;
+    for (const auto& [T, vols] : smiles) {
+        cout << "  " << T << ":";
+        for (double v : vols) cout << " " << v;
+        cout << endl;
+    }
+}
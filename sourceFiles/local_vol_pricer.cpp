@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "local_vol_pricer.h"
+#include "european_trade.h"
+#include "american_trade.h"
+#include "payoff.h"
+
+namespace {
+
+    // Per-thread sweep buffers, reused across groups and calls
+    struct SweepScratch {
+        std::vector<double> values, rhs, var, expY;
+        std::vector<double> lower, diag, upper, cPrime, invDenom;
+    };
+    thread_local SweepScratch scratch;
+
+    bool isSupported(const Trade& t) {
+        return dynamic_cast<const EuropeanOption*>(&t) || dynamic_cast<const AmericanOption*>(&t);
+    }
+}
+
+// ===========================
+// Constructor
+// ===========================
+LocalVolPricer::LocalVolPricer(size_t timeSteps, const LocalVolGridSpec& spec, LocalVolCache& lvCache, ThreadPool& threadPool)
+    : nTime(timeSteps), gridSpec(spec), cache(lvCache), pool(threadPool) {
+    if (nTime < 3)
+        throw std::invalid_argument("Local vol pricer needs at least 3 time steps");
+}
+
+// ===========================
+// Pricing
+// ===========================
+double LocalVolPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    if (!trade) throw std::invalid_argument("Null trade pointer");
+    return priceBatch(mkt, { trade }).front();
+}
+
+std::vector<double> LocalVolPricer::priceBatch(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades) const {
+    std::map<std::tuple<std::string, std::string, long>, std::vector<size_t>> groups;
+    for (size_t i = 0; i < trades.size(); ++i) {
+        if (!trades[i] || !isSupported(*trades[i]))
+            throw std::runtime_error("Local vol pricer only supports EuropeanOption and AmericanOption");
+        groups[{ trades[i]->getUnderlying(), trades[i]->getRateCurve(), trades[i]->getExpiry().getSerialDate() }].push_back(i);
+    }
+
+    std::vector<const std::vector<size_t>*> tasks;
+    for (const auto& [_, idx] : groups) tasks.push_back(&idx);
+
+    std::vector<double> results(trades.size(), 0.0);
+    pool.parallel_for(0, tasks.size(), 1, [&](size_t g) {
+        priceGroup(mkt, trades, *tasks[g], results);
+    });
+    return results;
+}
+
+void LocalVolPricer::priceGroup(const Market& mkt, const std::vector<std::shared_ptr<Trade>>& trades,
+    const std::vector<size_t>& group, std::vector<double>& results) const {
+    const Trade& lead = *trades[group.front()];
+    const double S0 = mkt.getStockPrice(lead.getUnderlying());
+    const double T = lead.getExpiry() - mkt.asOf;   // ACT/365, as BlackScholesPricer
+    const double r = mkt.getCurve(lead.getRateCurve())->getRate(lead.getExpiry());
+    const size_t W = group.size();
+
+    if (T <= 0.0) {
+        for (size_t i : group) {
+            const Trade& t = *trades[i];
+            results[i] = (t.isLong() ? 1.0 : -1.0) * t.getNotional() * PAYOFF::VanillaOption(t.getOptionType(), t.getStrike(), S0);
+        }
+        return;
+    }
+
+    auto grid = cache.get(mkt, lead.getUnderlying(), T, gridSpec);
+    const size_t N = grid->nodes();
+    const double dy = grid->dy();
+
+    std::vector<OptionType> type(W);
+    std::vector<double> strike(W);
+    std::vector<char> american(W);
+    for (size_t j = 0; j < W; ++j) {
+        const Trade& t = *trades[group[j]];
+        type[j] = t.getOptionType();
+        strike[j] = t.getStrike();
+        american[j] = dynamic_cast<const AmericanOption*>(&t) != nullptr;
+    }
+    const bool anyAmerican = std::find(american.begin(), american.end(), 1) != american.end();
+
+    // Terminal forward values on S = F(T) e^y, node-major
+    SweepScratch& buf = scratch;
+    buf.expY.resize(N);
+    for (size_t i = 0; i < N; ++i) buf.expY[i] = std::exp(grid->y(i));
+    const double FT = S0 * std::exp(r * T);
+    buf.values.resize(N * W);
+    for (size_t i = 0; i < N; ++i)
+        for (size_t j = 0; j < W; ++j)
+            buf.values[i * W + j] = PAYOFF::VanillaOption(type[j], strike[j], FT * buf.expY[i]);
+
+    const size_t nInner = N - 2;
+    buf.rhs.resize(nInner * W);
+    buf.var.resize(N);
+    buf.lower.resize(nInner);
+    buf.diag.resize(nInner);
+    buf.upper.resize(nInner);
+    buf.cPrime.resize(nInner);
+    buf.invDenom.resize(nInner);
+
+    const double dt = T / static_cast<double>(nTime);
+    const double k2 = 0.5 / (dy * dy), k1 = 0.25 / dy;
+    double* V = buf.values.data();
+    for (size_t n = 1; n <= nTime; ++n) {
+        const double theta = n <= 2 ? 1.0 : 0.5;
+        const double tNew = T - dt * static_cast<double>(n);
+        grid->varianceAt(T - dt * (static_cast<double>(n) - 0.5), buf.var.data());
+
+        // L U_i = a_i U_{i-1} + b_i U_i + c_i U_{i+1}
+        const double e = (1.0 - theta) * dt;
+        for (size_t i = 1; i <= nInner; ++i) {
+            const double v = buf.var[i];
+            const double a = v * (k2 + k1), b = -2.0 * v * k2, c = v * (k2 - k1);
+            double* row = buf.rhs.data() + (i - 1) * W;
+            const double* vm = V + (i - 1) * W;
+            const double* v0 = V + i * W;
+            const double* vp = V + (i + 1) * W;
+            for (size_t j = 0; j < W; ++j)
+                row[j] = v0[j] + e * (a * vm[j] + b * v0[j] + c * vp[j]);
+            buf.lower[i - 1] = -theta * dt * a;
+            buf.diag[i - 1] = 1.0 - theta * dt * b;
+            buf.upper[i - 1] = -theta * dt * c;
+        }
+
+        // Boundaries: forward intrinsic, or immediate exercise if worth more
+        const double Ft = S0 * std::exp(r * tNew);
+        const double growth = std::exp(r * (T - tNew));
+        for (size_t edge : { size_t(0), N - 1 }) {
+            double* out = V + edge * W;
+            for (size_t j = 0; j < W; ++j) {
+                double u = PAYOFF::VanillaOption(type[j], strike[j], FT * buf.expY[edge]);
+                if (american[j]) u = std::max(u, growth * PAYOFF::VanillaOption(type[j], strike[j], Ft * buf.expY[edge]));
+                out[j] = u;
+            }
+        }
+        for (size_t j = 0; j < W; ++j) {
+            buf.rhs[j] -= buf.lower[0] * V[j];
+            buf.rhs[(nInner - 1) * W + j] -= buf.upper[nInner - 1] * V[(N - 1) * W + j];
+        }
+
+        // Thomas: factor once, sweep every column
+        double prev = 0.0;
+        for (size_t i = 0; i < nInner; ++i) {
+            const double denom = buf.diag[i] - buf.lower[i] * prev;
+            buf.invDenom[i] = 1.0 / denom;
+            buf.cPrime[i] = buf.upper[i] * buf.invDenom[i];
+            prev = buf.cPrime[i];
+        }
+        for (size_t j = 0; j < W; ++j) buf.rhs[j] *= buf.invDenom[0];
+        for (size_t i = 1; i < nInner; ++i) {
+            double* row = buf.rhs.data() + i * W;
+            const double* above = row - W;
+            for (size_t j = 0; j < W; ++j)
+                row[j] = (row[j] - buf.lower[i] * above[j]) * buf.invDenom[i];
+        }
+        for (size_t i = nInner - 1; i-- > 0;) {
+            double* row = buf.rhs.data() + i * W;
+            const double* below = row + W;
+            for (size_t j = 0; j < W; ++j)
+                row[j] -= buf.cPrime[i] * below[j];
+        }
+        std::copy(buf.rhs.begin(), buf.rhs.end(), buf.values.begin() + W);
+
+        // Early exercise: U >= h(F(t) e^y) / P(t, T)
+        if (anyAmerican) {
+            for (size_t i = 1; i <= nInner; ++i) {
+                double* row = V + i * W;
+                const double S = Ft * buf.expY[i];
+                for (size_t j = 0; j < W; ++j) {
+                    if (american[j])
+                        row[j] = std::max(row[j], growth * PAYOFF::VanillaOption(type[j], strike[j], S));
+                }
+            }
+        }
+    }
+
+    const double df = std::exp(-r * T);
+    const size_t c = grid->centre();
+    for (size_t j = 0; j < W; ++j) {
+        const Trade& t = *trades[group[j]];
+        results[group[j]] = (t.isLong() ? 1.0 : -1.0) * t.getNotional() * df * V[c * W + j];
+    }
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "local_vol_surface.h"
+#include "market.h"
+#include "helper.h"
+
+using namespace std;
+
+// ===========================
+// LocalVolSurface
+// ===========================
+LocalVolSurface::LocalVolSurface(const ImpliedVolSurface& surface, double horizon, const LocalVolGridSpec& spec)
+    : tMax(horizon), nRows(spec.timeRows + 1), nNodes(spec.spaceNodes) {
+    if (horizon <= 0.0)
+        throw invalid_argument("Local vol grid needs a positive horizon");
+    if (spec.timeRows < 1 || spec.spaceNodes < 5 || spec.spaceNodes % 2 == 0)
+        throw invalid_argument("Local vol grid needs at least one time row and an odd number (>= 5) of space nodes");
+    if (spec.width <= 0.0 || spec.minVol <= 0.0 || spec.maxVol <= spec.minVol)
+        throw invalid_argument("Invalid local vol grid width or vol bounds");
+
+    rowDt = tMax / static_cast<double>(spec.timeRows);
+    const double sdAtm = sqrt(max(surface.totalVariance(tMax, 0.0), spec.minVol * spec.minVol * tMax));
+    yStep = 2.0 * spec.width * sdAtm / static_cast<double>(nNodes - 1);
+
+    const double varMin = spec.minVol * spec.minVol, varMax = spec.maxVol * spec.maxVol;
+    const double tFloor = min(rowDt, 1.0 / 365.0);   // Row 0 reads the short-dated limit
+    var.resize(nRows * nNodes);
+    for (size_t m = 0; m < nRows; ++m) {
+        const double T = max(static_cast<double>(m) * rowDt, tFloor);
+        double* out = var.data() + m * nNodes;
+        for (size_t i = 0; i < nNodes; ++i) {
+            const double yi = y(i);
+            double wT, wy, wyy;
+            const double w = surface.totalVariance(T, yi, &wT, &wy, &wyy);
+            const double denom = 1.0 - yi / w * wy + 0.25 * (-0.25 - 1.0 / w + yi * yi / (w * w)) * wy * wy + 0.5 * wyy;
+
+            // Butterfly or calendar arbitrage leaves the formula undefined; fall back to the implied variance
+            double v = (denom > 1e-8 && wT > 0.0) ? wT / denom : w / T;
+            out[i] = min(max(v, varMin), varMax);
+        }
+    }
+}
+
+void LocalVolSurface::varianceAt(double t, double* out) const {
+    const double pos = max(t, 0.0) / rowDt;
+    const size_t m = min(static_cast<size_t>(pos), nRows - 1);
+    if (m + 1 >= nRows) {
+        copy(row(nRows - 1), row(nRows - 1) + nNodes, out);
+        return;
+    }
+    const double lam = pos - static_cast<double>(m);
+    const double* a = row(m);
+    const double* b = row(m + 1);
+    for (size_t i = 0; i < nNodes; ++i)
+        out[i] = a[i] + lam * (b[i] - a[i]);
+}
+
+double LocalVolSurface::localVol(double t, double yq) const {
+    const double pos = min(max(t, 0.0) / rowDt, static_cast<double>(nRows - 1));
+    const size_t m = min(static_cast<size_t>(pos), nRows - 2);
+    const double lt = pos - static_cast<double>(m);
+
+    const double xi = min(max(yq / yStep + static_cast<double>(centre()), 0.0), static_cast<double>(nNodes - 1));
+    const size_t i = min(static_cast<size_t>(xi), nNodes - 2);
+    const double ly = xi - static_cast<double>(i);
+
+    const double v0 = row(m)[i] + ly * (row(m)[i + 1] - row(m)[i]);
+    const double v1 = row(m + 1)[i] + ly * (row(m + 1)[i + 1] - row(m + 1)[i]);
+    return sqrt(v0 + lt * (v1 - v0));
+}
+
+// ===========================
+// LocalVolCache
+// ===========================
+shared_ptr<const LocalVolSurface> LocalVolCache::get(const Market& mkt, const string& underlying, double horizon,
+    const LocalVolGridSpec& spec) {
+    auto surface = mkt.getVolSurface(underlying);
+    const uint64_t hash = surface->fingerprint();
+
+    int bucketDays = 30;
+    while (bucketDays < horizon * 365.0 && bucketDays < (1 << 20)) bucketDays *= 2;
+    Key key{ util::to_upper(underlying), mkt.asOf.getSerialDate(), bucketDays,
+        spec.timeRows, spec.spaceNodes, spec.width, spec.minVol, spec.maxVol };
+
+    {
+        lock_guard<mutex> lock(mtx);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.surfaceHash == hash)
+            return it->second.grid;
+    }
+
+    // Build outside the lock
+    auto grid = make_shared<const LocalVolSurface>(*surface, bucketDays / 365.0, spec);
+
+    lock_guard<mutex> lock(mtx);
+    ++buildCount;
+    auto it = entries.find(key);
+    if (it != entries.end() && it->second.surfaceHash == hash)
+        return it->second.grid;      // Another thread got there first
+    if (it == entries.end() && entries.size() >= kMaxEntries)
+        entries.clear();
+    entries[key] = Entry{ hash, grid };
+    return grid;
+}
+
+size_t LocalVolCache::size() const {
+    lock_guard<mutex> lock(mtx);
+    return entries.size();
+}
+
+size_t LocalVolCache::builds() const {
+    lock_guard<mutex> lock(mtx);
+    return buildCount;
+}
+
+void LocalVolCache::clear() {
+    lock_guard<mutex> lock(mtx);
+    entries.clear();
+}
+
+LocalVolCache& LocalVolCache::global() {
+    static LocalVolCache cache;
+    return cache;
+}
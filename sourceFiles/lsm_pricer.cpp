@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "lsm_pricer.h"
+#include "european_trade.h"
+#include "american_trade.h"
+#include "helper.h"
+
+// ===========================
+// Regression Moments
+// ===========================
+void LsmPricer::Regression::add(const Regression& o) {
+    for (size_t i = 0; i < ata.size(); ++i) ata[i] += o.ata[i];
+    for (size_t i = 0; i < aty.size(); ++i) aty[i] += o.aty[i];
+}
+
+// ===========================
+// Constructor
+// ===========================
+LsmPricer::LsmPricer(size_t paths, size_t exerciseDates, uint64_t rngSeed, ThreadPool& threadPool)
+    : nPaths(paths), nDates(exerciseDates), seed(rngSeed), pool(threadPool) {
+    if (nPaths == 0)
+        throw std::invalid_argument("LSM pricer needs at least one path");
+    if (nDates == 0)
+        throw std::invalid_argument("LSM pricer needs at least one exercise date");
+}
+
+void LsmPricer::setBasisDegree(size_t d) {
+    if (d == 0 || d > kMaxDegree)
+        throw std::invalid_argument("LSM basis degree must be between 1 and " + std::to_string(kMaxDegree));
+    degree = d;
+}
+
+// ===========================
+// Regression Helpers
+// ===========================
+void LsmPricer::basis(double x, double* phi) const {
+    phi[0] = 1.0;
+    for (size_t i = 1; i <= degree; ++i)
+        phi[i] = phi[i - 1] * x;
+}
+
+// Cholesky solve of the normal equations; empty when there are too few paths to regress
+std::vector<double> LsmPricer::solve(const Regression& r) const {
+    const size_t m = degree + 1;
+    if (r.ata[0] < static_cast<double>(2 * m))
+        return {};
+
+    // Full symmetric matrix from the accumulated upper triangle, with a tiny ridge
+    std::vector<double> L(m * m, 0.0);
+    double trace = 0.0;
+    for (size_t i = 0; i < m; ++i) trace += r.ata[i * m + i];
+    const double ridge = 1e-12 * trace / static_cast<double>(m);
+
+    for (size_t j = 0; j < m; ++j) {
+        double diag = r.ata[j * m + j] + ridge;
+        for (size_t k = 0; k < j; ++k) diag -= L[j * m + k] * L[j * m + k];
+        if (diag <= 0.0) return {};
+        L[j * m + j] = std::sqrt(diag);
+        for (size_t i = j + 1; i < m; ++i) {
+            double v = r.ata[j * m + i];
+            for (size_t k = 0; k < j; ++k) v -= L[i * m + k] * L[j * m + k];
+            L[i * m + j] = v / L[j * m + j];
+        }
+    }
+
+    std::vector<double> beta(m);
+    for (size_t i = 0; i < m; ++i) {
+        double v = r.aty[i];
+        for (size_t k = 0; k < i; ++k) v -= L[i * m + k] * beta[k];
+        beta[i] = v / L[i * m + i];
+    }
+    for (size_t i = m; i-- > 0;) {
+        double v = beta[i];
+        for (size_t k = i + 1; k < m; ++k) v -= L[k * m + i] * beta[k];
+        beta[i] = v / L[i * m + i];
+    }
+    return beta;
+}
+
+// ===========================
+// Pricing
+// ===========================
+double LsmPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    return priceWithError(mkt, trade).price;
+}
+
+McResult LsmPricer::priceWithError(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    if (!trade) throw std::invalid_argument("Null trade pointer");
+    if (!std::dynamic_pointer_cast<AmericanOption>(trade) && !std::dynamic_pointer_cast<AmerCallSpread>(trade) &&
+        !std::dynamic_pointer_cast<EuropeanOption>(trade) && !std::dynamic_pointer_cast<EuroCallSpread>(trade))
+        throw std::runtime_error("LSM pricer only supports American and European options and call spreads");
+
+    GbmParams gbm;
+    gbm.spot = mkt.getStockPrice(trade->getUnderlying());
+    gbm.vol = mkt.getVolCurve("LOGVOL")->getVol(trade->getExpiry());
+    gbm.rate = mkt.getCurve(trade->getRateCurve())->getRate(trade->getExpiry());
+    const double T = trade->getExpiry() - mkt.asOf;
+
+    McResult res;
+    if (T <= 0.0 || gbm.vol <= 0.0) {
+        res.price = trade->payoff(gbm.spot);
+        return res;
+    }
+
+    const double dt = T / static_cast<double>(nDates);
+    const double stepDf = std::exp(-gbm.rate * dt);
+    std::vector<double> times(nDates);
+    for (size_t k = 0; k < nDates; ++k)
+        times[k] = dt * static_cast<double>(k + 1);
+    PathGenerator gen(times, sampling, seed);
+
+    // Simulate every block and seed the cash flows with the payoff at expiry
+    const size_t nBlocks = (nPaths + kBlockPaths - 1) / kBlockPaths;
+    std::vector<PathBlock> blocks(nBlocks);
+    pool.parallel_for(0, nBlocks, 1, [&](size_t b) {
+        PathBlock& blk = blocks[b];
+        std::vector<double> z(nDates * kBlockPaths), w(nDates * kBlockPaths);
+        gen.normals(b * kBlockPaths, kBlockPaths, 0, z.data());
+        gen.brownian(z.data(), kBlockPaths, w.data());
+        blk.spots.resize(nDates * kBlockPaths);
+        gen.spots(gbm, w.data(), kBlockPaths, 1.0, blk.spots.data());
+
+        const double* sT = blk.spots.data() + (nDates - 1) * kBlockPaths;
+        blk.cash.resize(kBlockPaths);
+        for (size_t p = 0; p < kBlockPaths; ++p)
+            blk.cash[p] = trade->payoff(sT[p]);
+    });
+
+    // The holder decides: a short position is exercised against us, so the trade's rule is
+    // applied to the holder's side, max(-payoff, -continuation), and mapped back
+    const bool isLong = trade->isLong();
+    auto exercise = [&](double S, double t, double continuation) {
+        if (isLong) return trade->valueAtNode(S, t, continuation);
+        return std::min(trade->payoff(S), continuation);
+    };
+
+    // Backward induction over the exercise dates before expiry
+    const size_t m = degree + 1;
+    const double invSpot = 1.0 / gbm.spot;
+    std::vector<Regression> moments(nBlocks, Regression(m));
+
+    for (size_t k = nDates - 1; k-- > 0;) {
+        const double t = times[k];
+
+        pool.parallel_for(0, nBlocks, 1, [&](size_t b) {
+            PathBlock& blk = blocks[b];
+            Regression& reg = moments[b];
+            std::fill(reg.ata.begin(), reg.ata.end(), 0.0);
+            std::fill(reg.aty.begin(), reg.aty.end(), 0.0);
+
+            const double* sk = blk.spots.data() + k * kBlockPaths;
+            double phi[kMaxDegree + 1];
+            for (size_t p = 0; p < kBlockPaths; ++p) {
+                blk.cash[p] *= stepDf;
+                if (trade->payoff(sk[p]) == 0.0) continue;
+
+                basis(sk[p] * invSpot, phi);
+                for (size_t i = 0; i < m; ++i) {
+                    reg.aty[i] += phi[i] * blk.cash[p];
+                    for (size_t j = i; j < m; ++j)
+                        reg.ata[i * m + j] += phi[i] * phi[j];
+                }
+            }
+        });
+
+        // Fixed-order reduction keeps the regression, and so every decision, deterministic
+        Regression total(m);
+        for (const auto& reg : moments) total.add(reg);
+        const std::vector<double> beta = solve(total);
+        if (beta.empty()) continue;
+
+        pool.parallel_for(0, nBlocks, 1, [&](size_t b) {
+            PathBlock& blk = blocks[b];
+            const double* sk = blk.spots.data() + k * kBlockPaths;
+            double phi[kMaxDegree + 1];
+            for (size_t p = 0; p < kBlockPaths; ++p) {
+                if (trade->payoff(sk[p]) == 0.0) continue;
+
+                basis(sk[p] * invSpot, phi);
+                double continuation = 0.0;
+                for (size_t i = 0; i < m; ++i) continuation += beta[i] * phi[i];
+
+                const double v = exercise(sk[p], t, continuation);
+                if (v != continuation) blk.cash[p] = v;
+            }
+        });
+    }
+
+    // Discount the first exercise date back to today; per-block sums reduced in order
+    std::vector<double> sums(nBlocks), squares(nBlocks);
+    pool.parallel_for(0, nBlocks, 1, [&](size_t b) {
+        std::vector<double>& cash = blocks[b].cash;
+        for (double& c : cash) c *= stepDf;
+        sums[b] = util::pairwiseSum(cash);
+        double sq = 0.0;
+        for (double c : cash) sq += c * c;
+        squares[b] = sq;
+    });
+
+    const double n = static_cast<double>(nBlocks * kBlockPaths);
+    const double mean = util::pairwiseSum(sums) / n;
+    const double variance = n > 1.0 ? (util::pairwiseSum(squares) - n * mean * mean) / (n - 1.0) : 0.0;
+
+    res.price = exercise(gbm.spot, 0.0, mean);
+    res.stdError = std::sqrt(std::max(variance, 0.0) / n);
+    res.paths = nBlocks * kBlockPaths;
+    return res;
+}
@@ -2,7 +2,10 @@
 #include <fstream>
 #include <chrono>
 #include <ctime>
+#include <array>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -11,21 +14,29 @@
 #include "tree_pricer.h"
 #include "risk_engine.h"
 #include "factory.h"
+#include "asian_trade.h"
+#include "barrier_trade.h"
+#include "swaption_trade.h"
+#include "bermudan_swaption_trade.h"
+#include "exposure_simulator.h"
+#include "curve_bootstrapper.h"
 #include "helper.h"
+#include "portfolio_valuer.h"
+#include "trade_loader.h"
+#include "pricing_server.h"
+#include "what_if_analyzer.h"
+#include "rolling_var.h"
+#include "pnl_explain.h"
+#include "backtest_valuer.h"
+#include "stress_test.h"
+#include "risk_ladder.h"
+#include "sensitivity_var.h"
 
 using namespace std;
 using namespace util;
 
 const string basePath = "../../../resourceFiles/";
 
-struct TradeResult {
-    size_t id = 0;
-    string tradeInfo;
-    double PV = 0.0;
-    double DV01 = 0.0;
-    double Vega = 0.0;
-};
-
 // ========== Load Trades ==========
 void loadTrade(vector<shared_ptr<Trade>>& portfolio) {
     string header;
@@ -41,39 +52,10 @@ void loadTrade(vector<shared_ptr<Trade>>& portfolio) {
         }
 
         try {
-            string type = to_lower(t[1]);
-            Date tradeDate = parseDate(t[2]);
-            Date startDate = parseDate(t[3]);
-            Date endDate = parseDate(t[4]);
-            double notional = stod(t[5]);
-            string underlying = t[6];
-            if (underlying == "SGD-MAS-BILL") underlying = "SGD-SORA";
-            double rate = stod(t[7]);
-            double strike = stod(t[8]);
-            double freq = stod(t[9]);
-            string optionStr = to_lower(t[10]);
-            string direction = to_lower(t[11]);
-
-            OptionType optType = OptionType::None;
-            if (optionStr == "call") optType = OptionType::Call;
-            else if (optionStr == "put") optType = OptionType::Put;
-
-            bool isLong = (direction == "long");
-
-            shared_ptr<Trade> trade;
-            if (type == "bond")
-                trade = BondFactory().createTrade(underlying, startDate, endDate, notional, rate, freq, optType);
-            else if (type == "swap")
-                trade = SwapFactory().createTrade(underlying, startDate, endDate, notional, rate, freq, optType);
-            else if (type == "european")
-                trade = make_shared<EuropeanOption>(optType, notional, strike, tradeDate, endDate, underlying);
-            else if (type == "american")
-                trade = make_shared<AmericanOption>(optType, notional, strike, tradeDate, endDate, underlying);
-
+            shared_ptr<Trade> trade = parseTradeRow(lines[i]);
             if (trade) {
-                trade->setLong(isLong);
                 portfolio.push_back(trade);
-                cout << "[OK] Loaded trade " << i + 1 << ": " << trade->getType() << " " << underlying << endl;
+                cout << "[OK] Loaded trade " << i + 1 << ": " << trade->getType() << " " << trade->getUnderlying() << endl;
             }
         }
         catch (const exception& e) {
@@ -101,6 +83,27 @@ void loadIrCurve(Market& mkt, const string& fileName, const string& curveName) {
     mkt.addCurve(curveName, curve);
 }
 
+// Deposit and par swap quotes, rates in %; freq is the swap fixed-leg interval in years
+vector<CurveQuote> loadCurveQuotes(const string& fileName) {
+    string header;
+    vector<string> lines;
+    readFromFile(basePath + fileName, header, lines);
+
+    vector<CurveQuote> quotes;
+    for (const auto& line : lines) {
+        auto parts = split(line, ";");
+        if (parts.size() < 3) continue;
+        CurveQuote q;
+        q.type = to_upper(parts[0]) == "DEPOSIT" ? CurveInstrument::Deposit : CurveInstrument::Swap;
+        q.tenor = parts[1];
+        q.rate = stod(parts[2]) / 100.0;
+        if (parts.size() > 3 && q.type == CurveInstrument::Swap)
+            q.frequency = stod(parts[3]);
+        quotes.push_back(q);
+    }
+    return quotes;
+}
+
 void loadVolCurve(Market& mkt, const string& fileName, const string& curveName) {
     auto vol = make_shared<VolCurve>(curveName);
     string header;
@@ -119,6 +122,62 @@ void loadVolCurve(Market& mkt, const string& fileName, const string& curveName)
     mkt.addVolCurve(curveName, vol);
 }
 
+// Header row holds the strike offsets in bp; normal vols are quoted in bp, lognormal in %
+void loadSwaptionVolCube(Market& mkt, const string& fileName, const string& cubeName, SwaptionVolType type) {
+    auto cube = make_shared<SwaptionVolCube>(cubeName, type);
+    string header;
+    vector<string> lines;
+    readFromFile(basePath + fileName, header, lines);
+    Date asOf = mkt.asOf;
+
+    auto cols = split(header, ";");
+    vector<double> offsets;
+    for (size_t k = 2; k < cols.size(); ++k)
+        offsets.push_back(stod(cols[k]) / 10000.0);
+    cube->setStrikeOffsets(offsets);
+
+    const double unit = type == SwaptionVolType::Normal ? 10000.0 : 100.0;
+    for (const auto& line : lines) {
+        auto parts = split(line, ";");
+        if (parts.size() != offsets.size() + 2) continue;
+        double expiry = dateAddTenor(asOf, parts[0]) - asOf;
+        double tenor = dateAddTenor(asOf, parts[1]) - asOf;
+        vector<double> smile;
+        for (size_t k = 2; k < parts.size(); ++k)
+            smile.push_back(stod(parts[k]) / unit);
+        cube->addSmile(expiry, tenor, smile);
+    }
+
+    mkt.addSwaptionVolCube(cubeName, cube);
+}
+
+// Header row holds the moneyness nodes K/F in %; rows are expiry tenors with vols in %
+void loadVolSurface(Market& mkt, const string& fileName, const string& underlying) {
+    auto surface = make_shared<ImpliedVolSurface>(underlying);
+    string header;
+    vector<string> lines;
+    readFromFile(basePath + fileName, header, lines);
+    Date asOf = mkt.asOf;
+
+    auto cols = split(header, ";");
+    vector<double> moneyness;
+    for (size_t k = 1; k < cols.size(); ++k)
+        moneyness.push_back(stod(cols[k]) / 100.0);
+    surface->setMoneyness(moneyness);
+
+    for (const auto& line : lines) {
+        auto parts = split(line, ";");
+        if (parts.size() != moneyness.size() + 1) continue;
+        double expiry = dateAddTenor(asOf, parts[0]) - asOf;
+        vector<double> smile;
+        for (size_t k = 1; k < parts.size(); ++k)
+            smile.push_back(stod(parts[k]) / 100.0);
+        surface->addSmile(expiry, smile);
+    }
+
+    mkt.addVolSurface(underlying, surface);
+}
+
 // ========== Output ==========
 void outPutResult(const vector<TradeResult>& results) {
     vector<string> output;
@@ -146,19 +205,153 @@ void readAndPrintOutput(const string& filePath) {
     cout << "==========================================================\n" << endl;
 }
 
+void printAggregates(const string& label, const vector<AggregateResult>& rows) {
+    cout << "--- Totals by " << label << " ---" << endl;
+    cout << setprecision(17);
+    for (const auto& a : rows) {
+        cout << a.key << " (" << a.tradeCount << " trades)"
+            << "; PV:" << a.PV << "; Delta:" << a.DV01 << "; Vega:" << a.Vega << endl;
+    }
+    cout << setprecision(6);
+}
+
+void printVaR(const VarResult& total, const map<string, VarResult>& byBook,
+    double confidence, size_t nScenarios) {
+    cout << "--- Historical VaR/ES (" << confidence * 100 << "%, "
+        << nScenarios << " scenarios) ---" << endl;
+    cout << "PORTFOLIO; VaR:" << total.VaR << "; ES:" << total.ES << endl;
+    for (const auto& [book, v] : byBook)
+        cout << book << "; VaR:" << v.VaR << "; ES:" << v.ES << endl;
+}
+
+void printExplain(const string& label, const vector<PnlAttribution>& rows) {
+    cout << "--- P&L Explain by " << label << " ---" << endl;
+    for (const auto& a : rows) {
+        cout << a.key << " (" << a.tradeCount << " trades)" << "; PnL:" << a.total() << "; Carry:" << a.carry
+            << "; Rates:" << a.rates << "; Delta:" << a.delta << "; Gamma:" << a.gamma << "; Vega:" << a.vega
+            << "; Unexplained:" << a.unexplained << endl;
+    }
+}
+
+void printStress(const StressTestEngine& stress, double millis) {
+    cout << "--- Stress Tests (" << stress.getScenarios().size() << " scenarios, " << stress.revaluations()
+        << " revaluations, " << millis << "ms) ---" << endl;
+    const vector<double> total = stress.portfolioPnl();
+    const auto byBook = stress.pnlBy(AggregateBy::Book);
+    for (size_t s = 0; s < total.size(); ++s) {
+        cout << stress.getScenarios()[s].name << "; PnL:" << total[s];
+        for (const auto& [book, pnl] : byBook)
+            cout << "; " << book << ":" << pnl[s];
+        cout << endl;
+    }
+}
+
+void printLadders(const LadderEngine& ladders, double millis) {
+    const LadderSpec& spec = ladders.getSpec();
+    const size_t nS = spec.spotMoves.size();
+    cout << "--- Spot/Vol Ladders (" << nS << " spots x " << spec.volMoves.size() << " vols, "
+        << ladders.latticeBuilds() << " lattices, " << millis << "ms) ---" << endl;
+    for (const auto& [underlying, grid] : ladders.byUnderlying()) {
+        LadderGreeks g = ladders.greeks(grid.data());
+        cout << underlying << "; Gamma(1%):" << g.gamma * 1e-4 << "; Vanna(1%,1vol):" << g.vanna * 1e-4 << endl;
+        for (size_t v = 0; v < spec.volMoves.size(); ++v) {
+            cout << "  vol" << (spec.volMoves[v] >= 0 ? "+" : "") << spec.volMoves[v] * 100;
+            for (size_t s = 0; s < nS; s += 5)
+                cout << "; " << spec.spotMoves[s] * 100 << "%:" << grid[v * nS + s];
+            cout << endl;
+        }
+    }
+}
+
+void printWhatIf(const string& label, const WhatIfResult& w, double micros) {
+    cout << label << "; dPV:" << w.delta.PV << "; PV:" << w.after.PV << "; DV01:" << w.after.DV01
+        << "; Vega:" << w.after.Vega << "; VaR:" << w.varAfter.VaR << "; dVaR:" << w.varContribution
+        << "; " << micros << "us" << endl;
+    for (const auto& [curve, v] : w.delta.dv01Buckets)
+        if (v != 0.0) cout << "  dDV01 " << curve << ":" << v << endl;
+    for (const auto& [vol, v] : w.delta.vegaBuckets)
+        if (v != 0.0) cout << "  dVega " << vol << ":" << v << endl;
+}
+
+void printExposure(const vector<ExposureProfile>& profiles, const ExposureConfig& cfg) {
+    cout << "--- Counterparty Exposure (" << cfg.paths << " paths, " << cfg.model.stepDays << "d grid) ---" << endl;
+    for (const auto& p : profiles) {
+        double peakEE = 0.0, peakPFE = 0.0;
+        for (size_t k = 0; k < p.ee.size(); ++k) {
+            peakEE = max(peakEE, p.ee[k]);
+            if (!p.pfe.empty()) peakPFE = max(peakPFE, p.pfe.back()[k]);
+        }
+        cout << p.nettingSet << " (" << p.trades << " swaps); EPE:" << p.epe << "; PeakEE:" << peakEE
+            << "; PeakPFE" << (cfg.pfeQuantiles.empty() ? 0.0 : cfg.pfeQuantiles.back() * 100) << ":" << peakPFE
+            << "; CVA:" << p.cva << endl;
+    }
+}
+// Zero-rate delta of each bootstrapped curve's swaps per pillar (1bp central bumps), mapped to
+// par-rate delta per quote through the bootstrap Jacobian
+void printParRisk(const Market& mkt, MultiCurveBootstrapper& curves, const vector<shared_ptr<Trade>>& portfolio,
+    const vector<string>& curveNames) {
+    cout << "--- Par-rate delta (1bp) ---" << endl;
+    for (const auto& name : curveNames) {
+        if (!curves.hasCurve(name)) continue;
+        CurveBootstrapper& b = curves.getBootstrapper(name);
+        vector<shared_ptr<Trade>> swaps;
+        for (const auto& t : portfolio)
+            if (dynamic_pointer_cast<Swap>(t) && to_upper(t->getRateCurve()) == b.getName()) swaps.push_back(t);
+        if (swaps.empty()) continue;
+
+        const auto base = mkt.getCurve(b.getName());
+        vector<double> zeroRisk(b.getPillars().size(), 0.0);
+        for (size_t p = 0; p < zeroRisk.size(); ++p) {
+            Market up = mkt.overlay(), down = mkt.overlay();
+            auto cu = make_shared<RateCurve>(*base), cd = make_shared<RateCurve>(*base);
+            cu->shock(b.getPillars()[p], 0.0001);
+            cd->shock(b.getPillars()[p], -0.0001);
+            up.addCurve(b.getName(), cu);
+            down.addCurve(b.getName(), cd);
+            for (const auto& s : swaps)
+                zeroRisk[p] += (s->pv(up) - s->pv(down)) / 2.0;
+        }
+
+        // Risk per unit rate in, per bp out
+        for (auto& z : zeroRisk) z *= 10000.0;
+        const vector<double> parRisk = b.parRisk(zeroRisk);
+        cout << b.getName();
+        for (size_t i = 0; i < parRisk.size(); ++i)
+            cout << "; " << b.getQuotes()[i].tenor << ":" << parRisk[i] / 10000.0;
+        cout << endl;
+    }
+}
+
 // ========== Main ==========
-int main() {
+int main(int argc, char* argv[]) {
     time_t t = chrono::system_clock::to_time_t(chrono::system_clock::now());
     tm localTime;
     localtime_s(&localTime, &t);
     Date valueDate(localTime.tm_year + 1900, localTime.tm_mon + 1, localTime.tm_mday);
 
     auto mkt = make_shared<Market>(valueDate);
-    loadIrCurve(*mkt, "usd_curve.txt", "USD-SOFR");
-    loadIrCurve(*mkt, "sgd_curve.txt", "SGD-SORA");
-    mkt->addCurve("USD-GOV", mkt->getCurve("USD-SOFR"));
-    mkt->addCurve("SGD-GOV", mkt->getCurve("SGD-SORA"));
+    // Curves bootstrap from deposit/swap quotes when present, else load zero rates
+    MultiCurveBootstrapper curves;
+    for (const auto& [quoteFile, zeroFile, curveName] : vector<array<string, 3>>{
+        { "usd_curve_quotes.txt", "usd_curve.txt", "USD-SOFR" },
+        { "sgd_curve_quotes.txt", "sgd_curve.txt", "SGD-SORA" } }) {
+        if (fileExists(basePath + quoteFile))
+            curves.addCurve(curveName, valueDate, loadCurveQuotes(quoteFile));
+        else
+            loadIrCurve(*mkt, zeroFile, curveName);
+    }
+    // Government curves alias the OIS curves; bootstrapped ones are re-aliased on every rebuild
+    const vector<array<string, 2>> govAliases = { { "USD-SOFR", "USD-GOV" }, { "SGD-SORA", "SGD-GOV" } };
+    for (const auto& [curveName, alias] : govAliases)
+        if (curves.hasCurve(curveName)) curves.addAlias(curveName, alias);
+    curves.buildAll(*mkt);
+    for (const auto& [curveName, alias] : govAliases)
+        if (!curves.hasCurve(curveName)) mkt->addCurve(alias, mkt->getCurve(curveName));
     loadVolCurve(*mkt, "vol.txt", "LOGVOL");
+    loadSwaptionVolCube(*mkt, "usd_swaption_vol.txt", "USD-SWPN", SwaptionVolType::Normal);
+    loadSwaptionVolCube(*mkt, "sgd_swaption_vol.txt", "SGD-SWPN", SwaptionVolType::Lognormal);
+    loadVolSurface(*mkt, "sp500_vol_surface.txt", "SP500");
+    loadVolSurface(*mkt, "sti_vol_surface.txt", "STI");
 
     mkt->addStockPrice("APPL", 652.0);
     mkt->addStockPrice("SP500", 5035.7);
@@ -167,32 +360,206 @@ int main() {
     vector<shared_ptr<Trade>> portfolio;
     loadTrade(portfolio);
 
-    auto pricer = make_shared<CRRBinomialTreePricer>(50);
-    vector<TradeResult> results;
-
     double curve_shock = 0.0001, vol_shock = 0.01;
 
-    for (size_t i = 0; i < portfolio.size(); ++i) {
-        auto& trade = portfolio[i];
-        TradeResult r;
-        r.id = i + 1;
-        r.tradeInfo = trade->getType() + " " + trade->getUnderlying();
-        r.PV = pricer->price(*mkt, trade);
+    // Parallel chunked valuation into per-trade slots on the work-stealing pool
+    // Off-table PVs are memoized by trade and market versions across runs, updates and bumps
+    PortfolioValuer valuer(*mkt, portfolio, curve_shock, vol_shock);
+    valuer.setCache(&ValuationCache::global());
+    cout << "[INFO] Discount table: " << valuer.getDiscountTable()->size() << " unique dates across "
+        << valuer.getDiscountTable()->curveCount() << " curves" << endl;
+    const vector<TradeResult>& results = valuer.run();
+
+    // Daemon mode: market, portfolio and caches stay warm and answer requests over a local socket
+    if (argc > 1 && string(argv[1]) == "--serve") {
+        PricingServer server(*mkt, valuer);
+        server.serve(argc > 2 ? argv[2] : "pricing_engine.sock");
+        return 0;
+    }
 
-        RiskEngine engine(*mkt, curve_shock, vol_shock, 0.0);
-        engine.computeRisk("dv01", trade, true);
-        for (const auto& [_, v] : engine.getResult())
-            r.DV01 += v / (2.0 * curve_shock);
+    // Backtest mode: reprice the same portfolio on one snapshot per historical day, walking
+    // back from today by undoing each observed move; writes the trade-by-date PV matrix
+    if (argc > 1 && string(argv[1]) == "--backtest") {
+        vector<HistoricalScenario> history = loadHistoricalScenarios(basePath + "historical_scenarios.txt");
+        size_t days = min(history.size(), argc > 2 ? static_cast<size_t>(stoul(argv[2])) : history.size());
+
+        // Moves are applied on the today-dated chain so tenor pillars line up; each snapshot
+        // is then an overlay stamped with its own as-of date
+        vector<shared_ptr<const Market>> snapshots(days + 1);
+        unique_ptr<Market> chain(new Market(mkt->overlay()));
+        snapshots[days] = mkt;
+        for (size_t k = days; k-- > 0;) {
+            chain.reset(new Market(history[history.size() - days + k].inverse().apply(*chain)));
+            shared_ptr<Market> snap(new Market(chain->overlay()));
+            snap->asOf = valueDate.addDays(-static_cast<int>(days - k));
+            snapshots[k] = snap;
+        }
 
-        engine.computeRisk("vega", trade, true);
-        for (const auto& [_, v] : engine.getResult())
-            r.Vega += v / vol_shock;
+        BacktestValuer backtest(portfolio, valuer.getDiscountTable());
+        auto t0 = chrono::steady_clock::now();
+        const PvMatrix& pvs = backtest.run(snapshots);
+        auto t1 = chrono::steady_clock::now();
+        backtest.writeCsv("backtest_pv.txt");
 
-        results.push_back(r);
+        const BacktestStats& bs = backtest.getStats();
+        const vector<double> totals = pvs.portfolioPv();
+        cout << "[INFO] Backtest " << bs.dates << " dates x " << pvs.tradeCount() << " trades in "
+            << chrono::duration<double, milli>(t1 - t0).count() << "ms; valuations " << bs.valuations
+            << "; matured " << bs.matured << "; written to backtest_pv.txt" << endl;
+        cout << "[INFO] Portfolio PV " << backtest.getDates().front() << ": " << totals.front()
+            << "; " << backtest.getDates().back() << ": " << totals.back() << endl;
+        return 0;
     }
 
     outPutResult(results);
     cout << "Pricing and risk completed. Results written to output.txt\n";
     readAndPrintOutput("output.txt");
+
+    printAggregates("Book", valuer.aggregate(AggregateBy::Book));
+    printAggregates("Underlying", valuer.aggregate(AggregateBy::Underlying));
+    printAggregates("Curve", valuer.aggregate(AggregateBy::Curve));
+    printAggregates("Portfolio", { valuer.total() });
+    printParRisk(*mkt, curves, portfolio, { "USD-SOFR", "SGD-SORA" });
+
+    // Live ticks: only trades depending on the moved factor reprice; each tick is undone after
+    {
+        const MarketFactor sti(FactorKind::Spot, "STI");
+        const double stiSpot = mkt->getStockPrice("STI");
+        const double basePv = valuer.total().PV;
+        auto t0 = chrono::steady_clock::now();
+        mkt->addStockPrice("STI", stiSpot * 1.01);
+        size_t repriced = valuer.update({ sti });
+        auto t1 = chrono::steady_clock::now();
+        cout << "[INFO] Tick STI +1%: repriced " << repriced << " of " << portfolio.size() << " trades in "
+            << chrono::duration<double, micro>(t1 - t0).count() << "us; PV change " << valuer.total().PV - basePv << endl;
+        mkt->addStockPrice("STI", stiSpot);
+        valuer.update({ sti });
+
+        if (curves.hasCurve("SGD-SORA")) {
+            CurveBootstrapper& sgd = curves.getBootstrapper("SGD-SORA");
+            size_t quote = 0;
+            while (quote + 1 < sgd.getQuotes().size() && sgd.getQuotes()[quote].tenor != "2Y") ++quote;
+            const double rate = sgd.getQuotes()[quote].rate;
+            const vector<MarketFactor> sora = curves.movedFactors("SGD-SORA");
+            t0 = chrono::steady_clock::now();
+            size_t pillars = curves.updateQuote(*mkt, "SGD-SORA", quote, rate + 0.0001);
+            repriced = valuer.update(sora);
+            t1 = chrono::steady_clock::now();
+            cout << "[INFO] Tick SGD-SORA " << sgd.getQuotes()[quote].tenor << " +1bp: re-solved " << pillars
+                << " pillar(s), repriced " << repriced << " trades in " << chrono::duration<double, micro>(t1 - t0).count()
+                << "us; PV change " << valuer.total().PV - basePv << endl;
+            curves.updateQuote(*mkt, "SGD-SORA", quote, rate);
+            valuer.update(sora);
+        }
+    }
+
+    // Intraday rerun: trades whose market data did not move come back from the cache
+    {
+        auto t0 = chrono::steady_clock::now();
+        valuer.run();
+        auto t1 = chrono::steady_clock::now();
+        CacheStats cs = ValuationCache::global().stats();
+        cout << "[INFO] Rerun in " << chrono::duration<double, micro>(t1 - t0).count() << "us; valuation cache hits "
+            << cs.hits << ", misses " << cs.misses << " (hit rate " << cs.hitRate() * 100 << "%), entries "
+            << cs.entries << ", evictions " << cs.evictions << endl;
+    }
+
+    // Historical-simulation VaR / ES over a rolling window; the P&L store carries
+    // scenario results between runs so only the new day and new/amended trades reprice
+    string scenarioFile = basePath + "historical_scenarios.txt";
+    if (fileExists(scenarioFile)) {
+        const string storeFile = "scenario_pnl_store.txt";
+        RollingVarEngine varEngine(*mkt, portfolio, 250, valuer.getDiscountTable());
+        varEngine.loadStore(storeFile);
+        vector<HistoricalScenario> history = loadHistoricalScenarios(scenarioFile);
+        RollStats stats = varEngine.update(history);
+        varEngine.saveStore(storeFile);
+
+        cout << "[INFO] VaR window " << stats.scenarios << " days; new days " << stats.newScenarios
+            << "; repriced trades " << stats.repricedTrades << "; revaluations " << stats.revaluations
+            << "; reused " << stats.reused << endl;
+        printVaR(varEngine.portfolioVaR(0.99), varEngine.varBy(AggregateBy::Book, 0.99),
+            0.99, stats.scenarios);
+
+        // Intraday VaR from sensitivities; sampled trades are checked against full revaluation
+        SensitivityVarEngine fastVar(*mkt, portfolio, valuer.getDiscountTable());
+        fastVar.setScenarios(varEngine.getWindowScenarios());
+        auto s0 = chrono::steady_clock::now();
+        fastVar.computeSensitivities();
+        auto s1 = chrono::steady_clock::now();
+        for (int pass = 0; pass < 3; ++pass) fastVar.run();   // Successive intraday runs
+        auto s2 = chrono::steady_clock::now();
+        fastVar.setConfig([&] { SensitivityVarConfig c = fastVar.getConfig(); c.checkEvery = 0; return c; }());
+        fastVar.run();
+        auto s3 = chrono::steady_clock::now();
+        const SensitivityVarStats& fs = fastVar.getStats();
+        cout << "[INFO] Sensitivity VaR: " << fs.factors << " factors, " << fs.sensitivities << " sensitivities in "
+            << chrono::duration<double, milli>(s1 - s0).count() << "ms; 3 checked runs in "
+            << chrono::duration<double, milli>(s2 - s1).count() << "ms; unchecked run in "
+            << chrono::duration<double, milli>(s3 - s2).count() << "ms; approximated " << fs.approximated
+            << ", full reval " << fs.fullReval << endl;
+        printVaR(fastVar.portfolioVaR(0.99), fastVar.varBy(AggregateBy::Book, 0.99), 0.99, stats.scenarios);
+
+        // Pre-trade what-if: only the candidate prices, against the cached base and scenarios
+        WhatIfAnalyzer whatIf(valuer, 0.99);
+        whatIf.attach(varEngine);
+        cout << "--- Pre-Trade What-If (99%, " << whatIf.scenarioCount() << " scenarios) ---" << endl;
+        auto timed = [&](const string& label, auto query) {
+            auto t0 = chrono::steady_clock::now();
+            WhatIfResult w = query();
+            auto t1 = chrono::steady_clock::now();
+            printWhatIf(label, w, chrono::duration<double, micro>(t1 - t0).count());
+        };
+        auto newSwap = parseTradeRow("WI-1;swap;2025-06-01;2025-06-03;2030-06-03;25000000;USD-SOFR;0.04;0;0.5;na;receive;RATES;CPTY-A");
+        auto newOption = parseTradeRow("WI-2;european;2025-06-01;2025-06-03;2026-06-03;1000;STI;0;3400;0;put;long;EQ;CPTY-B");
+        timed("Add WI-1 5Y receiver swap", [&] { return whatIf.addTrade(newSwap); });
+        timed("Add WI-2 STI put", [&] { return whatIf.addTrade(newOption); });
+        if (!portfolio.empty()) {
+            const string& id = portfolio.front()->getId();
+            timed("Cancel " + id, [&] { return whatIf.cancelTrade(id); });
+            timed("Amend " + id + " to WI-1 terms", [&] { return whatIf.amendTrade(id, newSwap); });
+        }
+
+        // Day-over-day P&L explain: yesterday's market undoes the latest historical move
+        if (!history.empty()) {
+            Market yesterday = history.back().inverse().apply(*mkt);
+            yesterday.asOf = mkt->asOf.addDays(-1);
+
+            PnlExplainer explainer(portfolio, valuer.getDiscountTable());
+            auto t0 = chrono::steady_clock::now();
+            explainer.explain(yesterday, *mkt);
+            auto t1 = chrono::steady_clock::now();
+            printExplain("Book", explainer.aggregate(AggregateBy::Book));
+            printExplain("Underlying", explainer.aggregate(AggregateBy::Underlying));
+            printExplain("Portfolio", { explainer.total() });
+            cout << "[INFO] P&L explain in " << chrono::duration<double, micro>(t1 - t0).count() << "us; revaluations "
+                << explainer.revaluations() << " (end-to-end P&L: " << 2 * portfolio.size() << ")" << endl;
+        }
+    }
+
+    // Stress scenarios compile to overlays and reprice only the trades they move
+    string stressFile = basePath + "stress_scenarios.txt";
+    if (fileExists(stressFile)) {
+        StressTestEngine stress(*mkt, portfolio, valuer.getDiscountTable());
+        stress.loadScenarios(stressFile);
+        auto t0 = chrono::steady_clock::now();
+        stress.run();
+        auto t1 = chrono::steady_clock::now();
+        printStress(stress, chrono::duration<double, milli>(t1 - t0).count());
+    }
+
+    // Second-order spot/vol ladders: closed form or one lattice per vol level per trade
+    {
+        LadderEngine ladders(*mkt, portfolio);
+        auto t0 = chrono::steady_clock::now();
+        ladders.run(LadderSpec::uniform(-0.2, 0.2, 21, { -0.05, 0.0, 0.05 }));
+        auto t1 = chrono::steady_clock::now();
+        printLadders(ladders, chrono::duration<double, milli>(t1 - t0).count());
+    }
+
+    // Netted swap exposure profiles and CVA per counterparty
+    ExposureConfig exposureCfg;
+    ExposureSimulator exposure(exposureCfg);
+    printExposure(exposure.run(*mkt, portfolio), exposureCfg);
     return 0;
 }
\ No newline at end of file
@@ -2,9 +2,11 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <stdexcept>
 
 #include "market.h"
+#include "helper.h"
 
 using namespace std;
 
@@ -23,6 +25,11 @@ static string toUpper(const string& str) {
     return result;
 }
 
+static uint64_t nextVersion() {
+    static atomic<uint64_t> counter{ 0 };
+    return ++counter;
+}
+
 // ===== Constructors =====
 
 Market::Market() {
@@ -35,11 +42,58 @@ Market::Market(const Date& now) : asOf(now), name("test") {
 
 Market::Market(const Market& other)
     : asOf(other.asOf), name(other.name),
-    bondPrices(other.bondPrices), stockPrices(other.stockPrices) {
+    bondPrices(other.bondPrices), stockPrices(other.stockPrices), versions(other.versions) {
     for (const auto& kv : other.curves)
         curves[kv.first] = make_shared<RateCurve>(*kv.second);
     for (const auto& kv : other.vols)
         vols[kv.first] = make_shared<VolCurve>(*kv.second);
+    for (const auto& kv : other.swaptionVols)
+        swaptionVols[kv.first] = make_shared<SwaptionVolCube>(*kv.second);
+    for (const auto& kv : other.volSurfaces)
+        volSurfaces[kv.first] = make_shared<ImpliedVolSurface>(*kv.second);
+}
+
+Market::Market(const Market& other, ShareTag)
+    : asOf(other.asOf), name(other.name),
+    curves(other.curves), vols(other.vols), swaptionVols(other.swaptionVols), volSurfaces(other.volSurfaces),
+    bondPrices(other.bondPrices), stockPrices(other.stockPrices), versions(other.versions) {
+}
+
+Market Market::overlay() const {
+    return Market(*this, ShareTag{});
+}
+
+namespace {
+    template <typename Map>
+    void copyEntry(Map& into, const Map& from, const string& key) {
+        using Object = typename Map::mapped_type::element_type;
+        auto it = from.find(key);
+        if (it == from.end()) into.erase(key);
+        else into[key] = make_shared<Object>(*it->second);
+    }
+
+    template <typename Map>
+    void copyValue(Map& into, const Map& from, const string& key) {
+        auto it = from.find(key);
+        if (it == from.end()) into.erase(key);
+        else into[key] = it->second;
+    }
+}
+
+void Market::copyFactor(const Market& source, const MarketFactor& factor) {
+    switch (factor.kind) {
+    case FactorKind::Curve:        copyEntry(curves, source.curves, factor.name); break;
+    case FactorKind::Vol:          copyEntry(vols, source.vols, factor.name); break;
+    case FactorKind::SwaptionCube: copyEntry(swaptionVols, source.swaptionVols, factor.name); break;
+    case FactorKind::VolSurface:   copyEntry(volSurfaces, source.volSurfaces, factor.name); break;
+    case FactorKind::Spot:         copyValue(stockPrices, source.stockPrices, factor.name); break;
+    case FactorKind::BondPrice:    copyValue(bondPrices, source.bondPrices, factor.name); break;
+    case FactorKind::Any:          *this = source; return;
+    }
+
+    auto v = source.versions.find(factor);
+    if (v == source.versions.end()) versions.erase(factor);
+    else versions[factor] = v->second;
 }
 
 Market& Market::operator=(const Market& other) {
@@ -48,12 +102,19 @@ Market& Market::operator=(const Market& other) {
         name = other.name;
         bondPrices = other.bondPrices;
         stockPrices = other.stockPrices;
+        versions = other.versions;
         curves.clear();
         vols.clear();
+        swaptionVols.clear();
+        volSurfaces.clear();
         for (const auto& kv : other.curves)
             curves[kv.first] = make_shared<RateCurve>(*kv.second);
         for (const auto& kv : other.vols)
             vols[kv.first] = make_shared<VolCurve>(*kv.second);
+        for (const auto& kv : other.swaptionVols)
+            swaptionVols[kv.first] = make_shared<SwaptionVolCube>(*kv.second);
+        for (const auto& kv : other.volSurfaces)
+            volSurfaces[kv.first] = make_shared<ImpliedVolSurface>(*kv.second);
     }
     return *this;
 }
@@ -66,18 +127,32 @@ Market::~Market() {
 
 void Market::addCurve(const string& Name, shared_ptr<RateCurve> curve) {
     curves[toUpper(Name)] = curve;
+    touch(MarketFactor(FactorKind::Curve, Name));
 }
 
 void Market::addVolCurve(const string& Name, shared_ptr<VolCurve> vol) {
     vols[toUpper(Name)] = vol;
+    touch(MarketFactor(FactorKind::Vol, Name));
+}
+
+void Market::addSwaptionVolCube(const string& Name, shared_ptr<SwaptionVolCube> cube) {
+    swaptionVols[toUpper(Name)] = cube;
+    touch(MarketFactor(FactorKind::SwaptionCube, Name));
+}
+
+void Market::addVolSurface(const string& underlying, shared_ptr<ImpliedVolSurface> surface) {
+    volSurfaces[toUpper(underlying)] = surface;
+    touch(MarketFactor(FactorKind::VolSurface, underlying));
 }
 
 void Market::addBondPrice(const string& bondName, double price) {
     bondPrices[toUpper(bondName)] = price;
+    touch(MarketFactor(FactorKind::BondPrice, bondName));
 }
 
 void Market::addStockPrice(const string& stockName, double price) {
     stockPrices[toUpper(stockName)] = price;
+    touch(MarketFactor(FactorKind::Spot, stockName));
 }
 
 // ===== Accessors =====
@@ -108,6 +183,56 @@ shared_ptr<VolCurve> Market::getVolCurve(const string& name) const {
     return it->second;
 }
 
+shared_ptr<SwaptionVolCube> Market::getSwaptionVolCube(const string& name) const {
+    string key = toUpper(name);
+    auto it = swaptionVols.find(key);
+    if (it == swaptionVols.end()) {
+        cerr << "[ERROR] Swaption vol cube not found in market: " << key << endl;
+        cerr << "Available swaption vol cubes are:\n";
+        for (const auto& [k, _] : swaptionVols)
+            cerr << "  - " << k << endl;
+        throw runtime_error("Swaption vol cube not found: " + key);
+    }
+    return it->second;
+}
+
+bool Market::hasSwaptionVolCube(const string& name) const {
+    return swaptionVols.count(toUpper(name)) > 0;
+}
+
+vector<string> Market::getSwaptionVolCubeNames() const {
+    vector<string> names;
+    for (const auto& [k, _] : swaptionVols)
+        names.push_back(k);
+    sort(names.begin(), names.end());
+    return names;
+}
+
+shared_ptr<ImpliedVolSurface> Market::getVolSurface(const string& underlying) const {
+    string key = toUpper(underlying);
+    auto it = volSurfaces.find(key);
+    if (it == volSurfaces.end()) {
+        cerr << "[ERROR] Implied vol surface not found in market: " << key << endl;
+        cerr << "Available implied vol surfaces are:\n";
+        for (const auto& [k, _] : volSurfaces)
+            cerr << "  - " << k << endl;
+        throw runtime_error("Implied vol surface not found: " + key);
+    }
+    return it->second;
+}
+
+bool Market::hasVolSurface(const string& underlying) const {
+    return volSurfaces.count(toUpper(underlying)) > 0;
+}
+
+vector<string> Market::getVolSurfaceNames() const {
+    vector<string> names;
+    for (const auto& [k, _] : volSurfaces)
+        names.push_back(k);
+    sort(names.begin(), names.end());
+    return names;
+}
+
 double Market::getStockPrice(const string& name) const {
     string key = toUpper(name);
     auto it = stockPrices.find(key);
@@ -131,24 +256,75 @@ void Market::shockPrice(const string& symbol, double bump) {
     auto it = stockPrices.find(key);
     if (it != stockPrices.end()) {
         it->second *= (1.0 + bump);
+        touch(MarketFactor(FactorKind::Spot, key));
     }
     else {
         cerr << "[WARN] Market::shockPrice - Stock not found: " << key << endl;
     }
 }
 
+// ===== Versioning =====
+
+uint64_t Market::version(const MarketFactor& factor) const {
+    if (factor.kind == FactorKind::Any) {
+        uint64_t latest = 0;
+        for (const auto& kv : versions) latest = max(latest, kv.second);
+        return latest;
+    }
+    auto it = versions.find(factor);
+    return it == versions.end() ? 0 : it->second;
+}
+
+void Market::touch(const MarketFactor& factor) {
+    if (factor.kind == FactorKind::Any) {
+        for (auto& kv : versions) kv.second = nextVersion();
+        return;
+    }
+    versions[factor] = nextVersion();
+}
+
+uint64_t Market::stateKey(const vector<MarketFactor>& factors) const {
+    uint64_t h = util::kHashSeed;
+    auto mix = [&h](uint64_t x) { h = util::hashMix(h, x); };
+
+    mix(static_cast<uint64_t>(asOf.getSerialDate()));
+    for (const auto& f : factors) {
+        if (f.kind == FactorKind::Any) {
+            // Wildcard readers see everything; removals change the key through the count
+            mix(versions.size());
+            for (const auto& kv : versions) mix(kv.second);
+            continue;
+        }
+        mix(static_cast<uint64_t>(f.kind));
+        mix(version(f));
+    }
+    return h;
+}
+
+vector<MarketFactor> Market::getFactors() const {
+    vector<MarketFactor> out;
+    for (const auto& kv : curves) out.emplace_back(FactorKind::Curve, kv.first);
+    for (const auto& kv : vols) out.emplace_back(FactorKind::Vol, kv.first);
+    for (const auto& kv : swaptionVols) out.emplace_back(FactorKind::SwaptionCube, kv.first);
+    for (const auto& kv : volSurfaces) out.emplace_back(FactorKind::VolSurface, kv.first);
+    for (const auto& kv : stockPrices) out.emplace_back(FactorKind::Spot, kv.first);
+    for (const auto& kv : bondPrices) out.emplace_back(FactorKind::BondPrice, kv.first);
+    sort(out.begin(), out.end());
+    return out;
+}
+
 // ===== File Loaders =====
 
 void Market::loadCurveFromFile(const string& filename) {
     auto curve = make_shared<RateCurve>();
     curve->loadFromFile(filename, asOf);
-    curves[toUpper(curve->getName())] = curve;
+    addCurve(curve->getName(), curve);
 }
 
 void Market::loadVolFromFile(const string& filename) {
     auto vol = make_shared<VolCurve>();
     vol->loadFromFile(filename, asOf);
-    vols[toUpper(vol->getName())] = vol;
+    addVolCurve(vol->getName(), vol);
 }
 
 void Market::loadStockPriceFromFile(const string& filename) {
@@ -164,7 +340,7 @@ void Market::loadStockPriceFromFile(const string& filename) {
         string priceStr = trim(line.substr(colon + 1));
         try {
             double price = stod(priceStr);
-            stockPrices[name] = price;
+            addStockPrice(name, price);
         }
         catch (...) {
             cerr << "[ERROR] Invalid stock price for " << name << ": " << priceStr << endl;
@@ -185,7 +361,7 @@ void Market::loadBondPriceFromFile(const string& filename) {
         string priceStr = trim(line.substr(colon + 1));
         try {
             double price = stod(priceStr);
-            bondPrices[name] = price;
+            addBondPrice(name, price);
         }
         catch (...) {
             cerr << "[ERROR] Invalid bond price for " << name << ": " << priceStr << endl;
@@ -206,6 +382,14 @@ void Market::Print() const {
     for (const auto& [_, vol] : vols)
         vol->display();
 
+    cout << "--- Swaption Vol Cubes ---" << endl;
+    for (const auto& [_, cube] : swaptionVols)
+        cube->display();
+
+    cout << "--- Implied Vol Surfaces ---" << endl;
+    for (const auto& [_, surface] : volSurfaces)
+        surface->display();
+
     cout << "--- Bond Prices ---" << endl;
     for (const auto& [k, v] : bondPrices)
         cout << k << ": " << v << endl;
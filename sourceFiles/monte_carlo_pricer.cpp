@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "monte_carlo_pricer.h"
+#include "black_scholes_pricer.h"
+#include "european_trade.h"
+#include "helper.h"
+
+// ===========================
+// McMoments
+// ===========================
+void McMoments::add(double y, double x) {
+    n += 1.0;
+    sy += y; syy += y * y;
+    sx += x; sxx += x * x; sxy += x * y;
+}
+
+void McMoments::add(const McMoments& o) {
+    n += o.n; sy += o.sy; syy += o.syy;
+    sx += o.sx; sxx += o.sxx; sxy += o.sxy;
+}
+
+void McMoments::estimate(bool useControl, double exactControl, double& mean, double& variance) const {
+    const double meanY = sy / n;
+    mean = meanY;
+    variance = n > 1.0 ? (syy - n * meanY * meanY) / (n - 1.0) : 0.0;
+
+    if (!useControl || n <= 1.0) return;
+
+    const double meanX = sx / n;
+    const double varX = (sxx - n * meanX * meanX) / (n - 1.0);
+    const double covXY = (sxy - n * meanX * meanY) / (n - 1.0);
+    if (varX > 0.0) {
+        const double beta = covXY / varX;
+        mean = meanY - beta * (meanX - exactControl);
+        variance -= covXY * covXY / varX;
+    }
+}
+
+McResult combineReplicates(const std::vector<McMoments>& reps, bool useControl, double exactControl) {
+    McResult res;
+    const size_t nRep = reps.size();
+    if (nRep == 1) {
+        double variance;
+        reps[0].estimate(useControl, exactControl, res.price, variance);
+        res.stdError = std::sqrt(std::max(variance, 0.0) / reps[0].n);
+        return res;
+    }
+
+    // Randomized QMC: replicate estimates are i.i.d., their spread gives the error
+    std::vector<double> est(nRep);
+    for (size_t r = 0; r < nRep; ++r) {
+        double variance;
+        reps[r].estimate(useControl, exactControl, est[r], variance);
+    }
+    res.price = util::pairwiseSum(est) / static_cast<double>(nRep);
+    double ss = 0.0;
+    for (double e : est) ss += (e - res.price) * (e - res.price);
+    res.stdError = std::sqrt(ss / static_cast<double>(nRep - 1) / static_cast<double>(nRep));
+    return res;
+}
+
+// ===========================
+// Constructor
+// ===========================
+MonteCarloPricer::MonteCarloPricer(size_t paths, uint64_t rngSeed, ThreadPool& threadPool)
+    : nPaths(paths), seed(rngSeed), pool(threadPool) {
+    if (nPaths == 0)
+        throw std::invalid_argument("Monte Carlo pricer needs at least one path");
+}
+
+void MonteCarloPricer::setTimeSteps(size_t steps) {
+    if (steps == 0)
+        throw std::invalid_argument("Monte Carlo pricer needs at least one time step");
+    timeSteps = steps;
+}
+
+void MonteCarloPricer::setReplicates(size_t count) {
+    if (count == 0)
+        throw std::invalid_argument("Monte Carlo pricer needs at least one replicate");
+    replicates = count;
+}
+
+// ===========================
+// Path Block Simulation
+// ===========================
+McMoments MonteCarloPricer::simulateBlock(const PathGenerator& gen, uint32_t replicate,
+    uint64_t block, size_t blockPaths, const GbmInputs& in, const Trade& trade) const {
+    const size_t nDraws = antithetic ? blockPaths / 2 : blockPaths;
+    const size_t n = gen.steps();
+
+    std::vector<double> z(n * nDraws), w(n * nDraws), sUp(n * nDraws), sDown;
+    gen.normals(block * nDraws, nDraws, replicate, z.data());
+    gen.brownian(z.data(), nDraws, w.data());
+    gen.spots(in.gbm, w.data(), nDraws, 1.0, sUp.data());
+    if (antithetic) {
+        sDown.resize(n * nDraws);
+        gen.spots(in.gbm, w.data(), nDraws, -1.0, sDown.data());
+    }
+
+    // European payoffs only need the terminal row
+    const double* upT = sUp.data() + (n - 1) * nDraws;
+    const double* downT = antithetic ? sDown.data() + (n - 1) * nDraws : nullptr;
+
+    auto control = [&in](double S) {
+        return in.controlIsCall ? std::max(S - in.controlStrike, 0.0) : std::max(in.controlStrike - S, 0.0);
+    };
+
+    McMoments m;
+    for (size_t i = 0; i < nDraws; ++i) {
+        if (antithetic)
+            m.add(0.5 * (trade.payoff(upT[i]) + trade.payoff(downT[i])) * in.df,
+                0.5 * (control(upT[i]) + control(downT[i])) * in.df);
+        else
+            m.add(trade.payoff(upT[i]) * in.df, control(upT[i]) * in.df);
+    }
+    return m;
+}
+
+// ===========================
+// Pricing
+// ===========================
+double MonteCarloPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    return priceWithError(mkt, trade).price;
+}
+
+McResult MonteCarloPricer::priceWithError(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    if (!trade) throw std::invalid_argument("Null trade pointer");
+    if (!std::dynamic_pointer_cast<EuropeanOption>(trade) && !std::dynamic_pointer_cast<EuroCallSpread>(trade))
+        throw std::runtime_error("Monte Carlo pricer only supports EuropeanOption and EuroCallSpread");
+
+    // Same market inputs as BlackScholesPricer, so the control expectation is exact
+    GbmInputs in;
+    in.gbm.spot = mkt.getStockPrice(trade->getUnderlying());
+    in.T = trade->getExpiry() - mkt.asOf;
+    in.gbm.vol = mkt.getVolCurve("LOGVOL")->getVol(trade->getExpiry());
+    in.gbm.rate = mkt.getCurve(trade->getRateCurve())->getRate(trade->getExpiry());
+    in.df = std::exp(-in.gbm.rate * in.T);
+    in.controlStrike = trade->getStrike();
+    in.controlIsCall = trade->getOptionType() != OptionType::Put;
+
+    McResult res;
+    if (in.T <= 0.0 || in.gbm.vol <= 0.0) {
+        res.price = trade->payoff(in.gbm.spot);
+        return res;
+    }
+
+    std::vector<double> times(timeSteps);
+    for (size_t k = 0; k < timeSteps; ++k)
+        times[k] = in.T * static_cast<double>(k + 1) / static_cast<double>(timeSteps);
+    PathGenerator gen(times, sampling, seed);
+
+    double exactX = 0.0;
+    if (controlVariate) {
+        auto ctrl = std::make_shared<EuropeanOption>(in.controlIsCall ? OptionType::Call : OptionType::Put,
+            1.0, in.controlStrike, trade->getTradeDate(), trade->getExpiry(), trade->getUnderlying());
+        exactX = BlackScholesPricer().price(mkt, ctrl);
+    }
+
+    // Pseudo-random sampling is a single replicate
+    const size_t nRep = sampling == Sampling::Sobol ? replicates : 1;
+    const size_t perRep = (nPaths + nRep - 1) / nRep;
+
+    // Power-of-two blocks keep every Sobol block a balanced segment of the sequence
+    size_t blockPaths = 2;
+    while (blockPaths < perRep && blockPaths < kBlockPaths) blockPaths <<= 1;
+    const size_t nBlocks = (perRep + blockPaths - 1) / blockPaths;
+
+    std::vector<McMoments> blocks(nRep * nBlocks);
+    pool.parallel_for(0, blocks.size(), 1, [&](size_t i) {
+        blocks[i] = simulateBlock(gen, static_cast<uint32_t>(i / nBlocks), i % nBlocks, blockPaths, in, *trade);
+    });
+
+    // Fixed-order reduction keeps results bit-identical across thread counts
+    std::vector<McMoments> reps(nRep);
+    for (size_t i = 0; i < blocks.size(); ++i)
+        reps[i / nBlocks].add(blocks[i]);
+
+    const size_t paths = nRep * nBlocks * blockPaths;
+    res = combineReplicates(reps, controlVariate, exactX);
+    res.paths = paths;
+    return res;
+}
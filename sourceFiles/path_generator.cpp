@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <cmath>
+
+#include "path_generator.h"
+#include "helper.h"
+
+namespace {
+    const uint32_t kShiftStream = 0x50B01u;   // Counter word reserved for digital shifts
+}
+
+// ===========================
+// Constructor
+// ===========================
+PathGenerator::PathGenerator(std::vector<double> grid, Sampling method, uint64_t seed)
+    : times(std::move(grid)), sampling(method), rng(seed), bridge(times) {
+    if (sampling == Sampling::Sobol)
+        sobol = std::make_unique<SobolSequence>(std::min(times.size(), SobolSequence::kMaxDimensions));
+}
+
+// ===========================
+// Normal Draws
+// ===========================
+void PathGenerator::normals(uint64_t first, size_t count, uint32_t replicate, double* z) const {
+    const size_t n = steps();
+    std::vector<double> u(n * count);
+
+    size_t qmcDims = 0;
+    if (sobol) {
+        qmcDims = sobol->dimensions();
+        std::vector<uint32_t> shift(qmcDims);
+        for (size_t d = 0; d < qmcDims; ++d)
+            shift[d] = rng(Philox4x32::Counter{ static_cast<uint32_t>(d), replicate, 0, kShiftStream })[0];
+        sobol->uniforms(first, count, shift.data(), u.data());
+    }
+
+    // Pseudo-random dimensions: counter (replicate, group of 4 paths, dimension)
+    double lanes[4];
+    for (size_t d = qmcDims; d < n; ++d) {
+        double* ud = u.data() + d * count;
+        for (uint64_t q = first; q < first + count;) {
+            const uint64_t group = q / 4;
+            rng.uniforms(static_cast<uint32_t>(d), group, replicate, lanes);
+            for (size_t lane = q % 4; lane < 4 && q < first + count; ++lane, ++q)
+                ud[q - first] = lanes[lane];
+        }
+    }
+
+    util::invNormCdf(u.data(), z, n * count);
+}
+
+// ===========================
+// GBM Spots
+// ===========================
+void PathGenerator::spots(const GbmParams& gbm, const double* w, size_t count, double sign, double* s) const {
+    const double mu = gbm.rate - 0.5 * gbm.vol * gbm.vol;
+    const double sv = sign * gbm.vol;
+    for (size_t k = 0; k < steps(); ++k) {
+        const double drift = mu * times[k];
+        const double* wk = w + k * count;
+        double* sk = s + k * count;
+        for (size_t p = 0; p < count; ++p)
+            sk[p] = gbm.spot * std::exp(drift + sv * wk[p]);
+    }
+}
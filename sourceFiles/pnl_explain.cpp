@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+#include "pnl_explain.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+
+namespace {
+    // Factor groups moved one at a time from yesterday's to today's values
+    enum Group { Rates = 1, Spots = 2, Vols = 4, AllGroups = 7 };
+
+    int groupOf(FactorKind kind) {
+        switch (kind) {
+        case FactorKind::Curve:
+        case FactorKind::BondPrice:    return Rates;
+        case FactorKind::Spot:         return Spots;
+        case FactorKind::Vol:
+        case FactorKind::SwaptionCube:
+        case FactorKind::VolSurface:   return Vols;
+        case FactorKind::Any:          return AllGroups;
+        }
+        return AllGroups;
+    }
+
+    // Deterministic column sums, as PortfolioValuer aggregates
+    PnlAttribution sumRows(const string& key, const vector<const PnlAttribution*>& rows) {
+        PnlAttribution out;
+        out.key = key;
+        out.tradeCount = rows.size();
+        vector<double> col(rows.size());
+        auto reduce = [&](double PnlAttribution::* field) {
+            for (size_t i = 0; i < rows.size(); ++i) col[i] = rows[i]->*field;
+            return util::pairwiseSum(col);
+        };
+        out.pvStart = reduce(&PnlAttribution::pvStart);
+        out.pvEnd = reduce(&PnlAttribution::pvEnd);
+        out.carry = reduce(&PnlAttribution::carry);
+        out.rates = reduce(&PnlAttribution::rates);
+        out.delta = reduce(&PnlAttribution::delta);
+        out.gamma = reduce(&PnlAttribution::gamma);
+        out.vega = reduce(&PnlAttribution::vega);
+        out.unexplained = reduce(&PnlAttribution::unexplained);
+        return out;
+    }
+}
+
+// ===== Revaluation Markets =====
+
+struct PnlExplainer::Stage {
+    unique_ptr<Market> owned;
+    const Market* mkt = nullptr;
+    vector<double> dfs;
+    const vector<double>* tableDfs = nullptr;
+
+    // Overlay of `from` with every factor of the listed groups taken from `today`
+    static void build(Stage& s, const Market& from, const Market& today, int groups,
+        const vector<MarketFactor>& factors) {
+        s.owned.reset(new Market(from.overlay()));
+        s.owned->asOf = today.asOf;
+        for (const auto& f : factors)
+            if (groupOf(f.kind) & groups) s.owned->copyFactor(today, f);
+        s.mkt = s.owned.get();
+    }
+
+    void evaluate(const DiscountTable& table) {
+        table.evaluate(*mkt, dfs);
+        tableDfs = &dfs;
+    }
+};
+
+// ===== Constructor =====
+
+PnlExplainer::PnlExplainer(const vector<shared_ptr<Trade>>& portfolio,
+    shared_ptr<const DiscountTable> table,
+    ThreadPool& threadPool)
+    : trades(portfolio), pool(threadPool), dfTable(move(table))
+{
+    if (!dfTable)
+        dfTable = DiscountTable::build(trades);
+}
+
+// ===== Explain =====
+
+const vector<PnlAttribution>& PnlExplainer::explain(const Market& yesterday, const Market& today) {
+    const bool waterfall = mode == ExplainMode::Waterfall;
+
+    // Every factor in either snapshot; factors only yesterday has are dropped on copy
+    set<MarketFactor> unionSet;
+    for (const auto& f : yesterday.getFactors()) unionSet.insert(f);
+    for (const auto& f : today.getFactors()) unionSet.insert(f);
+    const vector<MarketFactor> factors(unionSet.begin(), unionSet.end());
+
+    enum { Start, Rolled, RatesMoved, SpotsMoved, VolsMoved, End, StageCount };
+    vector<Stage> stages(StageCount);
+    stages[Start].mkt = &yesterday;
+    Stage::build(stages[Rolled], yesterday, today, 0, factors);
+    Stage::build(stages[RatesMoved], *stages[Rolled].mkt, today, Rates, factors);
+    const Market& preSpot = waterfall ? *stages[RatesMoved].mkt : *stages[Rolled].mkt;
+    Stage::build(stages[SpotsMoved], preSpot, today, Spots, factors);
+    Stage::build(stages[VolsMoved], waterfall ? *stages[SpotsMoved].mkt : *stages[Rolled].mkt, today, Vols, factors);
+    stages[End].mkt = &today;
+
+    pool.parallel_for(0, stages.size(), 1, [&](size_t k) { stages[k].evaluate(*dfTable); });
+
+    // One up/down pair per spot present on both days, bumped from the pre-spot market
+    struct SpotBump {
+        double spot = 0.0;
+        double move = 0.0;
+        Stage up, down;
+    };
+    map<string, SpotBump> bumps;
+    for (const auto& f : factors) {
+        if (f.kind != FactorKind::Spot) continue;
+        double s0, s1;
+        try {
+            s0 = preSpot.getStockPrice(f.name);
+            s1 = today.getStockPrice(f.name);
+        }
+        catch (const exception&) {
+            continue;   // Listed or delisted today: its spot P&L stays unexplained
+        }
+        SpotBump& b = bumps[f.name];
+        b.spot = s0;
+        b.move = s1 - s0;
+        for (auto [stage, sign] : { make_pair(&b.up, 1.0), make_pair(&b.down, -1.0) }) {
+            stage->owned.reset(new Market(preSpot.overlay()));
+            stage->owned->addStockPrice(f.name, s0 * (1.0 + sign * spotBump));
+            stage->mkt = stage->owned.get();
+            stage->tableDfs = waterfall ? stages[RatesMoved].tableDfs : stages[Rolled].tableDfs;   // Spots leave DFs unchanged
+        }
+    }
+
+    results.assign(trades.size(), PnlAttribution());
+    vector<size_t> counts(trades.size(), 0);
+
+    pool.parallel_for_range(0, trades.size(), chunkSize, [&](size_t lo, size_t hi) {
+        CRRBinomialTreePricer pricer(50);   // Tree pricers carry per-call state; one per task
+        for (size_t i = lo; i < hi; ++i) {
+            const auto& trade = trades[i];
+            auto value = [&](const Stage& s) {
+                ++counts[i];
+                return trade->usesDiscountTable() ? trade->pvFromTable(*s.tableDfs, *s.mkt) : pricer.price(*s.mkt, trade);
+            };
+
+            int reads = 0;
+            vector<string> spots;
+            for (const auto& f : trade->getMarketDependencies()) {
+                reads |= groupOf(f.kind);
+                if (f.kind == FactorKind::Spot) spots.push_back(f.name);
+            }
+
+            PnlAttribution& r = results[i];
+            r.key = trade->getId();
+            r.tradeCount = 1;
+            r.pvStart = value(stages[Start]);
+            const double rolled = value(stages[Rolled]);
+            r.carry = rolled - r.pvStart;
+
+            double prev = rolled;
+            auto step = [&](int group, int stage) {
+                double pv = (reads & group) ? value(stages[stage]) : prev;
+                double move = pv - prev;
+                if (waterfall) prev = pv;
+                return move;
+            };
+            r.rates = step(Rates, RatesMoved);
+
+            const double basePreSpot = prev;
+            const double spotMove = step(Spots, SpotsMoved);
+            if (reads & Spots) {
+                // Taylor split of the spot step around the pre-spot market
+                for (const auto& name : spots) {
+                    auto it = bumps.find(name);
+                    if (it == bumps.end() || it->second.spot == 0.0) continue;
+                    const SpotBump& b = it->second;
+                    const double h = spotBump * b.spot;
+                    const double up = value(b.up), down = value(b.down);
+                    r.delta += (up - down) / (2.0 * h) * b.move;
+                    r.gamma += 0.5 * (up - 2.0 * basePreSpot + down) / (h * h) * b.move * b.move;
+                }
+            }
+            r.vega = step(Vols, VolsMoved);
+
+            if (waterfall) {
+                r.pvEnd = prev;
+                r.unexplained = spotMove - r.delta - r.gamma;
+            }
+            else {
+                r.pvEnd = reads ? value(stages[End]) : rolled;
+                r.unexplained = r.total() - r.carry - r.rates - r.delta - r.gamma - r.vega;
+            }
+        }
+    });
+
+    revalCount = 0;
+    for (size_t c : counts) revalCount += c;
+    return results;
+}
+
+// ===== Aggregation =====
+
+vector<PnlAttribution> PnlExplainer::aggregate(AggregateBy level) const {
+    map<string, vector<const PnlAttribution*>> groups;
+    for (size_t i = 0; i < results.size(); ++i)
+        groups[aggregateKey(*trades[i], level)].push_back(&results[i]);
+
+    vector<PnlAttribution> out;
+    out.reserve(groups.size());
+    for (const auto& [key, rows] : groups)
+        out.push_back(sumRows(key, rows));
+    return out;
+}
+
+PnlAttribution PnlExplainer::total() const {
+    vector<const PnlAttribution*> rows;
+    rows.reserve(results.size());
+    for (const auto& r : results) rows.push_back(&r);
+    return sumRows("TOTAL", rows);
+}
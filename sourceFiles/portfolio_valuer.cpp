@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+#include "portfolio_valuer.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+
+// ===== Constructor =====
+
+PortfolioValuer::PortfolioValuer(const Market& mkt,
+    const vector<shared_ptr<Trade>>& portfolio,
+    double curveShock,
+    double volShock,
+    ThreadPool& threadPool)
+    : market(mkt), trades(portfolio), pool(threadPool),
+    curveShockSize(curveShock), volShockSize(volShock),
+    engine(mkt, curveShock, volShock, 0.0),
+    swaptionPricer(portfolio, threadPool)
+{
+    dfTable = DiscountTable::build(trades);
+    dfTable->evaluate(market, baseDfs);
+    engine.setDiscountTable(dfTable);
+
+    // Group homogeneous trades so a chunk shares curves, vols and code paths
+    order.resize(trades.size());
+    iota(order.begin(), order.end(), size_t(0));
+    stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        const Trade& ta = *trades[a];
+        const Trade& tb = *trades[b];
+        if (ta.getType() != tb.getType()) return ta.getType() < tb.getType();
+        return ta.getUnderlying() < tb.getUnderlying();
+    });
+    rank.resize(order.size());
+    for (size_t k = 0; k < order.size(); ++k) rank[order[k]] = k;
+
+    batched.resize(trades.size());
+    swaptionSlot.assign(trades.size(), string::npos);
+    const auto& swaptions = swaptionPricer.getSwaptions();
+    for (size_t i = 0, s = 0; i < trades.size(); ++i) {
+        if (s < swaptions.size() && swaptions[s] == trades[i]) swaptionSlot[i] = s++;
+        batched[i] = ExoticBatchPricer::batches(*trades[i]) || swaptionSlot[i] != string::npos;
+    }
+
+    // Inverted index: market factor -> dependent trades, in portfolio order
+    for (size_t i = 0; i < trades.size(); ++i) {
+        for (const auto& f : trades[i]->getMarketDependencies()) {
+            auto& list = f.kind == FactorKind::Any ? wildcardTrades : dependencyIndex[f];
+            if (list.empty() || list.back() != i) list.push_back(i);
+        }
+    }
+}
+
+void PortfolioValuer::setCache(ValuationCache* valuationCache) {
+    cache = valuationCache;
+    engine.setCache(valuationCache);
+}
+
+// ===== Valuation =====
+
+void PortfolioValuer::valueTrade(size_t i, TradeResult& r) const {
+    valueInto(trades[i], true, r);
+    r.id = i + 1;
+}
+
+void PortfolioValuer::valueInto(const shared_ptr<Trade>& trade, bool bound, TradeResult& r) const {
+    r = TradeResult();
+    r.tradeInfo = trade->getType() + " " + trade->getUnderlying();
+
+    if (trade->usesDiscountTable()) {
+        r.PV = bound ? trade->pvFromTable(baseDfs, market) : trade->pv(market);
+    }
+    else {
+        auto treePv = [&] {
+            CRRBinomialTreePricer pricer(50);  // Tree pricers carry per-call state; one per task
+            return pricer.price(market, trade);
+        };
+        r.PV = cache ? cache->getOrCompute(ValuationKey::of(*trade, market, ValuationMethod::TreePv), treePv) : treePv();
+    }
+
+    addRisk(r, engine.evaluateRisk("dv01", trade, true, bound), engine.evaluateRisk("vega", trade, true, bound));
+}
+
+void PortfolioValuer::addRisk(TradeResult& r, const map<string, double>& dv01, const map<string, double>& vega) const {
+    for (const auto& [id, v] : dv01) {
+        r.dv01Buckets[id] = v / (2.0 * curveShockSize);
+        r.DV01 += v / (2.0 * curveShockSize);
+    }
+
+    for (const auto& [id, v] : vega) {
+        r.vegaBuckets[id] = v / volShockSize;
+        r.Vega += v / volShockSize;
+    }
+}
+
+// Cached PVs are looked up per trade; only the misses go to the batch pricer
+vector<double> PortfolioValuer::batchPv(const Market& mkt, const vector<shared_ptr<Trade>>& batch) const {
+    vector<double> pv(batch.size(), 0.0);
+    vector<shared_ptr<Trade>> misses;
+    vector<size_t> slots;
+    vector<ValuationKey> keys;
+    for (size_t k = 0; k < batch.size(); ++k) {
+        if (cache) {
+            ValuationKey key = ValuationKey::of(*batch[k], mkt, ValuationMethod::Pv);
+            if (cache->find(key, pv[k])) continue;
+            keys.push_back(key);
+        }
+        misses.push_back(batch[k]);
+        slots.push_back(k);
+    }
+    if (misses.empty()) return pv;
+
+    const vector<double> priced = exoticPricer.price(mkt, misses);
+    for (size_t j = 0; j < slots.size(); ++j) {
+        pv[slots[j]] = priced[j];
+        if (cache) cache->insert(keys[j], priced[j]);
+    }
+    return pv;
+}
+
+// Splits batched trades into the exotic and the swaption batch
+void PortfolioValuer::valueBatches(const vector<size_t>& idx) {
+    vector<size_t> exotics, swaptions;
+    for (size_t i : idx)
+        (swaptionSlot[i] != string::npos ? swaptions : exotics).push_back(i);
+
+    vector<shared_ptr<Trade>> batch;
+    for (size_t i : exotics) batch.push_back(trades[i]);
+    valueBatch(exotics, [this, &batch](const Market& mkt) { return batchPv(mkt, batch); });
+
+    // The batch prices every swaption; a partial update keeps the ones it needs
+    valueBatch(swaptions, [this, &swaptions](const Market& mkt) {
+        const vector<SwaptionQuote> quotes = swaptionPricer.price(mkt);
+        vector<double> pv(swaptions.size());
+        for (size_t k = 0; k < swaptions.size(); ++k) pv[k] = quotes[swaptionSlot[swaptions[k]]].pv;
+        return pv;
+    });
+}
+
+void PortfolioValuer::valueBatch(const vector<size_t>& idx, const RiskEngine::BatchPricing& price) {
+    if (idx.empty()) return;
+
+    const vector<double> pv = price(market);
+    const auto dv01 = engine.evaluateRiskBatch("dv01", idx.size(), price);
+    const auto vega = engine.evaluateRiskBatch("vega", idx.size(), price);
+
+    for (size_t k = 0; k < idx.size(); ++k) {
+        const Trade& trade = *trades[idx[k]];
+        TradeResult& r = results[idx[k]];
+        r = TradeResult();
+        r.id = idx[k] + 1;
+        r.tradeInfo = trade.getType() + " " + trade.getUnderlying();
+        r.PV = pv[k];
+        addRisk(r, dv01[k], vega[k]);
+    }
+}
+
+TradeResult PortfolioValuer::valueExternal(const shared_ptr<Trade>& trade) const {
+    if (!trade) throw invalid_argument("Null trade pointer");
+    TradeResult r;
+    valueInto(trade, false, r);
+    return r;
+}
+
+long PortfolioValuer::findTrade(const string& id) const {
+    for (size_t i = 0; i < trades.size(); ++i)
+        if (trades[i]->getId() == id) return static_cast<long>(i);
+    return -1;
+}
+
+const vector<TradeResult>& PortfolioValuer::run() {
+    results.assign(trades.size(), TradeResult());
+
+    vector<size_t> batch;
+    for (size_t i : order)
+        if (batched[i]) batch.push_back(i);
+    valueBatches(batch);
+
+    pool.parallel_for_range(0, order.size(), chunkSize, [this](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k) {
+            size_t i = order[k];
+            if (!batched[i]) valueTrade(i, results[i]);
+        }
+    });
+
+    return results;
+}
+
+// ===== Incremental Repricing =====
+
+vector<size_t> PortfolioValuer::dependents(const MarketFactor& factor) const {
+    vector<char> hit(trades.size(), 0);
+    if (factor.kind == FactorKind::Any) {
+        fill(hit.begin(), hit.end(), 1);
+    }
+    else {
+        auto it = dependencyIndex.find(factor);
+        if (it != dependencyIndex.end())
+            for (size_t i : it->second) hit[i] = 1;
+        for (size_t i : wildcardTrades) hit[i] = 1;
+    }
+
+    vector<size_t> out;
+    for (size_t i = 0; i < hit.size(); ++i)
+        if (hit[i]) out.push_back(i);
+    return out;
+}
+
+size_t PortfolioValuer::update(const vector<MarketFactor>& moved) {
+    if (moved.empty()) return 0;
+
+    // Bumped risk markets and discount factors follow the live market first
+    engine.refresh(market, moved);
+    const bool curveMoved = any_of(moved.begin(), moved.end(), [](const MarketFactor& f) {
+        return f.kind == FactorKind::Curve || f.kind == FactorKind::Any;
+    });
+    if (curveMoved)
+        dfTable->evaluate(market, baseDfs);
+
+    if (results.size() != trades.size()) {
+        run();
+        return trades.size();
+    }
+
+    vector<char> dirty(trades.size(), 0);
+    for (const auto& f : moved)
+        for (size_t i : dependents(f)) dirty[i] = 1;
+
+    // Reprice in valuation order so chunks stay homogeneous
+    vector<size_t> work, batch;
+    for (size_t i = 0; i < trades.size(); ++i)
+        if (dirty[i]) (batched[i] ? batch : work).push_back(i);
+    sort(work.begin(), work.end(), [this](size_t a, size_t b) { return rank[a] < rank[b]; });
+    valueBatches(batch);
+
+    pool.parallel_for_range(0, work.size(), chunkSize, [this, &work](size_t lo, size_t hi) {
+        for (size_t k = lo; k < hi; ++k)
+            valueTrade(work[k], results[work[k]]);
+    });
+    return work.size() + batch.size();
+}
+
+// ===== Aggregation =====
+
+string aggregateKey(const Trade& trade, AggregateBy level) {
+    switch (level) {
+    case AggregateBy::Book:
+        return trade.getBook();
+    case AggregateBy::Underlying:
+        return trade.getUnderlying();
+    case AggregateBy::Curve:
+        return trade.getRateCurve();
+    }
+    return "";
+}
+
+vector<AggregateResult> PortfolioValuer::aggregate(AggregateBy level) const {
+    struct Columns {
+        vector<double> pv, dv01, vega;
+    };
+
+    // Gather in trade order, then reduce each column in that fixed order
+    map<string, Columns> groups;
+    for (size_t i = 0; i < results.size(); ++i) {
+        Columns& c = groups[aggregateKey(*trades[i], level)];
+        c.pv.push_back(results[i].PV);
+        c.dv01.push_back(results[i].DV01);
+        c.vega.push_back(results[i].Vega);
+    }
+
+    vector<AggregateResult> out;
+    out.reserve(groups.size());
+    for (const auto& [key, c] : groups) {
+        AggregateResult a;
+        a.key = key;
+        a.tradeCount = c.pv.size();
+        a.PV = util::pairwiseSum(c.pv);
+        a.DV01 = util::pairwiseSum(c.dv01);
+        a.Vega = util::pairwiseSum(c.vega);
+        out.push_back(a);
+    }
+    return out;
+}
+
+AggregateResult PortfolioValuer::total() const {
+    vector<double> pv, dv01, vega;
+    pv.reserve(results.size());
+    dv01.reserve(results.size());
+    vega.reserve(results.size());
+    for (const auto& r : results) {
+        pv.push_back(r.PV);
+        dv01.push_back(r.DV01);
+        vega.push_back(r.Vega);
+    }
+
+    AggregateResult a;
+    a.key = "TOTAL";
+    a.tradeCount = results.size();
+    a.PV = util::pairwiseSum(pv);
+    a.DV01 = util::pairwiseSum(dv01);
+    a.Vega = util::pairwiseSum(vega);
+    return a;
+}
@@ -0,0 +1,575 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "pricing_server.h"
+#include "trade_loader.h"
+#include "rate_curve.h"
+#include "vol_curve.h"
+#include "swaption_vol_cube.h"
+#include "implied_vol_surface.h"
+
+using namespace std;
+
+// ===== Platform Socket Helpers =====
+
+namespace {
+
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+    const SocketHandle kInvalid = INVALID_SOCKET;
+    void closeSocket(SocketHandle s) { closesocket(s); }
+    void shutdownSocket(SocketHandle s) { shutdown(s, SD_BOTH); }
+    void removePath(const string& path) { DeleteFileA(path.c_str()); }
+
+    struct WinsockInit {
+        WinsockInit() { WSADATA d; WSAStartup(MAKEWORD(2, 2), &d); }
+        ~WinsockInit() { WSACleanup(); }
+    };
+    void ensureSockets() { static WinsockInit init; }
+#else
+    using SocketHandle = int;
+    const SocketHandle kInvalid = -1;
+    void closeSocket(SocketHandle s) { ::close(s); }
+    void shutdownSocket(SocketHandle s) { ::shutdown(s, SHUT_RDWR); }
+    void removePath(const string& path) { ::unlink(path.c_str()); }
+    void ensureSockets() {}
+#endif
+
+#ifdef MSG_NOSIGNAL
+    const int kSendFlags = MSG_NOSIGNAL;   // A vanished client must not raise SIGPIPE in the daemon
+#else
+    const int kSendFlags = 0;
+#endif
+
+    SocketHandle toHandle(intptr_t s) { return static_cast<SocketHandle>(s); }
+
+    sockaddr_un socketAddress(const string& path) {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path))
+            throw invalid_argument("Socket path too long: " + path);
+        memcpy(addr.sun_path, path.c_str(), path.size());
+        return addr;
+    }
+
+    bool sendAll(SocketHandle s, const uint8_t* data, size_t n) {
+        while (n > 0) {
+            auto sent = send(s, reinterpret_cast<const char*>(data), static_cast<int>(n), kSendFlags);
+            if (sent <= 0) return false;
+            data += sent;
+            n -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    bool recvAll(SocketHandle s, uint8_t* data, size_t n) {
+        while (n > 0) {
+            auto got = recv(s, reinterpret_cast<char*>(data), static_cast<int>(n), 0);
+            if (got <= 0) return false;
+            data += got;
+            n -= static_cast<size_t>(got);
+        }
+        return true;
+    }
+
+    // Reads one frame's payload; false on a closed connection, throws on an oversized frame
+    bool recvFrame(SocketHandle s, vector<uint8_t>& payload) {
+        uint8_t head[4];
+        if (!recvAll(s, head, 4)) return false;
+        uint32_t n = uint32_t(head[0]) | uint32_t(head[1]) << 8 | uint32_t(head[2]) << 16 | uint32_t(head[3]) << 24;
+        if (n > wire::kMaxFrame)
+            throw runtime_error("Frame of " + to_string(n) + " bytes exceeds limit");
+        payload.resize(n);
+        return recvAll(s, payload.data(), n);
+    }
+
+    // ===== Wire Encoding =====
+
+    class Writer {
+    public:
+        Writer() { buf.resize(4); }     // Room for the length prefix
+
+        void u8(uint8_t v) { buf.push_back(v); }
+        void u32(uint32_t v) {
+            for (int k = 0; k < 4; ++k) buf.push_back(static_cast<uint8_t>(v >> (8 * k)));
+        }
+        void f64(double v) {
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            for (int k = 0; k < 8; ++k) buf.push_back(static_cast<uint8_t>(bits >> (8 * k)));
+        }
+        void str(const string& s) {
+            u32(static_cast<uint32_t>(s.size()));
+            buf.insert(buf.end(), s.begin(), s.end());
+        }
+
+        vector<uint8_t> finish() {
+            uint32_t n = static_cast<uint32_t>(buf.size() - 4);
+            for (int k = 0; k < 4; ++k) buf[k] = static_cast<uint8_t>(n >> (8 * k));
+            return move(buf);
+        }
+
+    private:
+        vector<uint8_t> buf;
+    };
+
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t n) : p(data), end(data + n) {}
+
+        uint8_t u8() { need(1); return *p++; }
+        uint32_t u32() {
+            need(4);
+            uint32_t v = 0;
+            for (int k = 0; k < 4; ++k) v |= uint32_t(*p++) << (8 * k);
+            return v;
+        }
+        double f64() {
+            need(8);
+            uint64_t bits = 0;
+            for (int k = 0; k < 8; ++k) bits |= uint64_t(*p++) << (8 * k);
+            double v;
+            memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+        string str() {
+            uint32_t n = u32();
+            need(n);
+            string s(reinterpret_cast<const char*>(p), n);
+            p += n;
+            return s;
+        }
+
+    private:
+        void need(size_t n) const {
+            if (static_cast<size_t>(end - p) < n)
+                throw runtime_error("Truncated message");
+        }
+
+        const uint8_t* p;
+        const uint8_t* end;
+    };
+
+    bool isReadOnly(ServerOp op) {
+        return op != ServerOp::BumpMarket && op != ServerOp::Shutdown;
+    }
+
+    ServerResponse failure(uint32_t id, const string& what) {
+        ServerResponse r;
+        r.id = id;
+        r.ok = false;
+        r.error = what;
+        return r;
+    }
+}
+
+namespace wire {
+
+    vector<uint8_t> encode(const ServerRequest& req) {
+        Writer w;
+        w.u8(static_cast<uint8_t>(req.op));
+        w.u32(req.id);
+        w.str(req.text);
+        w.u8(static_cast<uint8_t>(req.factor));
+        w.f64(req.bump);
+        return w.finish();
+    }
+
+    vector<uint8_t> encode(const ServerResponse& resp) {
+        Writer w;
+        w.u32(resp.id);
+        w.u8(resp.ok ? 0 : 1);
+        w.u32(static_cast<uint32_t>(resp.values.size()));
+        for (double v : resp.values) w.f64(v);
+        w.str(resp.error);
+        return w.finish();
+    }
+
+    ServerRequest decodeRequest(const uint8_t* payload, size_t n) {
+        Reader r(payload, n);
+        ServerRequest req;
+        req.op = static_cast<ServerOp>(r.u8());
+        req.id = r.u32();
+        req.text = r.str();
+        uint8_t kind = r.u8();
+        if (kind > static_cast<uint8_t>(FactorKind::Any))
+            throw runtime_error("Unknown factor kind " + to_string(kind));
+        req.factor = static_cast<FactorKind>(kind);
+        req.bump = r.f64();
+        return req;
+    }
+
+    ServerResponse decodeResponse(const uint8_t* payload, size_t n) {
+        Reader r(payload, n);
+        ServerResponse resp;
+        resp.id = r.u32();
+        resp.ok = r.u8() == 0;
+        uint32_t count = r.u32();
+        if (count > n / 8)
+            throw runtime_error("Truncated message");
+        resp.values.resize(count);
+        for (auto& v : resp.values) v = r.f64();
+        resp.error = r.str();
+        return resp;
+    }
+}
+
+// ===========================
+// PricingServer
+// ===========================
+
+struct PricingServer::Connection {
+    intptr_t sock;
+    mutex writeMtx;     // Responses to one client go out whole and in order
+
+    explicit Connection(intptr_t s) : sock(s) {}
+    ~Connection() { closeSocket(toHandle(sock)); }
+
+    void reply(const ServerResponse& resp) {
+        auto frame = wire::encode(resp);
+        lock_guard<mutex> lock(writeMtx);
+        sendAll(toHandle(sock), frame.data(), frame.size());
+    }
+};
+
+PricingServer::PricingServer(Market& mkt, PortfolioValuer& portfolioValuer, size_t batch, ThreadPool& threadPool)
+    : market(mkt), valuer(portfolioValuer), pool(threadPool), maxBatch(batch == 0 ? 1 : batch)
+{
+    // What-if and risk queries answer against the booked results
+    if (valuer.getResults().empty())
+        valuer.run();
+}
+
+PricingServer::~PricingServer() {
+    stop();
+}
+
+// ===== Serving =====
+
+void PricingServer::serve(const string& socketPath) {
+    ensureSockets();
+
+    SocketHandle listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener == kInvalid)
+        throw runtime_error("Cannot create socket for " + socketPath);
+
+    sockaddr_un addr = socketAddress(socketPath);
+    removePath(socketPath);     // Stale socket file from a previous run
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 64) != 0) {
+        closeSocket(listener);
+        throw runtime_error("Cannot listen on " + socketPath);
+    }
+
+    listenSocket = static_cast<intptr_t>(listener);
+    running = true;
+    thread dispatcher(&PricingServer::dispatchLoop, this);
+    cout << "[INFO] Pricing server listening on " << socketPath << endl;
+
+    while (running) {
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (client == kInvalid) {
+            if (!running) break;
+            continue;
+        }
+
+        auto conn = make_shared<Connection>(static_cast<intptr_t>(client));
+        auto done = make_shared<atomic<bool>>(false);
+        lock_guard<mutex> lock(connMtx);
+        reapReaders();
+        readers.push_back({ thread(&PricingServer::readLoop, this, conn, done), conn, done });
+    }
+
+    // Drain: the dispatcher finishes queued work, then every connection is shut and joined
+    running = false;
+    queueCv.notify_all();
+    dispatcher.join();
+    {
+        lock_guard<mutex> lock(connMtx);
+        for (auto& reader : readers)
+            if (auto conn = reader.conn.lock()) shutdownSocket(toHandle(conn->sock));
+    }
+    for (auto& reader : readers) reader.thread.join();
+    readers.clear();
+    queue.clear();
+
+    closeSocket(listener);
+    listenSocket = -1;
+    removePath(socketPath);
+    cout << "[INFO] Pricing server stopped after " << requestCount << " requests in "
+        << batchCount << " batches" << endl;
+}
+
+void PricingServer::stop() {
+    bool wasRunning = running.exchange(false);
+    if (wasRunning && listenSocket != -1)
+        shutdownSocket(toHandle(listenSocket));     // Wakes the blocked accept
+    queueCv.notify_all();
+}
+
+void PricingServer::reapReaders() {
+    auto finished = [](ReaderThread& reader) {
+        if (!reader.done->load()) return false;
+        reader.thread.join();
+        return true;
+    };
+    readers.erase(remove_if(readers.begin(), readers.end(), finished), readers.end());
+}
+
+void PricingServer::readLoop(shared_ptr<Connection> conn, shared_ptr<atomic<bool>> done) {
+    vector<uint8_t> payload;
+    try {
+        while (running && recvFrame(toHandle(conn->sock), payload)) {
+            Pending item;
+            item.conn = conn;
+            try {
+                item.request = wire::decodeRequest(payload.data(), payload.size());
+            }
+            catch (const exception& e) {
+                conn->reply(failure(0, e.what()));
+                continue;
+            }
+
+            {
+                lock_guard<mutex> lock(queueMtx);
+                queue.push_back(move(item));
+            }
+            queueCv.notify_one();
+        }
+    }
+    catch (const exception& e) {
+        cerr << "[WARN] PricingServer - dropping connection: " << e.what() << endl;
+    }
+    *done = true;
+}
+
+void PricingServer::dispatchLoop() {
+    vector<Pending> items;
+    vector<ServerRequest> batch;
+
+    for (;;) {
+        {
+            unique_lock<mutex> lock(queueMtx);
+            queueCv.wait(lock, [this] { return !queue.empty() || !running; });
+            if (queue.empty()) return;
+
+            items.clear();
+            while (!queue.empty() && items.size() < maxBatch) {
+                items.push_back(move(queue.front()));
+                queue.pop_front();
+            }
+        }
+
+        batch.clear();
+        for (const auto& item : items) batch.push_back(item.request);
+        auto responses = handleBatch(batch);
+
+        bool shutdown = false;
+        for (size_t k = 0; k < items.size(); ++k) {
+            items[k].conn->reply(responses[k]);
+            shutdown = shutdown || items[k].request.op == ServerOp::Shutdown;
+        }
+        if (shutdown) stop();
+    }
+}
+
+// ===== Request Execution =====
+
+vector<ServerResponse> PricingServer::handleBatch(const vector<ServerRequest>& batch) {
+    vector<ServerResponse> out(batch.size());
+    ++batchCount;
+    requestCount += batch.size();
+
+    size_t k = 0;
+    while (k < batch.size()) {
+        if (!isReadOnly(batch[k].op)) {
+            // Mutations are barriers, applied one at a time in arrival order
+            if (batch[k].op == ServerOp::BumpMarket) {
+                out[k] = bump(batch[k]);
+            }
+            else {
+                out[k].id = batch[k].id;
+            }
+            ++k;
+            continue;
+        }
+
+        // A run of reads sees one market state and shares one portfolio total
+        size_t end = k;
+        while (end < batch.size() && isReadOnly(batch[end].op)) ++end;
+
+        const AggregateResult total = valuer.total();
+        pool.parallel_for(k, end, 1, [&](size_t i) {
+            out[i] = execute(batch[i], total);
+        });
+        k = end;
+    }
+    return out;
+}
+
+ServerResponse PricingServer::execute(const ServerRequest& req, const AggregateResult& total) const {
+    ServerResponse resp;
+    resp.id = req.id;
+
+    try {
+        switch (req.op) {
+        case ServerOp::Ping:
+            break;
+
+        case ServerOp::PriceTrade: {
+            auto trade = parseTradeRow(req.text);
+            if (!trade) return failure(req.id, "Unknown trade type");
+            TradeResult r = valuer.valueExternal(trade);
+            resp.values = { r.PV, r.DV01, r.Vega };
+            break;
+        }
+
+        case ServerOp::WhatIfAdd: {
+            auto trade = parseTradeRow(req.text);
+            if (!trade) return failure(req.id, "Unknown trade type");
+            TradeResult r = valuer.valueExternal(trade);
+            resp.values = { r.PV, r.DV01, r.Vega, total.PV + r.PV, total.DV01 + r.DV01, total.Vega + r.Vega };
+            break;
+        }
+
+        case ServerOp::WhatIfRemove: {
+            long i = valuer.findTrade(req.text);
+            if (i < 0) return failure(req.id, "Trade not found: " + req.text);
+            const TradeResult& r = valuer.getResults()[static_cast<size_t>(i)];
+            resp.values = { -r.PV, -r.DV01, -r.Vega, total.PV - r.PV, total.DV01 - r.DV01, total.Vega - r.Vega };
+            break;
+        }
+
+        case ServerOp::GetRisk: {
+            if (req.text.empty()) {
+                resp.values = { total.PV, total.DV01, total.Vega };
+                break;
+            }
+            long i = valuer.findTrade(req.text);
+            if (i < 0) return failure(req.id, "Trade not found: " + req.text);
+            const TradeResult& r = valuer.getResults()[static_cast<size_t>(i)];
+            resp.values = { r.PV, r.DV01, r.Vega };
+            break;
+        }
+
+        default:
+            return failure(req.id, "Unsupported operation " + to_string(static_cast<int>(req.op)));
+        }
+    }
+    catch (const exception& e) {
+        return failure(req.id, e.what());
+    }
+    return resp;
+}
+
+ServerResponse PricingServer::bump(const ServerRequest& req) {
+    MarketFactor factor(req.factor, req.text);
+
+    // Moved objects are replaced by shocked clones, so no reader ever holds a half-shocked one
+    try {
+        switch (factor.kind) {
+        case FactorKind::Curve: {
+            auto curve = make_shared<RateCurve>(*market.getCurve(factor.name));
+            curve->shock(req.bump);
+            market.addCurve(factor.name, curve);
+            break;
+        }
+        case FactorKind::Vol: {
+            auto vol = make_shared<VolCurve>(*market.getVolCurve(factor.name));
+            vol->shock(req.bump);
+            market.addVolCurve(factor.name, vol);
+            break;
+        }
+        case FactorKind::SwaptionCube: {
+            auto cube = make_shared<SwaptionVolCube>(*market.getSwaptionVolCube(factor.name));
+            cube->shock(req.bump);
+            market.addSwaptionVolCube(factor.name, cube);
+            break;
+        }
+        case FactorKind::VolSurface: {
+            auto surface = make_shared<ImpliedVolSurface>(*market.getVolSurface(factor.name));
+            surface->shock(req.bump);
+            market.addVolSurface(factor.name, surface);
+            break;
+        }
+        case FactorKind::Spot:
+            market.addStockPrice(factor.name, market.getStockPrice(factor.name) * (1.0 + req.bump));
+            break;
+        case FactorKind::BondPrice:
+            market.addBondPrice(factor.name, market.getBondPrice(factor.name) + req.bump);
+            break;
+        case FactorKind::Any:
+            return failure(req.id, "Bump needs a specific market factor");
+        }
+    }
+    catch (const exception& e) {
+        return failure(req.id, e.what());
+    }
+
+    ServerResponse resp;
+    resp.id = req.id;
+    size_t repriced = valuer.update({ factor });
+    AggregateResult total = valuer.total();
+    resp.values = { static_cast<double>(repriced), total.PV, total.DV01, total.Vega };
+    return resp;
+}
+
+// ===========================
+// PricingClient
+// ===========================
+
+PricingClient::PricingClient(const string& socketPath) {
+    ensureSockets();
+
+    SocketHandle s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s == kInvalid)
+        throw runtime_error("Cannot create socket for " + socketPath);
+
+    sockaddr_un addr = socketAddress(socketPath);
+    if (connect(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        closeSocket(s);
+        throw runtime_error("Cannot connect to " + socketPath);
+    }
+    sock = static_cast<intptr_t>(s);
+}
+
+PricingClient::~PricingClient() {
+    if (sock != -1) closeSocket(toHandle(sock));
+}
+
+ServerResponse PricingClient::call(const ServerRequest& req) {
+    return callBatch({ req }).front();
+}
+
+vector<ServerResponse> PricingClient::callBatch(const vector<ServerRequest>& reqs) {
+    // Pipeline: write every request, then read the responses back in order
+    vector<uint8_t> frames;
+    for (auto req : reqs) {
+        req.id = nextId++;
+        auto frame = wire::encode(req);
+        frames.insert(frames.end(), frame.begin(), frame.end());
+    }
+    if (!sendAll(toHandle(sock), frames.data(), frames.size()))
+        throw runtime_error("Pricing server connection lost");
+
+    vector<ServerResponse> out;
+    out.reserve(reqs.size());
+    vector<uint8_t> payload;
+    for (size_t k = 0; k < reqs.size(); ++k) {
+        if (!recvFrame(toHandle(sock), payload))
+            throw runtime_error("Pricing server connection lost");
+        out.push_back(wire::decodeResponse(payload.data(), payload.size()));
+    }
+    return out;
+}
@@ -6,6 +6,7 @@
 
 #include "rate_curve.h"
 #include "date.h"
+#include "helper.h"
 
 using namespace std;
 
@@ -40,6 +41,17 @@ void RateCurve::addRate(const Date& tenor, double rate) {
     rates.push_back(rate);
 }
 
+// ===== Content hash of the pillars =====
+uint64_t RateCurve::fingerprint() const {
+    uint64_t h = util::kHashSeed;
+    for (size_t i = 0; i < tenorDates.size(); ++i) {
+        int ymd[3] = { tenorDates[i].getYear(), tenorDates[i].getMonth(), tenorDates[i].getDay() };
+        h = util::hashMix(h, ymd);
+        h = util::hashMix(h, rates[i]);
+    }
+    return h;
+}
+
 // ===== Get rate at a given tenor with linear interpolation =====
 double RateCurve::getRate(const Date& tenor) const {
     if (tenorDates.empty())
@@ -1,5 +1,8 @@
 #include "risk_engine.h"
 #include "helper.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <exception>
 #include <future>
 #include <iostream>
 #include <stdexcept>
@@ -11,23 +14,42 @@ using util::dateAddTenor;
 // CurveDecorator
 // ========================
 CurveDecorator::CurveDecorator(const Market& mkt, const MarketShock& shock)
-    : thisMarketUp(mkt), thisMarketDown(mkt)
+    : spec(shock), thisMarketUp(mkt), thisMarketDown(mkt)
 {
-    const Date& tenor = shock.shock.first;
+    apply();
+}
+
+void CurveDecorator::apply()
+{
+    const Date& tenor = spec.shock.first;
     if (tenor.getYear() <= 1900) {
         cerr << "[WARN] Invalid tenor passed to CurveDecorator: " << tenor << endl;
         return;
     }
 
     try {
-        auto up = thisMarketUp.getCurve(shock.market_id);
-        auto down = thisMarketDown.getCurve(shock.market_id);
-        up->shock(tenor, +shock.shock.second);
-        down->shock(tenor, -shock.shock.second);
+        auto up = thisMarketUp.getCurve(spec.market_id);
+        auto down = thisMarketDown.getCurve(spec.market_id);
+        up->shock(tenor, +spec.shock.second);
+        down->shock(tenor, -spec.shock.second);
+        thisMarketUp.touch(MarketFactor(FactorKind::Curve, spec.market_id));
+        thisMarketDown.touch(MarketFactor(FactorKind::Curve, spec.market_id));
     }
     catch (const exception& e) {
-        cerr << "[WARN] CurveDecorator failed for " << shock.market_id << ": " << e.what() << endl;
+        cerr << "[WARN] CurveDecorator failed for " << spec.market_id << ": " << e.what() << endl;
+    }
+}
+
+void CurveDecorator::refresh(const Market& mkt, const vector<MarketFactor>& moved)
+{
+    const MarketFactor target(FactorKind::Curve, spec.market_id);
+    bool rebump = false;
+    for (const auto& f : moved) {
+        thisMarketUp.copyFactor(mkt, f);
+        thisMarketDown.copyFactor(mkt, f);
+        rebump = rebump || f == target || f.kind == FactorKind::Any;
     }
+    if (rebump) apply();
 }
 
 const Market& CurveDecorator::getMarketUp() const { return thisMarketUp; }
@@ -37,32 +59,57 @@ const Market& CurveDecorator::getMarketDown() const { return thisMarketDown; }
 // VolDecorator
 // ========================
 VolDecorator::VolDecorator(const Market& mkt, const MarketShock& shock)
-    : originMarket(mkt), thisMarket(mkt)
+    : spec(shock), originMarket(mkt), thisMarket(mkt)
+{
+    apply();
+}
+
+void VolDecorator::apply()
 {
-    const Date& tenor = shock.shock.first;
+    const Date& tenor = spec.shock.first;
     if (tenor.getYear() <= 1900) {
         cerr << "[WARN] Invalid tenor passed to VolDecorator: " << tenor << endl;
         return;
     }
 
     try {
-        auto vol = thisMarket.getVolCurve(shock.market_id);
-        vol->shock(tenor, shock.shock.second);
+        // Swaption cubes move in parallel; vol curves at the shocked tenor only
+        if (thisMarket.hasSwaptionVolCube(spec.market_id)) {
+            thisMarket.getSwaptionVolCube(spec.market_id)->shock(spec.shock.second);
+            thisMarket.touch(MarketFactor(FactorKind::SwaptionCube, spec.market_id));
+        }
+        else {
+            thisMarket.getVolCurve(spec.market_id)->shock(tenor, spec.shock.second);
+            thisMarket.touch(MarketFactor(FactorKind::Vol, spec.market_id));
+        }
     }
     catch (const exception& e) {
-        cerr << "[WARN] VolDecorator failed for " << shock.market_id << ": " << e.what() << endl;
+        cerr << "[WARN] VolDecorator failed for " << spec.market_id << ": " << e.what() << endl;
+    }
+}
+
+void VolDecorator::refresh(const Market& mkt, const vector<MarketFactor>& moved)
+{
+    const MarketFactor cube(FactorKind::SwaptionCube, spec.market_id), vol(FactorKind::Vol, spec.market_id);
+    bool rebump = false;
+    for (const auto& f : moved) {
+        originMarket.copyFactor(mkt, f);
+        thisMarket.copyFactor(mkt, f);
+        rebump = rebump || f == cube || f == vol || f.kind == FactorKind::Any;
     }
+    if (rebump) apply();
 }
 
 const Market& VolDecorator::getOriginMarket() const { return originMarket; }
 const Market& VolDecorator::getMarket() const { return thisMarket; }
 
 // ========================
-// PriceDecorator (Optional)
+// PriceDecorator
 // ========================
 PriceDecorator::PriceDecorator(const Market& mkt, const MarketShock& shock)
-    : thisMarket(mkt) {
-    // Add logic if you plan to shock stock/bond prices
+    : thisMarket(mkt.overlay()) {
+    // Relative move of one stock price; spots are plain values, so the overlay stays shallow
+    thisMarket.shockPrice(shock.market_id, shock.shock.second);
 }
 
 const Market& PriceDecorator::getMarket() const { return thisMarket; }
@@ -82,6 +129,76 @@ RiskEngine::RiskEngine(const Market& market, double curve_shock, double vol_shoc
 
     MarketShock volBump{ "LOGVOL", { bumpTenor, vol_shock } };
     volShocks.emplace("LOGVOL", VolDecorator(market, volBump));
+
+    // Normal cubes quote absolute rate vols, so one vol point moves them by 1bp
+    for (const auto& name : market.getSwaptionVolCubeNames()) {
+        bool normal = market.getSwaptionVolCube(name)->getType() == SwaptionVolType::Normal;
+        MarketShock cubeBump{ name, { bumpTenor, normal ? vol_shock * 0.01 : vol_shock } };
+        volShocks.emplace(name, VolDecorator(market, cubeBump));
+    }
+}
+
+// ========================
+// Discount Table Support
+// ========================
+void RiskEngine::setDiscountTable(shared_ptr<const DiscountTable> table)
+{
+    dfTable = move(table);
+    curveShockDfs.clear();
+    baseDfs.clear();
+    if (!dfTable) return;
+
+    // One curve evaluation per bumped market instead of one per trade cashflow
+    for (const auto& kv : curveShocks) {
+        ShockedDfs dfs;
+        dfTable->evaluate(kv.second.getMarketUp(), dfs.up);
+        dfTable->evaluate(kv.second.getMarketDown(), dfs.down);
+        curveShockDfs.emplace(kv.first, move(dfs));
+    }
+    if (!volShocks.empty())
+        dfTable->evaluate(volShocks.begin()->second.getOriginMarket(), baseDfs);
+}
+
+void RiskEngine::refresh(const Market& market, const vector<MarketFactor>& moved)
+{
+    for (auto& kv : curveShocks) kv.second.refresh(market, moved);
+    for (auto& kv : volShocks) kv.second.refresh(market, moved);
+
+    const bool curveMoved = any_of(moved.begin(), moved.end(), [](const MarketFactor& f) {
+        return f.kind == FactorKind::Curve || f.kind == FactorKind::Any;
+    });
+    if (curveMoved && dfTable)
+        setDiscountTable(dfTable);
+}
+
+double RiskEngine::pvUnder(const Trade& trade, const Market& mkt, const vector<double>* dfs) const
+{
+    if (dfs && dfTable && trade.usesDiscountTable())
+        return trade.pvFromTable(*dfs, mkt);
+    if (cache)
+        return cache->getOrCompute(ValuationKey::of(trade, mkt, ValuationMethod::Pv), [&] { return trade.pv(mkt); });
+    return trade.pv(mkt);
+}
+
+// ========================
+// Per-Shock Sensitivities
+// ========================
+double RiskEngine::curveRisk(const string& market_id, const CurveDecorator& shock, const Trade& trade, bool useTable) const
+{
+    auto dfs = curveShockDfs.find(market_id);
+    bool hasDfs = useTable && dfs != curveShockDfs.end();
+    double pv_up = pvUnder(trade, shock.getMarketUp(), hasDfs ? &dfs->second.up : nullptr);
+    double pv_down = pvUnder(trade, shock.getMarketDown(), hasDfs ? &dfs->second.down : nullptr);
+    return (pv_up - pv_down) / (2.0 * curveShockSize);  // Normalize
+}
+
+double RiskEngine::volRisk(const VolDecorator& shock, const Trade& trade, bool useTable) const
+{
+    // Vol bumps leave discounting unchanged, so both legs share the base table
+    const vector<double>* dfs = !useTable || baseDfs.empty() ? nullptr : &baseDfs;
+    double pv_base = pvUnder(trade, shock.getOriginMarket(), dfs);
+    double pv_up = pvUnder(trade, shock.getMarket(), dfs);
+    return (pv_up - pv_base) / volShockSize;  // Normalize
 }
 
 // ========================
@@ -90,35 +207,23 @@ RiskEngine::RiskEngine(const Market& market, double curve_shock, double vol_shoc
 
 void RiskEngine::computeRisk(string riskType, shared_ptr<Trade> trade, bool singleThread)
 {
-    result.clear();
+    result = evaluateRisk(riskType, trade, singleThread);
+}
+
+map<string, double> RiskEngine::evaluateRisk(const string& riskType, shared_ptr<Trade> trade, bool singleThread,
+    bool useDiscountTable) const
+{
+    map<string, double> out;
 
     if (singleThread) {
         if (riskType == "dv01") {
-            for (auto& kv : curveShocks) {
-                const string& market_id = kv.first;
-                const Market& mkt_up = kv.second.getMarketUp();
-                const Market& mkt_down = kv.second.getMarketDown();
-
-                double pv_up = trade->pv(mkt_up);
-                double pv_down = trade->pv(mkt_down);
-                double dv01 = (pv_up - pv_down) / (2.0 * curveShockSize);  // Normalize
-
-                result.emplace(market_id, dv01);
-            }
+            for (const auto& kv : curveShocks)
+                out.emplace(kv.first, curveRisk(kv.first, kv.second, *trade, useDiscountTable));
         }
 
         if (riskType == "vega") {
-            for (auto& kv : volShocks) {
-                const string& market_id = kv.first;
-                const Market& mkt_base = kv.second.getOriginMarket();
-                const Market& mkt_bump = kv.second.getMarket();
-
-                double pv_base = trade->pv(mkt_base);
-                double pv_up = trade->pv(mkt_bump);
-                double vega = (pv_up - pv_base) / volShockSize;  // Normalize
-
-                result.emplace(market_id, vega);
-            }
+            for (const auto& kv : volShocks)
+                out.emplace(kv.first, volRisk(kv.second, *trade, useDiscountTable));
         }
 
         if (riskType == "price") {
@@ -126,33 +231,76 @@ void RiskEngine::computeRisk(string riskType, shared_ptr<Trade> trade, bool sing
         }
     }
     else {
-        auto async_task = [](shared_ptr<Trade> trade, const string& id, const Market& up, const Market& down, double bumpSize) {
-            double pv_up = trade->pv(up);
-            double pv_down = trade->pv(down);
-            return make_pair(id, (pv_up - pv_down) / (2.0 * bumpSize));
-            };
-
-        vector<future<pair<string, double>>> tasks;
+        // One pool task per shock; bumped markets are shared by reference, never copied
+        ThreadPool& pool = ThreadPool::global();
+        vector<pair<string, future<double>>> tasks;
 
         if (riskType == "dv01") {
             for (const auto& kv : curveShocks) {
-                tasks.push_back(async(launch::async, async_task,
-                    trade, kv.first, kv.second.getMarketUp(), kv.second.getMarketDown(), curveShockSize));
+                const string& id = kv.first;
+                const CurveDecorator& shock = kv.second;
+                tasks.emplace_back(id, pool.submit([this, &id, &shock, &trade, useDiscountTable] {
+                    return curveRisk(id, shock, *trade, useDiscountTable);
+                }));
             }
         }
 
         if (riskType == "vega") {
             for (const auto& kv : volShocks) {
-                tasks.push_back(async(launch::async, async_task,
-                    trade, kv.first, kv.second.getMarket(), kv.second.getOriginMarket(), volShockSize));
+                const VolDecorator& shock = kv.second;
+                tasks.emplace_back(kv.first, pool.submit([this, &shock, &trade, useDiscountTable] {
+                    return volRisk(shock, *trade, useDiscountTable);
+                }));
             }
         }
 
-        for (auto& fut : tasks) {
-            auto [id, val] = fut.get();
-            result.emplace(id, val);
+        // Drain every task before rethrowing: they reference this frame's trade and shocks
+        exception_ptr firstError;
+        for (auto& [id, fut] : tasks) {
+            try {
+                out.emplace(id, pool.wait(fut));
+            }
+            catch (...) {
+                if (!firstError) firstError = current_exception();
+            }
         }
+        if (firstError) rethrow_exception(firstError);
     }
+
+    return out;
+}
+
+vector<map<string, double>> RiskEngine::evaluateRiskBatch(const string& riskType, size_t count,
+    const BatchPricing& price) const
+{
+    vector<map<string, double>> out(count);
+    auto checked = [&](const Market& mkt) {
+        vector<double> pv = price(mkt);
+        if (pv.size() != count)
+            throw runtime_error("Batch risk: pricer returned " + to_string(pv.size()) + " PVs for " + to_string(count) + " trades");
+        return pv;
+    };
+
+    // Same differences as curveRisk and volRisk, one batch per bumped market
+    if (riskType == "dv01") {
+        for (const auto& [id, shock] : curveShocks) {
+            const vector<double> up = checked(shock.getMarketUp());
+            const vector<double> down = checked(shock.getMarketDown());
+            for (size_t k = 0; k < count; ++k)
+                out[k].emplace(id, (up[k] - down[k]) / (2.0 * curveShockSize));
+        }
+    }
+
+    if (riskType == "vega") {
+        for (const auto& [id, shock] : volShocks) {
+            const vector<double> base = checked(shock.getOriginMarket());
+            const vector<double> up = checked(shock.getMarket());
+            for (size_t k = 0; k < count; ++k)
+                out[k].emplace(id, (up[k] - base[k]) / volShockSize);
+        }
+    }
+
+    return out;
 }
 
 // ========================
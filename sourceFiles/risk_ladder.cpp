@@ -0,0 +1,265 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#include "risk_ladder.h"
+#include "chebyshev_proxy.h"
+#include "black_scholes_pricer.h"
+#include "european_trade.h"
+#include "american_trade.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+
+namespace {
+    enum class LadderPath { None, Analytic, Lattice, Reprice, Proxy };
+
+    LadderPath pathOf(const Trade& trade) {
+        if (dynamic_cast<const EuropeanOption*>(&trade) || dynamic_cast<const EuroCallSpread*>(&trade))
+            return LadderPath::Analytic;
+        if (dynamic_cast<const AmericanOption*>(&trade) || dynamic_cast<const AmerCallSpread*>(&trade))
+            return LadderPath::Lattice;
+        for (const auto& f : trade.getMarketDependencies())
+            if (f.kind == FactorKind::Spot || f.kind == FactorKind::Any)
+                return LadderPath::Reprice;
+        return LadderPath::None;
+    }
+
+    // Black-Scholes inputs the analytic and lattice paths share with BlackScholesPricer
+    struct OptionInputs {
+        double S, T, sigma, r;
+
+        OptionInputs(const Market& mkt, const Trade& trade)
+            : S(mkt.getStockPrice(trade.getUnderlying())),
+            T(trade.getExpiry() - mkt.asOf),
+            sigma(mkt.getVolCurve("LOGVOL")->getVol(trade.getExpiry())),
+            r(mkt.getCurve(trade.getRateCurve())->getRate(trade.getExpiry())) {
+        }
+    };
+
+    size_t indexOf(const vector<double>& axis, double value) {
+        auto it = find(axis.begin(), axis.end(), value);
+        return it == axis.end() ? axis.size() : size_t(it - axis.begin());
+    }
+}
+
+// ===== LadderSpec / RiskLadder =====
+
+LadderSpec LadderSpec::uniform(double lo, double hi, size_t steps, vector<double> vols)
+{
+    LadderSpec s;
+    s.spotMoves.resize(steps);
+    for (size_t i = 0; i < steps; ++i) {
+        double x = steps == 1 ? lo : lo + (hi - lo) * double(i) / double(steps - 1);
+        s.spotMoves[i] = fabs(x) < 1e-12 ? 0.0 : x;   // Exact zero for the greeks read-out
+    }
+    s.volMoves = move(vols);
+    return s;
+}
+
+RiskLadder::RiskLadder(size_t rows, size_t vols, size_t spots)
+    : nRows(rows), nVols(vols), nSpots(spots), data(rows * vols * spots, 0.0) {
+}
+
+// ===== Constructor =====
+
+LadderEngine::LadderEngine(const Market& market,
+    const vector<shared_ptr<Trade>>& portfolio,
+    ThreadPool& threadPool)
+    : mkt(market), trades(portfolio), pool(threadPool) {
+}
+
+// ===== Run =====
+
+const RiskLadder& LadderEngine::run(const LadderSpec& ladderSpec)
+{
+    spec = ladderSpec;
+    const size_t nTrades = trades.size();
+    ladder = RiskLadder(nTrades, spec.volMoves.size(), spec.spotMoves.size());
+    laddered.assign(nTrades, 0);
+
+    vector<LadderPath> paths(nTrades);
+    for (size_t t = 0; t < nTrades; ++t)
+        paths[t] = pathOf(*trades[t]);
+
+    pool.parallel_for(0, nTrades, 1, [&](size_t t) {
+        try {
+            if (paths[t] != LadderPath::None && proxy && ladderProxy(t)) {
+                paths[t] = LadderPath::Proxy;
+                laddered[t] = 1;
+                return;
+            }
+            switch (paths[t]) {
+            case LadderPath::Analytic: ladderAnalytic(t); break;
+            case LadderPath::Lattice:  ladderLattice(t); break;
+            case LadderPath::Reprice:  ladderReprice(t); break;
+            case LadderPath::Proxy:
+            case LadderPath::None:     return;
+            }
+            laddered[t] = 1;
+        }
+        catch (const exception& e) {
+            cerr << "[WARN] Ladder skipped for trade " << trades[t]->getId() << ": " << e.what() << endl;
+        }
+    });
+
+    latticeCount = 0;
+    const bool needsBase = indexOf(spec.volMoves, 0.0) == spec.volMoves.size();
+    for (size_t t = 0; t < nTrades; ++t)
+        if (paths[t] == LadderPath::Lattice)
+            latticeCount += spec.volMoves.size() + (needsBase ? 1 : 0);
+    return ladder;
+}
+
+// ===== Proxy =====
+
+bool LadderEngine::ladderProxy(size_t t)
+{
+    const Trade& trade = *trades[t];
+    if (!proxy->covers(trade)) return false;
+    const OptionInputs in(mkt, trade);
+
+    // Whole grid first, so a point outside the box leaves the row to the exact path
+    double base;
+    vector<double> grid(spec.volMoves.size() * spec.spotMoves.size());
+    if (!proxy->evaluate(trade, mkt.asOf, in.S, in.sigma, in.r, base)) return false;
+    for (size_t v = 0; v < spec.volMoves.size(); ++v) {
+        const double sigma = max(in.sigma + spec.volMoves[v], 1e-4);
+        for (size_t s = 0; s < spec.spotMoves.size(); ++s)
+            if (!proxy->evaluate(trade, mkt.asOf, in.S * (1.0 + spec.spotMoves[s]), sigma, in.r, grid[v * spec.spotMoves.size() + s]))
+                return false;
+    }
+
+    for (size_t v = 0; v < spec.volMoves.size(); ++v)
+        for (size_t s = 0; s < spec.spotMoves.size(); ++s)
+            ladder.at(t, v, s) = grid[v * spec.spotMoves.size() + s] - base;
+    return true;
+}
+
+// ===== Closed Form =====
+
+void LadderEngine::ladderAnalytic(size_t t)
+{
+    const Trade& trade = *trades[t];
+    const OptionInputs in(mkt, trade);
+    const double sign = trade.isLong() ? 1.0 : -1.0;
+
+    auto value = [&](double S, double sigma) {
+        if (auto spread = dynamic_cast<const EuroCallSpread*>(&trade)) {
+            double k1 = spread->getLowerStrike(), k2 = spread->getUpperStrike();
+            return (blackScholesPrice(OptionType::Call, S, k1, in.T, in.r, sigma)
+                - blackScholesPrice(OptionType::Call, S, k2, in.T, in.r, sigma)) / (k2 - k1);
+        }
+        return blackScholesPrice(trade.getOptionType(), S, trade.getStrike(), in.T, in.r, sigma);
+    };
+
+    const double scale = sign * trade.getNotional();
+    const double base = value(in.S, in.sigma);
+    for (size_t v = 0; v < spec.volMoves.size(); ++v) {
+        const double sigma = max(in.sigma + spec.volMoves[v], 1e-4);
+        for (size_t s = 0; s < spec.spotMoves.size(); ++s)
+            ladder.at(t, v, s) = scale * (value(in.S * (1.0 + spec.spotMoves[s]), sigma) - base);
+    }
+}
+
+// ===== Shared Lattice =====
+
+void LadderEngine::ladderLattice(size_t t)
+{
+    const Trade& trade = *trades[t];
+    const OptionInputs in(mkt, trade);
+    const double sign = trade.isLong() ? 1.0 : -1.0;
+    auto exercise = [&](double S) { return sign * trade.payoff(S); };   // Holder's payoff
+    // Time-0 value at spot S * ratio for every ratio, from one lattice at this vol
+    auto profile = [&](double sigma, const vector<double>& ratios) {
+        return EarlyExerciseLatticePricer::profile(exercise, in.S, in.T, in.r, sigma, spec.treeSteps, ratios);
+    };
+
+    vector<double> ratios(spec.spotMoves.size());
+    for (size_t s = 0; s < ratios.size(); ++s) ratios[s] = 1.0 + spec.spotMoves[s];
+
+    const size_t v0 = indexOf(spec.volMoves, 0.0);
+    double base = v0 < spec.volMoves.size() ? 0.0 : profile(in.sigma, { 1.0 })[0];
+    vector<vector<double>> grid(spec.volMoves.size());
+    for (size_t v = 0; v < spec.volMoves.size(); ++v) {
+        vector<double> r = ratios;
+        r.push_back(1.0);   // Unmoved spot, for the base when this is the zero vol level
+        grid[v] = profile(max(in.sigma + spec.volMoves[v], 1e-4), r);
+        if (v == v0) base = grid[v].back();
+    }
+
+    for (size_t v = 0; v < grid.size(); ++v)
+        for (size_t s = 0; s < ratios.size(); ++s)
+            ladder.at(t, v, s) = sign * (grid[v][s] - base);
+}
+
+// ===== Full Repricing =====
+
+void LadderEngine::ladderReprice(size_t t)
+{
+    const auto& trade = trades[t];
+    const string& underlying = trade->getUnderlying();
+    mkt.getStockPrice(underlying);   // Throws if the trade has no spot to move
+
+    CRRBinomialTreePricer pricer(50);
+    const double base = pricer.price(mkt, trade);
+    for (size_t v = 0; v < spec.volMoves.size(); ++v) {
+        Market volMkt = mkt.overlay();
+        if (spec.volMoves[v] != 0.0) {
+            auto vol = make_shared<VolCurve>(*mkt.getVolCurve("LOGVOL"));
+            vol->shock(spec.volMoves[v]);
+            volMkt.addVolCurve("LOGVOL", vol);
+        }
+        for (size_t s = 0; s < spec.spotMoves.size(); ++s) {
+            Market bumped = volMkt.overlay();
+            bumped.addStockPrice(underlying, mkt.getStockPrice(underlying) * (1.0 + spec.spotMoves[s]));
+            ladder.at(t, v, s) = pricer.price(bumped, trade) - base;
+        }
+    }
+}
+
+// ===== Aggregation / Greeks =====
+
+map<string, vector<double>> LadderEngine::byUnderlying() const
+{
+    const size_t width = ladder.volCount() * ladder.spotCount();
+    map<string, vector<size_t>> members;
+    for (size_t t = 0; t < trades.size(); ++t)
+        if (laddered[t]) members[trades[t]->getUnderlying()].push_back(t);
+
+    map<string, vector<double>> out;
+    vector<double> column;
+    for (const auto& [underlying, idx] : members) {
+        vector<double>& grid = out[underlying];
+        grid.resize(width);
+        column.resize(idx.size());
+        for (size_t k = 0; k < width; ++k) {
+            for (size_t i = 0; i < idx.size(); ++i) column[i] = ladder.row(idx[i])[k];
+            grid[k] = util::pairwiseSum(column);
+        }
+    }
+    return out;
+}
+
+LadderGreeks LadderEngine::greeks(const double* g) const
+{
+    LadderGreeks out;
+    const auto& m = spec.spotMoves;
+    const auto& dv = spec.volMoves;
+    const size_t s0 = indexOf(m, 0.0), v0 = indexOf(dv, 0.0);
+    if (s0 == 0 || s0 + 1 >= m.size() || v0 >= dv.size()) return out;
+
+    const size_t nS = m.size();
+    auto P = [&](size_t v, size_t s) { return g[v * nS + s]; };
+    const double hu = m[s0 + 1], hd = -m[s0 - 1];
+    out.gamma = 2.0 * (P(v0, s0 + 1) * hd - P(v0, s0) * (hu + hd) + P(v0, s0 - 1) * hu) / (hu * hd * (hu + hd));
+
+    if (v0 > 0 && v0 + 1 < dv.size()) {
+        const double dVol = dv[v0 + 1] - dv[v0 - 1];
+        out.vanna = (P(v0 + 1, s0 + 1) - P(v0 - 1, s0 + 1) - P(v0 + 1, s0 - 1) + P(v0 - 1, s0 - 1))
+            / ((hu + hd) * dVol);
+    }
+    return out;
+}
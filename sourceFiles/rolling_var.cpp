@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#include "rolling_var.h"
+#include "helper.h"
+
+using namespace std;
+
+// ========================
+// ScenarioPnlStore
+// ========================
+bool ScenarioPnlStore::load(const string& filename)
+{
+    entries.clear();
+    if (!util::fileExists(filename))
+        return false;
+
+    string header;
+    vector<string> lines;
+    util::readFromFile(filename, header, lines);
+
+    for (const auto& line : lines) {
+        auto t = util::split(line, ";");
+        if (t.size() < 4) continue;
+        try {
+            Entry& e = entries[t[0]];
+            e.fingerprint = stoull(t[1]);
+            e.pnl[util::parseDate(t[2]).getSerialDate()] = stod(t[3]);
+        }
+        catch (const exception& ex) {
+            cerr << "[WARN] Skipping malformed P&L store line: " << line << " => " << ex.what() << endl;
+        }
+    }
+    return true;
+}
+
+void ScenarioPnlStore::save(const string& filename) const
+{
+    vector<string> output;
+    output.reserve(size() + 1);
+    output.push_back("trade_id;fingerprint;scenario_date;pnl");
+
+    for (const auto& [id, e] : entries) {
+        for (const auto& [serial, pnl] : e.pnl) {
+            Date d;
+            d.serialToDate(static_cast<int>(serial));
+            ostringstream os;
+            os << id << ";" << e.fingerprint << ";" << d << ";" << setprecision(17) << pnl;
+            output.push_back(os.str());
+        }
+    }
+    util::outputToFile(filename, output);
+}
+
+ScenarioPnlStore::Entry* ScenarioPnlStore::find(const string& tradeId)
+{
+    auto it = entries.find(tradeId);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+const ScenarioPnlStore::Entry* ScenarioPnlStore::find(const string& tradeId) const
+{
+    auto it = entries.find(tradeId);
+    return it == entries.end() ? nullptr : &it->second;
+}
+
+ScenarioPnlStore::Entry& ScenarioPnlStore::upsert(const string& tradeId, uint64_t fingerprint)
+{
+    Entry& e = entries[tradeId];
+    if (e.fingerprint != fingerprint) {
+        e.fingerprint = fingerprint;
+        e.pnl.clear();   // Terms changed: every stored scenario is stale
+    }
+    return e;
+}
+
+void ScenarioPnlStore::retain(const vector<string>& tradeIds, const vector<long>& dates)
+{
+    set<string> keepIds(tradeIds.begin(), tradeIds.end());
+    set<long> keepDates(dates.begin(), dates.end());
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (!keepIds.count(it->first)) {
+            it = entries.erase(it);
+            continue;
+        }
+        auto& pnl = it->second.pnl;
+        for (auto p = pnl.begin(); p != pnl.end();)
+            p = keepDates.count(p->first) ? next(p) : pnl.erase(p);
+        ++it;
+    }
+}
+
+size_t ScenarioPnlStore::size() const
+{
+    size_t n = 0;
+    for (const auto& [_, e] : entries) n += e.pnl.size();
+    return n;
+}
+
+// ========================
+// RollingVarEngine
+// ========================
+RollingVarEngine::RollingVarEngine(const Market& base,
+    const vector<shared_ptr<Trade>>& portfolio,
+    size_t windowSize,
+    shared_ptr<const DiscountTable> table,
+    ThreadPool& threadPool)
+    : baseMarket(base), trades(portfolio), window(windowSize), pool(threadPool),
+    revaluer(base, portfolio, move(table), threadPool) {
+}
+
+string RollingVarEngine::idOf(size_t t) const
+{
+    const string& id = trades[t]->getId();
+    return id.empty() ? "#" + to_string(t + 1) : id;
+}
+
+RollStats RollingVarEngine::update(vector<HistoricalScenario> scenarios)
+{
+    // Keep the latest `window` days, oldest first
+    stable_sort(scenarios.begin(), scenarios.end(),
+        [](const HistoricalScenario& a, const HistoricalScenario& b) { return a.date < b.date; });
+    if (scenarios.size() > window)
+        scenarios.erase(scenarios.begin(), scenarios.end() - window);
+
+    size_t nScen = scenarios.size();
+    size_t nTrades = trades.size();
+
+    windowScenarios = scenarios;
+    windowDates.clear();
+    windowSerials.clear();
+    for (const auto& sc : scenarios) {
+        windowDates.push_back(sc.date);
+        windowSerials.push_back(sc.date.getSerialDate());
+    }
+
+    RollStats stats;
+    stats.scenarios = nScen;
+
+    // New or amended trades lose their stored history
+    vector<string> ids(nTrades);
+    vector<ScenarioPnlStore::Entry*> entries(nTrades);
+    vector<char> repriced(nTrades, 0);
+    for (size_t t = 0; t < nTrades; ++t) {
+        ids[t] = idOf(t);
+        uint64_t fp = trades[t]->fingerprint();
+        const ScenarioPnlStore::Entry* old = store.find(ids[t]);
+        if (!old || old->fingerprint != fp || old->pnl.empty()) {
+            repriced[t] = 1;
+            ++stats.repricedTrades;
+        }
+        entries[t] = &store.upsert(ids[t], fp);
+    }
+
+    // Missing (trade, scenario) pairs, grouped by scenario so each overlay is built once
+    vector<vector<size_t>> jobs(nScen);
+    vector<char> needsBase(nTrades, 0);
+    for (size_t s = 0; s < nScen; ++s) {
+        bool isNew = false;
+        for (size_t t = 0; t < nTrades; ++t) {
+            if (entries[t]->pnl.count(windowSerials[s])) {
+                ++stats.reused;
+            }
+            else {
+                jobs[s].push_back(t);
+                needsBase[t] = 1;
+                isNew = isNew || !repriced[t];
+            }
+        }
+        if (isNew) ++stats.newScenarios;
+        stats.revaluations += jobs[s].size();
+    }
+
+    // Base PVs only for trades that need any revaluation
+    const vector<double>& baseDfs = revaluer.getBaseDfs();
+    vector<double> basePv(nTrades, 0.0);
+    {
+        vector<size_t> todo;
+        for (size_t t = 0; t < nTrades; ++t)
+            if (needsBase[t]) todo.push_back(t);
+        vector<double> pv;
+        revaluer.revalueAll(todo, baseMarket, baseDfs, pv);
+        for (size_t k = 0; k < todo.size(); ++k) basePv[todo[k]] = pv[k];
+    }
+
+    // Revalue into dense per-scenario buffers; the store is only touched serially below
+    if (stats.revaluations > 0) revaluer.prepareProxy(scenarios);
+    vector<vector<double>> results(nScen);
+    pool.parallel_for(0, nScen, 1, [&](size_t s) {
+        const vector<size_t>& todo = jobs[s];
+        if (todo.empty()) return;
+
+        Market mkt = scenarios[s].apply(baseMarket);
+        vector<double> dfs;
+        revaluer.getDiscountTable()->evaluate(mkt, dfs);
+
+        revaluer.revalueAll(todo, mkt, dfs, results[s]);
+        for (size_t k = 0; k < todo.size(); ++k)
+            results[s][k] -= basePv[todo[k]];
+    });
+
+    for (size_t s = 0; s < nScen; ++s)
+        for (size_t k = 0; k < jobs[s].size(); ++k)
+            entries[jobs[s][k]]->pnl[windowSerials[s]] = results[s][k];
+
+    store.retain(ids, windowSerials);
+
+    // Re-derive the per-scenario portfolio P&L in trade order
+    portfolioPnl.assign(nScen, 0.0);
+    vector<double> column(nTrades);
+    for (size_t s = 0; s < nScen; ++s) {
+        for (size_t t = 0; t < nTrades; ++t)
+            column[t] = store.find(ids[t])->pnl.at(windowSerials[s]);
+        portfolioPnl[s] = util::pairwiseSum(column);
+    }
+
+    return stats;
+}
+
+vector<double> RollingVarEngine::tradePnl(size_t t) const
+{
+    vector<double> pnl(windowSerials.size(), 0.0);
+    const ScenarioPnlStore::Entry* e = store.find(idOf(t));
+    if (!e) return pnl;
+    for (size_t s = 0; s < windowSerials.size(); ++s) {
+        auto it = e->pnl.find(windowSerials[s]);
+        if (it != e->pnl.end()) pnl[s] = it->second;
+    }
+    return pnl;
+}
+
+VarResult RollingVarEngine::portfolioVaR(double confidence) const
+{
+    return computeVaR(portfolioPnl, confidence);
+}
+
+map<string, VarResult> RollingVarEngine::varBy(AggregateBy level, double confidence) const
+{
+    map<string, vector<size_t>> members;
+    for (size_t t = 0; t < trades.size(); ++t)
+        members[aggregateKey(*trades[t], level)].push_back(t);
+
+    map<string, VarResult> out;
+    size_t nScen = windowSerials.size();
+    for (const auto& [key, idx] : members) {
+        vector<vector<double>> rows;
+        rows.reserve(idx.size());
+        for (size_t t : idx) rows.push_back(tradePnl(t));
+
+        vector<double> pnl(nScen), column(idx.size());
+        for (size_t s = 0; s < nScen; ++s) {
+            for (size_t k = 0; k < idx.size(); ++k) column[k] = rows[k][s];
+            pnl[s] = util::pairwiseSum(column);
+        }
+        out.emplace(key, computeVaR(pnl, confidence));
+    }
+    return out;
+}
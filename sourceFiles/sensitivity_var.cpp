@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <tuple>
+
+#include "sensitivity_var.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+using util::dateAddTenor;
+
+// ========================
+// Constructor / Setup
+// ========================
+SensitivityVarEngine::SensitivityVarEngine(const Market& base,
+    const vector<shared_ptr<Trade>>& portfolio,
+    shared_ptr<const DiscountTable> table,
+    ThreadPool& threadPool)
+    : baseMarket(base), trades(portfolio), pool(threadPool),
+    revaluer(base, portfolio, move(table), threadPool),
+    fullReval(portfolio.size(), 0)
+{
+}
+
+void SensitivityVarEngine::setScenarios(const vector<HistoricalScenario>& s)
+{
+    scenarios = s;
+
+    // One factor per distinct scenario column, in order of first appearance
+    factors.clear();
+    map<tuple<int, string, string>, size_t> index;
+    auto factorOf = [&](FactorKind kind, const FactorMove& mv) {
+        auto key = make_tuple(static_cast<int>(kind), mv.name, mv.tenor);
+        auto it = index.find(key);
+        if (it != index.end()) return it->second;
+        factors.push_back({ kind, mv.name, mv.tenor });
+        return index[key] = factors.size() - 1;
+    };
+    for (const auto& sc : scenarios) {
+        for (const auto& mv : sc.curveMoves) factorOf(FactorKind::Curve, mv);
+        for (const auto& mv : sc.volMoves) factorOf(FactorKind::Vol, mv);
+        for (const auto& mv : sc.spotMoves) factorOf(FactorKind::Spot, mv);
+    }
+
+    const size_t nF = factors.size();
+    moves.assign(scenarios.size() * nF, 0.0);
+    for (size_t k = 0; k < scenarios.size(); ++k) {
+        double* x = &moves[k * nF];
+        for (const auto& mv : scenarios[k].curveMoves) x[factorOf(FactorKind::Curve, mv)] += mv.move;
+        for (const auto& mv : scenarios[k].volMoves) x[factorOf(FactorKind::Vol, mv)] += mv.move;
+        for (const auto& mv : scenarios[k].spotMoves) x[factorOf(FactorKind::Spot, mv)] += mv.move;
+    }
+    sensitivitiesValid = false;
+}
+
+// ========================
+// Sensitivities
+// ========================
+Market SensitivityVarEngine::bumpedMarket(const RiskFactor& f, double bump) const
+{
+    // Same moves HistoricalScenario::apply makes, one factor at a time
+    Market mkt = baseMarket.overlay();
+    if (f.kind == FactorKind::Curve) {
+        auto curve = make_shared<RateCurve>(*baseMarket.getCurve(f.name));
+        if (f.tenor.empty()) curve->shock(bump);
+        else curve->shock(dateAddTenor(baseMarket.asOf, f.tenor), bump);
+        mkt.addCurve(f.name, curve);
+    }
+    else if (f.kind == FactorKind::Vol) {
+        auto vol = make_shared<VolCurve>(*baseMarket.getVolCurve(f.name));
+        if (f.tenor.empty()) vol->shock(bump);
+        else vol->shock(dateAddTenor(baseMarket.asOf, f.tenor), bump);
+        mkt.addVolCurve(f.name, vol);
+    }
+    else {
+        mkt.shockPrice(f.name, bump);
+    }
+    return mkt;
+}
+
+void SensitivityVarEngine::computeSensitivities()
+{
+    const size_t nTrades = trades.size();
+    const size_t nF = factors.size();
+    const vector<double>& baseDfs = revaluer.getBaseDfs();
+
+    basePv.assign(nTrades, 0.0);
+    pool.parallel_for_range(0, nTrades, 256, [&](size_t lo, size_t hi) {
+        CRRBinomialTreePricer pricer(50);
+        for (size_t t = lo; t < hi; ++t)
+            basePv[t] = revaluer.revalue(t, baseMarket, baseDfs, pricer);
+    });
+
+    // Undeclared inputs cannot be bumped selectively: those trades always fully revalue
+    vector<vector<MarketFactor>> deps(nTrades);
+    for (size_t t = 0; t < nTrades; ++t) {
+        deps[t] = trades[t]->getMarketDependencies();
+        for (const auto& d : deps[t])
+            if (d.kind == FactorKind::Any) fullReval[t] = 1;
+    }
+
+    // Dense scratch, one column per factor so factor tasks never share a cell
+    vector<double> first(nTrades * nF, 0.0), second(nTrades * nF, 0.0);
+    pool.parallel_for(0, nF, 1, [&](size_t j) {
+        const RiskFactor& f = factors[j];
+        const MarketFactor target(f.kind, f.name);
+        vector<size_t> affected;
+        for (size_t t = 0; t < nTrades; ++t)
+            if (!fullReval[t] && find(deps[t].begin(), deps[t].end(), target) != deps[t].end())
+                affected.push_back(t);
+        if (affected.empty()) return;
+
+        const double h = f.kind == FactorKind::Curve ? config.curveBump
+            : f.kind == FactorKind::Vol ? config.volBump : config.spotBump;
+        Market up = bumpedMarket(f, h), down = bumpedMarket(f, -h);
+        vector<double> upDfs, downDfs;
+        if (f.kind == FactorKind::Curve) {
+            revaluer.getDiscountTable()->evaluate(up, upDfs);
+            revaluer.getDiscountTable()->evaluate(down, downDfs);
+        }
+        const vector<double>& uDfs = f.kind == FactorKind::Curve ? upDfs : baseDfs;
+        const vector<double>& dDfs = f.kind == FactorKind::Curve ? downDfs : baseDfs;
+
+        pool.parallel_for_range(0, affected.size(), 256, [&](size_t lo, size_t hi) {
+            CRRBinomialTreePricer pricer(50);
+            for (size_t k = lo; k < hi; ++k) {
+                const size_t t = affected[k];
+                double pu = revaluer.revalue(t, up, uDfs, pricer);
+                double pd = revaluer.revalue(t, down, dDfs, pricer);
+                first[t * nF + j] = (pu - pd) / (2.0 * h);
+                if (f.kind == FactorKind::Spot)
+                    second[t * nF + j] = (pu - 2.0 * basePv[t] + pd) / (h * h);
+            }
+        });
+    });
+
+    sens.assign(nTrades, {});
+    stats.sensitivities = 0;
+    for (size_t t = 0; t < nTrades; ++t) {
+        for (size_t j = 0; j < nF; ++j) {
+            double a = first[t * nF + j], b = second[t * nF + j];
+            if (a != 0.0 || b != 0.0) sens[t].push_back({ j, a, b });
+        }
+        stats.sensitivities += sens[t].size();
+    }
+    stats.factors = nF;
+    sensitivitiesValid = true;
+}
+
+// ========================
+// Scenario P&L
+// ========================
+vector<double> SensitivityVarEngine::fullPnl(const vector<size_t>& idx) const
+{
+    const size_t n = idx.size();
+    vector<double> out(scenarios.size() * n, 0.0);
+    if (n == 0) return out;
+
+    const bool needsDfs = any_of(idx.begin(), idx.end(), [&](size_t t) { return trades[t]->usesDiscountTable(); });
+    revaluer.prepareProxy(scenarios);
+    pool.parallel_for(0, scenarios.size(), 1, [&](size_t s) {
+        Market mkt = scenarios[s].apply(baseMarket);
+        vector<double> dfs;
+        if (needsDfs) revaluer.getDiscountTable()->evaluate(mkt, dfs);
+
+        CRRBinomialTreePricer pricer(50);
+        for (size_t k = 0; k < n; ++k)
+            out[s * n + k] = revaluer.revalue(idx[k], mkt, dfs, pricer) - basePv[idx[k]];
+    });
+    return out;
+}
+
+const PnlCube& SensitivityVarEngine::run()
+{
+    if (!sensitivitiesValid) computeSensitivities();
+
+    const size_t nTrades = trades.size();
+    const size_t nScen = scenarios.size();
+    const size_t nF = factors.size();
+    cube = PnlCube(nTrades, nScen);
+
+    // Sparse sensitivity rows against each scenario's dense move vector
+    pool.parallel_for_range(0, nScen, 16, [&](size_t lo, size_t hi) {
+        for (size_t s = lo; s < hi; ++s) {
+            const double* x = &moves[s * nF];
+            for (size_t t = 0; t < nTrades; ++t) {
+                if (fullReval[t]) continue;
+                double pnl = 0.0;
+                for (const auto& e : sens[t]) {
+                    double dx = x[e.factor];
+                    pnl += e.first * dx + 0.5 * e.second * dx * dx;
+                }
+                cube.at(t, s) = pnl;
+            }
+        }
+    });
+
+    vector<size_t> full;
+    for (size_t t = 0; t < nTrades; ++t)
+        if (fullReval[t]) full.push_back(t);
+    const vector<double> fullValues = fullPnl(full);
+    for (size_t s = 0; s < nScen; ++s)
+        for (size_t k = 0; k < full.size(); ++k)
+            cube.at(full[k], s) = fullValues[s * full.size() + k];
+
+    stats.checked = 0;
+    stats.promoted = 0;
+    ++runCount;
+    if (config.checkEvery > 0 && runCount % config.checkEvery == 0)
+        check(config.sampleSize);
+
+    stats.fullReval = 0;
+    for (char f : fullReval) stats.fullReval += f;
+    stats.approximated = nTrades - stats.fullReval;
+    return cube;
+}
+
+// ========================
+// Error Monitoring
+// ========================
+size_t SensitivityVarEngine::check(size_t sampleSize)
+{
+    const size_t nTrades = trades.size();
+    const size_t nScen = cube.scenarioCount();
+
+    // Next approximated trades after the cursor, wrapping once around the book
+    vector<size_t> sample;
+    for (size_t step = 0; step < nTrades && sample.size() < sampleSize; ++step) {
+        size_t t = (checkCursor + step) % nTrades;
+        if (!fullReval[t]) sample.push_back(t);
+    }
+    if (nTrades > 0 && !sample.empty())
+        checkCursor = (sample.back() + 1) % nTrades;
+
+    const vector<double> full = fullPnl(sample);
+    size_t promoted = 0;
+    for (size_t k = 0; k < sample.size(); ++k) {
+        const size_t t = sample[k];
+        double errSq = 0.0, fullSq = 0.0;
+        for (size_t s = 0; s < nScen; ++s) {
+            double f = full[s * sample.size() + k];
+            double e = cube.at(t, s) - f;
+            errSq += e * e;
+            fullSq += f * f;
+        }
+        double scale = max(sqrt(fullSq / max<size_t>(nScen, 1)), config.absFloor);
+        double rel = sqrt(errSq / max<size_t>(nScen, 1)) / scale;
+        checkErrors[t] = rel;
+
+        if (rel > config.tolerance) {
+            promote(t);
+            ++promoted;
+            for (size_t s = 0; s < nScen; ++s)
+                cube.at(t, s) = full[s * sample.size() + k];
+            cout << "[INFO] Sensitivity VaR: trade " << trades[t]->getId() << " promoted to full revaluation (error "
+                << rel * 100 << "%)" << endl;
+        }
+    }
+
+    stats.checked += sample.size();
+    stats.promoted += promoted;
+    return promoted;
+}
+
+void SensitivityVarEngine::promote(size_t t)
+{
+    fullReval[t] = 1;
+}
+
+// ========================
+// VaR
+// ========================
+VarResult SensitivityVarEngine::portfolioVaR(double confidence) const
+{
+    return computeVaR(cube.portfolioPnl(), confidence);
+}
+
+map<string, VarResult> SensitivityVarEngine::varBy(AggregateBy level, double confidence) const
+{
+    map<string, VarResult> out;
+    auto pnlByKey = cube.reduce([&](size_t t) { return aggregateKey(*trades[t], level); });
+    for (const auto& [key, pnl] : pnlByKey)
+        out.emplace(key, computeVaR(pnl, confidence));
+    return out;
+}
@@ -0,0 +1,148 @@
+#include <stdexcept>
+#include <string>
+
+#include "sobol.h"
+
+namespace {
+
+    // Joe & Kuo primitive polynomials and initial direction numbers for dimensions 2..53.
+    // degree s, interior coefficients a_1..a_{s-1} packed most significant first, odd m_1..m_s
+    struct DirectionInit {
+        int degree;
+        uint32_t a;
+        uint32_t m[8];
+    };
+
+    const DirectionInit kJoeKuo[SobolSequence::kMaxDimensions - 1] = {
+        { 1,   0, { 1 } },
+        { 2,   1, { 1, 3 } },
+        { 3,   1, { 1, 3, 1 } },
+        { 3,   2, { 1, 1, 1 } },
+        { 4,   1, { 1, 1, 3, 3 } },
+        { 4,   4, { 1, 3, 5, 13 } },
+        { 5,   2, { 1, 1, 5, 5, 17 } },
+        { 5,   4, { 1, 1, 5, 5, 5 } },
+        { 5,   7, { 1, 1, 7, 11, 19 } },
+        { 5,  11, { 1, 1, 5, 1, 1 } },
+        { 5,  13, { 1, 1, 1, 3, 11 } },
+        { 5,  14, { 1, 3, 5, 5, 31 } },
+        { 6,   1, { 1, 3, 3, 9, 7, 49 } },
+        { 6,  13, { 1, 1, 1, 15, 21, 21 } },
+        { 6,  16, { 1, 3, 1, 13, 27, 49 } },
+        { 6,  19, { 1, 1, 1, 15, 7, 5 } },
+        { 6,  22, { 1, 3, 1, 15, 13, 25 } },
+        { 6,  25, { 1, 1, 5, 5, 19, 61 } },
+        { 7,   1, { 1, 3, 7, 11, 23, 15, 103 } },
+        { 7,   4, { 1, 3, 7, 13, 13, 15, 69 } },
+        { 7,   7, { 1, 1, 3, 13, 7, 35, 63 } },
+        { 7,   8, { 1, 3, 5, 9, 1, 25, 53 } },
+        { 7,  14, { 1, 3, 1, 13, 9, 35, 107 } },
+        { 7,  19, { 1, 3, 1, 5, 27, 61, 31 } },
+        { 7,  21, { 1, 1, 5, 11, 19, 41, 61 } },
+        { 7,  28, { 1, 3, 5, 3, 3, 13, 69 } },
+        { 7,  31, { 1, 1, 7, 13, 1, 19, 1 } },
+        { 7,  32, { 1, 3, 7, 5, 13, 19, 59 } },
+        { 7,  37, { 1, 1, 3, 9, 25, 29, 41 } },
+        { 7,  41, { 1, 3, 5, 13, 23, 1, 55 } },
+        { 7,  42, { 1, 3, 7, 3, 13, 59, 17 } },
+        { 7,  50, { 1, 3, 1, 3, 5, 53, 69 } },
+        { 7,  55, { 1, 1, 5, 5, 23, 33, 13 } },
+        { 7,  56, { 1, 1, 7, 7, 1, 61, 123 } },
+        { 7,  59, { 1, 1, 7, 9, 13, 61, 49 } },
+        { 7,  62, { 1, 3, 3, 5, 3, 55, 33 } },
+        { 8,  14, { 1, 3, 1, 15, 31, 13, 49, 245 } },
+        { 8,  21, { 1, 3, 5, 15, 31, 59, 63, 97 } },
+        { 8,  22, { 1, 3, 1, 11, 11, 11, 77, 249 } },
+        { 8,  38, { 1, 3, 1, 11, 27, 43, 71, 9 } },
+        { 8,  47, { 1, 1, 7, 15, 21, 11, 81, 45 } },
+        { 8,  49, { 1, 3, 7, 3, 25, 31, 65, 79 } },
+        { 8,  50, { 1, 3, 1, 1, 19, 11, 3, 205 } },
+        { 8,  52, { 1, 1, 5, 9, 19, 21, 29, 157 } },
+        { 8,  56, { 1, 3, 7, 11, 1, 33, 89, 185 } },
+        { 8,  67, { 1, 3, 3, 3, 15, 9, 79, 71 } },
+        { 8,  70, { 1, 3, 7, 11, 15, 39, 119, 27 } },
+        { 8,  84, { 1, 1, 3, 1, 11, 31, 97, 225 } },
+        { 8,  97, { 1, 1, 1, 3, 23, 43, 57, 177 } },
+        { 8, 103, { 1, 3, 7, 7, 17, 17, 37, 71 } },
+        { 8, 115, { 1, 3, 1, 5, 27, 63, 123, 213 } },
+        { 8, 122, { 1, 1, 3, 5, 11, 43, 53, 133 } },
+    };
+
+    int lowestZeroBit(uint64_t n) {
+        int c = 0;
+        while (n & 1) { n >>= 1; ++c; }
+        return c;
+    }
+}
+
+// ===========================
+// Constructor
+// ===========================
+SobolSequence::SobolSequence(size_t dimensions)
+    : dims(dimensions), direction(dimensions * kBits, 0) {
+    if (dims == 0 || dims > kMaxDimensions)
+        throw std::invalid_argument("Sobol sequence supports 1 to " + std::to_string(kMaxDimensions) +
+            " dimensions, got " + std::to_string(dims));
+
+    // Dimension 0 is the van der Corput sequence
+    for (int k = 0; k < kBits; ++k)
+        direction[k] = 1u << (kBits - 1 - k);
+
+    for (size_t d = 1; d < dims; ++d) {
+        const DirectionInit& init = kJoeKuo[d - 1];
+        const int s = init.degree;
+        uint32_t* v = &direction[d * kBits];
+
+        for (int k = 0; k < s && k < kBits; ++k)
+            v[k] = init.m[k] << (kBits - 1 - k);
+
+        // v_k = a_1 v_{k-1} ^ ... ^ a_{s-1} v_{k-s+1} ^ v_{k-s} ^ (v_{k-s} >> s)
+        for (int k = s; k < kBits; ++k) {
+            uint32_t x = v[k - s] ^ (v[k - s] >> s);
+            for (int j = 1; j < s; ++j)
+                if ((init.a >> (s - 1 - j)) & 1u)
+                    x ^= v[k - j];
+            v[k] = x;
+        }
+    }
+}
+
+// ===========================
+// Point Generation
+// ===========================
+void SobolSequence::point(uint64_t index, uint32_t* out) const {
+    if (index >> kBits)
+        throw std::out_of_range("Sobol index exceeds 2^32 points");
+
+    const uint64_t gray = index ^ (index >> 1);
+    for (size_t d = 0; d < dims; ++d) {
+        const uint32_t* v = &direction[d * kBits];
+        uint32_t x = 0;
+        for (int k = 0; k < kBits; ++k)
+            if ((gray >> k) & 1u) x ^= v[k];
+        out[d] = x;
+    }
+}
+
+void SobolSequence::uniforms(uint64_t first, size_t count, const uint32_t* shift, double* u) const {
+    if (count == 0) return;
+    if ((first + count - 1) >> kBits)
+        throw std::out_of_range("Sobol index exceeds 2^32 points");
+
+    std::vector<uint32_t> x(dims);
+    point(first, x.data());
+
+    const double scale = 2.3283064365386963e-10;   // 2^-32
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            // Gray-code step: point n differs from n - 1 by one direction number
+            const int bit = lowestZeroBit(first + i - 1);
+            for (size_t d = 0; d < dims; ++d)
+                x[d] ^= direction[d * kBits + bit];
+        }
+        for (size_t d = 0; d < dims; ++d) {
+            const uint32_t y = shift ? x[d] ^ shift[d] : x[d];
+            u[d * count + i] = (static_cast<double>(y) + 0.5) * scale;
+        }
+    }
+}
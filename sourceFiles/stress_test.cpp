@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+
+#include "stress_test.h"
+#include "chebyshev_proxy.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+using util::dateAddTenor;
+using util::split;
+using util::to_lower;
+using util::to_upper;
+
+namespace {
+    bool isCurveMove(StressMoveType type) {
+        return type == StressMoveType::CurveParallel || type == StressMoveType::CurveShort
+            || type == StressMoveType::CurveLong || type == StressMoveType::CurveTwist
+            || type == StressMoveType::CurveKeyRate;
+    }
+
+    bool isVolMove(StressMoveType type) {
+        return type == StressMoveType::VolAbsolute || type == StressMoveType::VolRelative;
+    }
+
+    // Market factors one move touches; vol names match curves, cubes and surfaces alike
+    vector<MarketFactor> resolve(const StressMove& mv, const vector<MarketFactor>& held) {
+        vector<MarketFactor> out;
+        for (const auto& f : held) {
+            bool kindMatches = isCurveMove(mv.type) ? f.kind == FactorKind::Curve
+                : isVolMove(mv.type) ? (f.kind == FactorKind::Vol || f.kind == FactorKind::SwaptionCube
+                    || f.kind == FactorKind::VolSurface)
+                : f.kind == FactorKind::Spot;
+            if (kindMatches && (mv.target == "*" || mv.target == f.name))
+                out.push_back(f);
+        }
+        return out;
+    }
+
+    void shiftCurve(RateCurve& curve, const StressMove& mv, const Date& asOf) {
+        if (mv.type == StressMoveType::CurveKeyRate) {
+            curve.shock(dateAddTenor(asOf, mv.tenor), mv.size);
+            return;
+        }
+        const vector<Date> pillars = curve.getTenorDates();
+        if (pillars.empty()) return;
+        const double tLast = pillars.back().yearFraction(pillars.front());
+        for (const auto& pillar : pillars) {
+            double t = pillar.yearFraction(pillars.front());
+            double shift = mv.size;
+            switch (mv.type) {
+            case StressMoveType::CurveShort: shift = mv.size * exp(-t / 4.0); break;
+            case StressMoveType::CurveLong:  shift = mv.size * (1.0 - exp(-t / 4.0)); break;
+            case StressMoveType::CurveTwist:
+                shift = tLast > 0.0 ? mv.size + (mv.size2 - mv.size) * t / tLast : mv.size;
+                break;
+            default: break;
+            }
+            curve.shock(pillar, shift);
+        }
+    }
+}
+
+// ========================
+// StressScenario
+// ========================
+Market StressScenario::apply(const Market& base) const
+{
+    Market mkt = base.overlay();
+    const vector<MarketFactor> held = base.getFactors();
+
+    map<string, shared_ptr<RateCurve>> curves;
+    map<string, shared_ptr<VolCurve>> vols;
+    map<string, shared_ptr<SwaptionVolCube>> cubes;
+    map<string, shared_ptr<ImpliedVolSurface>> surfaces;
+
+    for (const auto& mv : moves) {
+        const bool relative = mv.type == StressMoveType::VolRelative;
+        for (const auto& f : resolve(mv, held)) {
+            switch (f.kind) {
+            case FactorKind::Curve: {
+                auto& curve = curves[f.name];
+                if (!curve) curve = make_shared<RateCurve>(*base.getCurve(f.name));
+                shiftCurve(*curve, mv, base.asOf);
+                break;
+            }
+            case FactorKind::Vol: {
+                auto& vol = vols[f.name];
+                if (!vol) vol = make_shared<VolCurve>(*base.getVolCurve(f.name));
+                relative ? vol->scale(1.0 + mv.size) : vol->shock(mv.size);
+                break;
+            }
+            case FactorKind::SwaptionCube: {
+                auto& cube = cubes[f.name];
+                if (!cube) cube = make_shared<SwaptionVolCube>(*base.getSwaptionVolCube(f.name));
+                relative ? cube->scale(1.0 + mv.size) : cube->shock(mv.size);
+                break;
+            }
+            case FactorKind::VolSurface: {
+                auto& surface = surfaces[f.name];
+                if (!surface) surface = make_shared<ImpliedVolSurface>(*base.getVolSurface(f.name));
+                relative ? surface->scale(1.0 + mv.size) : surface->shock(mv.size);
+                break;
+            }
+            case FactorKind::Spot:
+                mkt.shockPrice(f.name, mv.size);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    for (const auto& [name, curve] : curves) mkt.addCurve(name, curve);
+    for (const auto& [name, vol] : vols) mkt.addVolCurve(name, vol);
+    for (const auto& [name, cube] : cubes) mkt.addSwaptionVolCube(name, cube);
+    for (const auto& [name, surface] : surfaces) mkt.addVolSurface(name, surface);
+    return mkt;
+}
+
+vector<MarketFactor> StressScenario::movedFactors(const Market& base) const
+{
+    const vector<MarketFactor> held = base.getFactors();
+    set<MarketFactor> moved;
+    for (const auto& mv : moves)
+        for (const auto& f : resolve(mv, held))
+            moved.insert(f);
+    return vector<MarketFactor>(moved.begin(), moved.end());
+}
+
+vector<StressScenario> loadStressScenarios(const string& filename)
+{
+    string header;
+    vector<string> lines;
+    util::readFromFile(filename, header, lines);
+
+    vector<StressScenario> scenarios;
+    if (header.empty()) {
+        cerr << "[WARN] No stress scenarios loaded from: " << filename << endl;
+        return scenarios;
+    }
+
+    // Moves per scenario as written, with includes kept as (position, name) to expand later
+    struct Raw {
+        vector<StressMove> moves;
+        vector<pair<size_t, string>> includes;
+    };
+    vector<string> order;
+    map<string, Raw> raw;
+
+    for (const auto& line : lines) {
+        if (line.empty()) continue;
+        auto t = split(line, ";");
+        if (t.size() < 3) {
+            cerr << "[WARN] Skipping malformed stress line: " << line << endl;
+            continue;
+        }
+
+        const string name = to_upper(t[0]);
+        const string kind = to_lower(t[1]);
+        auto arg = [&](size_t i) { return i < t.size() ? t[i] : string(); };
+        if (!raw.count(name)) order.push_back(name);
+        Raw& sc = raw[name];
+
+        try {
+            StressMove mv;
+            mv.target = to_upper(t[2]);
+            if (kind == "include") {
+                sc.includes.emplace_back(sc.moves.size(), mv.target);
+                continue;
+            }
+            else if (kind == "parallel") mv.type = StressMoveType::CurveParallel;
+            else if (kind == "short") mv.type = StressMoveType::CurveShort;
+            else if (kind == "long") mv.type = StressMoveType::CurveLong;
+            else if (kind == "twist") {
+                mv.type = StressMoveType::CurveTwist;
+                mv.size2 = stod(arg(4));
+            }
+            else if (kind == "keyrate") {
+                mv.type = StressMoveType::CurveKeyRate;
+                mv.tenor = to_upper(arg(3));
+                mv.size = stod(arg(4));
+                sc.moves.push_back(mv);
+                continue;
+            }
+            else if (kind == "vol_abs") mv.type = StressMoveType::VolAbsolute;
+            else if (kind == "vol_rel") mv.type = StressMoveType::VolRelative;
+            else if (kind == "spot") mv.type = StressMoveType::Spot;
+            else {
+                cerr << "[WARN] Unknown stress move '" << t[1] << "' in: " << line << endl;
+                continue;
+            }
+            mv.size = stod(arg(3));
+            sc.moves.push_back(mv);
+        }
+        catch (const exception& e) {
+            cerr << "[ERROR] Parsing stress move failed: " << line << " => " << e.what() << endl;
+        }
+    }
+
+    // Expand includes depth-first; a cycle or unknown name drops that include only
+    set<string> inProgress;
+    function<vector<StressMove>(const string&)> expand = [&](const string& name) {
+        vector<StressMove> out;
+        const Raw& sc = raw.at(name);
+        inProgress.insert(name);
+        size_t next = 0;
+        auto flushTo = [&](size_t pos) {
+            for (; next < pos; ++next) out.push_back(sc.moves[next]);
+        };
+        for (const auto& [pos, other] : sc.includes) {
+            flushTo(pos);
+            if (!raw.count(other))
+                cerr << "[WARN] Stress scenario " << name << " includes unknown scenario " << other << endl;
+            else if (inProgress.count(other))
+                cerr << "[ERROR] Stress scenario " << name << " includes " << other << " cyclically; ignored" << endl;
+            else {
+                auto sub = expand(other);
+                out.insert(out.end(), sub.begin(), sub.end());
+            }
+        }
+        flushTo(sc.moves.size());
+        inProgress.erase(name);
+        return out;
+    };
+
+    scenarios.reserve(order.size());
+    for (const auto& name : order)
+        scenarios.push_back({ name, expand(name) });
+    return scenarios;
+}
+
+// ========================
+// StressTestEngine
+// ========================
+StressTestEngine::StressTestEngine(const Market& base,
+    const vector<shared_ptr<Trade>>& portfolio,
+    shared_ptr<const DiscountTable> table,
+    ThreadPool& threadPool)
+    : baseMarket(base), trades(portfolio), pool(threadPool), dfTable(move(table))
+{
+    if (!dfTable)
+        dfTable = DiscountTable::build(trades);
+}
+
+void StressTestEngine::setScenarios(vector<StressScenario> s)
+{
+    scenarios = move(s);
+}
+
+void StressTestEngine::loadScenarios(const string& filename)
+{
+    setScenarios(loadStressScenarios(filename));
+}
+
+const PnlCube& StressTestEngine::run()
+{
+    const size_t nTrades = trades.size();
+    const size_t nScen = scenarios.size();
+
+    vector<double> baseDfs;
+    dfTable->evaluate(baseMarket, baseDfs);
+
+    // Full revaluation of trades[idx[k]] into pv[k]: Asians and barriers in one batch, the
+    // rest in parallel chunks
+    auto revalue = [&](const vector<size_t>& idx, const Market& mkt, const vector<double>& dfs, vector<double>& pv) {
+        pv.assign(idx.size(), 0.0);
+        vector<shared_ptr<Trade>> batch;
+        vector<size_t> batchSlots, others;
+        for (size_t k = 0; k < idx.size(); ++k) {
+            if (ExoticBatchPricer::batches(*trades[idx[k]])) {
+                batch.push_back(trades[idx[k]]);
+                batchSlots.push_back(k);
+            }
+            else {
+                others.push_back(k);
+            }
+        }
+        if (!batch.empty()) {
+            const vector<double> batchPv = exoticPricer.price(mkt, batch);
+            for (size_t j = 0; j < batchSlots.size(); ++j) pv[batchSlots[j]] = batchPv[j];
+        }
+        pool.parallel_for_range(0, others.size(), tradeChunk, [&](size_t lo, size_t hi) {
+            CRRBinomialTreePricer pricer(50);
+            for (size_t j = lo; j < hi; ++j) {
+                const auto& trade = trades[idx[others[j]]];
+                pv[others[j]] = trade->usesDiscountTable() ? trade->pvFromTable(dfs, mkt)
+                    : proxy && proxy->covers(*trade) ? proxy->price(mkt, trade) : pricer.price(mkt, trade);
+            }
+        });
+    };
+
+    vector<size_t> all(nTrades);
+    for (size_t t = 0; t < nTrades; ++t) all[t] = t;
+    revalue(all, baseMarket, baseDfs, basePv);
+
+    vector<vector<MarketFactor>> deps(nTrades);
+    for (size_t t = 0; t < nTrades; ++t)
+        deps[t] = trades[t]->getMarketDependencies();
+
+    // Compile once up front: what each scenario moves decides which trades it reprices
+    vector<vector<MarketFactor>> moved(nScen);
+    for (size_t s = 0; s < nScen; ++s) {
+        moved[s] = scenarios[s].movedFactors(baseMarket);
+        if (moved[s].empty())
+            cerr << "[WARN] Stress scenario " << scenarios[s].name << " moves nothing in this market" << endl;
+    }
+
+    cube = PnlCube(nTrades, nScen);
+    atomic<size_t> revaluations{ 0 };
+
+    // Proxy boxes sized to every scenario up front: no serial refits inside the sweep
+    if (proxy)
+        proxy->fitEnvelope(baseMarket, nScen, [&](size_t s) { return scenarios[s].apply(baseMarket); });
+
+    pool.parallel_for(0, nScen, 1, [&](size_t s) {
+        const vector<MarketFactor>& hit = moved[s];
+        vector<size_t> affected;
+        for (size_t t = 0; t < nTrades; ++t) {
+            bool reads = any_of(deps[t].begin(), deps[t].end(), [&](const MarketFactor& f) {
+                return f.kind == FactorKind::Any || binary_search(hit.begin(), hit.end(), f);
+            });
+            if (reads) affected.push_back(t);
+        }
+        if (affected.empty()) return;
+        revaluations += affected.size();
+
+        // One overlay per scenario; DFs are re-evaluated only if a curve moved
+        Market mkt = scenarios[s].apply(baseMarket);
+        vector<double> dfs;
+        bool curveMoved = any_of(hit.begin(), hit.end(), [](const MarketFactor& f) { return f.kind == FactorKind::Curve; });
+        if (curveMoved) dfTable->evaluate(mkt, dfs);
+        const vector<double>& scenarioDfs = curveMoved ? dfs : baseDfs;
+
+        vector<double> pv;
+        revalue(affected, mkt, scenarioDfs, pv);
+        for (size_t k = 0; k < affected.size(); ++k)
+            cube.at(affected[k], s) = pv[k] - basePv[affected[k]];
+    });
+
+    revalCount = revaluations;
+    return cube;
+}
+
+map<string, vector<double>> StressTestEngine::pnlBy(AggregateBy level) const
+{
+    return cube.reduce([&](size_t t) { return aggregateKey(*trades[t], level); });
+}
@@ -2,6 +2,7 @@
 #include "swap.h"
 #include "market.h"
 #include "helper.h"
+#include "discount_table.h"
 
 #include <iostream>
 #include <stdexcept>
@@ -69,14 +70,31 @@ double Swap::getAnnuity(const Market& mkt) const
         Date dt = swapSchedule[i];
         if (dt < valueDate) continue;
 
-        double tau = (swapSchedule[i] - swapSchedule[i - 1]) / 360.0;  // ACT/360
         double df = rc->getDf(dt);
-        annuity += notional * tau * df;
+        annuity += notional * getAccrual(i) * df;
     }
 
     return annuity;
 }
 
+double Swap::getForwardRate(const Market& mkt) const
+{
+    double annuity = getAnnuity(mkt);
+    if (annuity == 0.0)
+        return 0.0;
+
+    const auto& rc = mkt.getCurve(rateCurve);
+    double dfStart = startDate < mkt.asOf ? 1.0 : rc->getDf(startDate);
+    return notional * (dfStart - rc->getDf(maturityDate)) / annuity;
+}
+
+double Swap::getAccrual(size_t i) const
+{
+    if (i == 0 || i >= swapSchedule.size())
+        return 0.0;
+    return swapSchedule[i].diffDays(swapSchedule[i - 1]) / 360.0;  // ACT/360
+}
+
 double Swap::pv(const Market& mkt) const
 {
     if (swapSchedule.empty())
@@ -93,15 +111,78 @@ double Swap::pv(const Market& mkt) const
         Date dt = swapSchedule[i];
         if (dt < valueDate) continue;
 
-        double tau = (swapSchedule[i] - swapSchedule[i - 1]) / 360.0; // ACT/360
         df = rc->getDf(dt);
-        fixPv += notional * tau * tradeRate * df;
+        fixPv += notional * getAccrual(i) * tradeRate * df;
     }
 
     double pv = fixPv + fltPv;
     return isLong_ ? pv : -pv;
 }
 
+// ===== Discount Table Valuation =====
+
+void Swap::registerDates(DiscountTable& table) const
+{
+    for (const auto& dt : swapSchedule)
+        table.addDate(rateCurve, dt);
+}
+
+void Swap::bindDiscountTable(const DiscountTable& table)
+{
+    accruals.assign(swapSchedule.size(), 0.0);
+    dfSlots.assign(swapSchedule.size(), 0);
+    for (size_t i = 0; i < swapSchedule.size(); ++i) {
+        dfSlots[i] = table.getSlot(rateCurve, swapSchedule[i]);
+        accruals[i] = getAccrual(i);
+    }
+    maturitySlot = table.getSlot(rateCurve, maturityDate);
+}
+
+double Swap::pvFromTable(const std::vector<double>& dfs, const Market& mkt) const
+{
+    const Date& asOf = mkt.asOf;
+    if (dfSlots.size() != swapSchedule.size())
+        throw std::runtime_error("Swap not bound to a DiscountTable.");
+
+    double fltPv = notional * (1.0 - dfs[maturitySlot]);
+
+    double fixPv = 0.0;
+    for (size_t i = 1; i < swapSchedule.size(); ++i) {
+        if (swapSchedule[i] < asOf) continue;
+        fixPv += notional * accruals[i] * tradeRate * dfs[dfSlots[i]];
+    }
+
+    double pv = fixPv + fltPv;
+    return isLong_ ? pv : -pv;
+}
+
+double Swap::getAnnuityFromTable(const std::vector<double>& dfs, const Date& asOf) const
+{
+    if (dfSlots.size() != swapSchedule.size())
+        throw std::runtime_error("Swap not bound to a DiscountTable.");
+
+    double annuity = 0.0;
+    for (size_t i = 1; i < swapSchedule.size(); ++i) {
+        if (swapSchedule[i] < asOf) continue;
+        annuity += notional * accruals[i] * dfs[dfSlots[i]];
+    }
+    return annuity;
+}
+
+double Swap::getForwardRateFromTable(const std::vector<double>& dfs, const Date& asOf) const
+{
+    return getForwardRateFromTable(dfs, asOf, getAnnuityFromTable(dfs, asOf));
+}
+
+double Swap::getForwardRateFromTable(const std::vector<double>& dfs, const Date& asOf, double annuity) const
+{
+    if (annuity == 0.0)
+        return 0.0;
+
+    double dfStart = startDate < asOf ? 1.0 : dfs[dfSlots[0]];
+    return notional * (dfStart - dfs[maturitySlot]) / annuity;
+}
+
 double Swap::price(const Market& mkt) const {
     return pv(mkt);
 }
@@ -126,6 +207,12 @@ double Swap::getNotional() const { return notional; }
 const std::string& Swap::getRateCurve() const { return rateCurve; }
 double Swap::getStrike() const { return tradeRate; }
 
+uint64_t Swap::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    double terms[2] = { static_cast<double>(startDate.getSerialDate()), frequency };
+    return util::hashMix(h, terms);
+}
+
 bool Swap::isLong() const {
     return isLong_;
 }
@@ -136,4 +223,9 @@ std::shared_ptr<Trade> Swap::clone() const {
 
 OptionType Swap::getOptionType() const {
     return OptionType::None;
-}
\ No newline at end of file
+}
+
+// Discount curve only
+std::vector<MarketFactor> Swap::getMarketDependencies() const {
+    return { { FactorKind::Curve, rateCurve } };
+}
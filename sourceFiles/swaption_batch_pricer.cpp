@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "swaption_batch_pricer.h"
+
+// ===========================
+// Constructor
+// ===========================
+SwaptionBatchPricer::SwaptionBatchPricer(const std::vector<std::shared_ptr<Trade>>& trades, ThreadPool& threadPool)
+    : pool(threadPool) {
+    for (const auto& trade : trades) {
+        if (auto s = std::dynamic_pointer_cast<const Swaption>(trade))
+            swaptions.push_back(s);
+    }
+
+    for (const auto& s : swaptions)
+        s->registerDates(table);
+    table.finalize();
+
+    const size_t n = swaptions.size();
+    couponBegin.reserve(n + 1);
+    startSlot.reserve(n);
+    endSlot.reserve(n);
+    startSerial.reserve(n);
+    expirySerial.reserve(n);
+    tenor.reserve(n);
+    notional.reserve(n);
+    cubeIndex.reserve(n);
+
+    for (const auto& s : swaptions) {
+        const Swap& swap = s->getSwap();
+        const std::string& curve = swap.getRateCurve();
+        const auto& schedule = swap.getSchedule();
+
+        couponBegin.push_back(couponSlot.size());
+        for (size_t k = 1; k < schedule.size(); ++k) {
+            couponSlot.push_back(table.getSlot(curve, schedule[k]));
+            couponAccrual.push_back(swap.getAccrual(k));
+            couponSerial.push_back(schedule[k].getSerialDate());
+        }
+        startSlot.push_back(table.getSlot(curve, schedule.front()));
+        endSlot.push_back(table.getSlot(curve, schedule.back()));
+        startSerial.push_back(schedule.front().getSerialDate());
+        expirySerial.push_back(s->getExpiry().getSerialDate());
+        tenor.push_back(s->getSwapTenor());
+        notional.push_back(swap.getNotional());
+
+        auto it = std::find(cubeNames.begin(), cubeNames.end(), s->getVolCube());
+        cubeIndex.push_back(static_cast<size_t>(it - cubeNames.begin()));
+        if (it == cubeNames.end())
+            cubeNames.push_back(s->getVolCube());
+    }
+    couponBegin.push_back(couponSlot.size());
+}
+
+// ===========================
+// Pricing
+// ===========================
+std::vector<SwaptionQuote> SwaptionBatchPricer::price(const Market& mkt) const {
+    return price(mkt, table.evaluate(mkt));
+}
+
+std::vector<SwaptionQuote> SwaptionBatchPricer::price(const Market& mkt, const std::vector<double>& dfs) const {
+    if (dfs.size() != table.size())
+        throw std::invalid_argument("Swaption batch: discount factors do not match the batch layout");
+
+    std::vector<SwaptionQuote> quotes(swaptions.size());
+    if (swaptions.empty()) return quotes;
+
+    std::vector<const SwaptionVolCube*> cubes;
+    std::vector<std::shared_ptr<SwaptionVolCube>> keepAlive;
+    for (const auto& name : cubeNames) {
+        keepAlive.push_back(mkt.getSwaptionVolCube(name));
+        cubes.push_back(keepAlive.back().get());
+    }
+
+    const long asOf = mkt.asOf.getSerialDate();
+    pool.parallel_for_range(0, swaptions.size(), kChunk, [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            // Same sums as Swap::getAnnuityFromTable / getForwardRateFromTable, off the flat layout
+            double annuity = 0.0;
+            for (size_t c = couponBegin[i]; c < couponBegin[i + 1]; ++c) {
+                if (couponSerial[c] < asOf) continue;
+                annuity += notional[i] * couponAccrual[c] * dfs[couponSlot[c]];
+            }
+
+            double forward = 0.0;
+            if (annuity != 0.0) {
+                double dfStart = startSerial[i] < asOf ? 1.0 : dfs[startSlot[i]];
+                forward = notional[i] * (dfStart - dfs[endSlot[i]]) / annuity;
+            }
+            double expiry = static_cast<double>(expirySerial[i] - asOf) / 365.0;   // ACT/365, as Date::operator-
+            quotes[i] = SwaptionPricer::quote(*swaptions[i], *cubes[cubeIndex[i]], expiry, tenor[i], annuity, forward);
+        }
+    });
+    return quotes;
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "swaption_pricer.h"
+#include "payoff.h"
+#include "helper.h"
+
+// ===========================
+// Closed Forms
+// ===========================
+double SwaptionPricer::blackUnit(OptionType optType, double F, double K, double vol, double T) {
+    if (T <= 0.0 || vol <= 0.0 || F <= 0.0 || K <= 0.0)
+        return PAYOFF::VanillaOption(optType, K, F);
+    const double sd = vol * std::sqrt(T);
+    const double d1 = (std::log(F / K) + 0.5 * sd * sd) / sd;
+    const double d2 = d1 - sd;
+    if (optType == OptionType::Call)
+        return F * util::normCdf(d1) - K * util::normCdf(d2);
+    return K * util::normCdf(-d2) - F * util::normCdf(-d1);
+}
+
+double SwaptionPricer::blackVega(double F, double K, double vol, double T) {
+    if (T <= 0.0 || vol <= 0.0 || F <= 0.0 || K <= 0.0)
+        return 0.0;
+    const double sqrtT = std::sqrt(T);
+    const double d1 = (std::log(F / K) + 0.5 * vol * vol * T) / (vol * sqrtT);
+    return F * sqrtT * util::normPdf(d1);
+}
+
+double SwaptionPricer::bachelierUnit(OptionType optType, double F, double K, double vol, double T) {
+    if (T <= 0.0 || vol <= 0.0)
+        return PAYOFF::VanillaOption(optType, K, F);
+    const double sd = vol * std::sqrt(T);
+    const double d = (F - K) / sd;
+    const double w = optType == OptionType::Call ? 1.0 : -1.0;
+    return w * (F - K) * util::normCdf(w * d) + sd * util::normPdf(d);
+}
+
+double SwaptionPricer::bachelierVega(double F, double K, double vol, double T) {
+    if (T <= 0.0 || vol <= 0.0)
+        return 0.0;
+    const double sqrtT = std::sqrt(T);
+    return sqrtT * util::normPdf((F - K) / (vol * sqrtT));
+}
+
+// ===========================
+// Pricing
+// ===========================
+SwaptionQuote SwaptionPricer::quote(const Swaption& trade, const SwaptionVolCube& cube, const Date& asOf,
+    double annuity, double forward) {
+    if (annuity == 0.0) {
+        SwaptionQuote q;
+        q.forward = forward;
+        return q;
+    }
+    return quote(trade, cube, trade.getExpiry() - asOf, trade.getSwapTenor(), annuity, forward);
+}
+
+SwaptionQuote SwaptionPricer::quote(const Swaption& trade, const SwaptionVolCube& cube, double expiry,
+    double tenor, double annuity, double forward) {
+    SwaptionQuote q;
+    q.forward = forward;
+    q.annuity = annuity;
+    if (annuity == 0.0) return q;
+
+    const double T = std::max(expiry, 0.0);
+    const double K = trade.getStrike();
+    const OptionType type = trade.getOptionType();
+    q.vol = cube.getVol(T, tenor, K, forward);
+
+    double unit, unitVega;
+    if (cube.getType() == SwaptionVolType::Normal) {
+        unit = bachelierUnit(type, forward, K, q.vol, T);
+        unitVega = bachelierVega(forward, K, q.vol, T);
+    }
+    else {
+        unit = blackUnit(type, forward, K, q.vol, T);
+        unitVega = blackVega(forward, K, q.vol, T);
+    }
+
+    const double sign = trade.isLong() ? 1.0 : -1.0;
+    q.pv = sign * annuity * unit;
+    q.vega = sign * annuity * unitVega;
+    return q;
+}
+
+double SwaptionPricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    auto swaption = std::dynamic_pointer_cast<Swaption>(trade);
+    if (!swaption)
+        throw std::runtime_error("Swaption pricer only supports Swaption");
+
+    const Swap& swap = swaption->getSwap();
+    auto cube = mkt.getSwaptionVolCube(swaption->getVolCube());
+    return quote(*swaption, *cube, mkt.asOf, swap.getAnnuity(mkt), swap.getForwardRate(mkt)).pv;
+}
@@ -0,0 +1,113 @@
+#include "swaption_trade.h"
+#include "swaption_pricer.h"
+#include "discount_table.h"
+#include "payoff.h"
+#include "market.h"
+#include "helper.h"
+
+#include <stdexcept>
+
+using util::to_upper;
+
+namespace {
+    // USD-SOFR -> USD-SWPN
+    std::string defaultVolCube(const std::string& curve) {
+        return curve.substr(0, curve.find('-')) + "-SWPN";
+    }
+}
+
+// === Swaption ===
+
+Swaption::Swaption(OptionType _optType,
+    double _notional,
+    double _strike,
+    const Date& _tradeDate,
+    const Date& _expiryDate,
+    const Date& _swapEndDate,
+    double _frequency,
+    const std::string& _rateCurve,
+    bool _isLong,
+    const std::string& _volCube)
+    : Trade("Swaption", _tradeDate),
+    optType(_optType),
+    strike(_strike),
+    expiryDate(_expiryDate),
+    swapEnd(_swapEndDate),
+    volCube(_volCube.empty() ? defaultVolCube(to_upper(_rateCurve)) : to_upper(_volCube)),
+    swap(_rateCurve, _expiryDate, _swapEndDate, _notional, _strike, _frequency) {
+    if (_optType != OptionType::Call && _optType != OptionType::Put)
+        throw std::invalid_argument("Swaption must be a call (payer) or a put (receiver).");
+    if (_expiryDate <= _tradeDate)
+        throw std::invalid_argument("Expiry must be after trade date.");
+    if (_swapEndDate <= _expiryDate)
+        throw std::invalid_argument("Swap end must be after the swaption expiry.");
+    if (_rateCurve.empty())
+        throw std::invalid_argument("Rate curve cannot be empty.");
+    isLong_ = _isLong;
+}
+
+std::shared_ptr<Trade> Swaption::clone() const {
+    return std::make_shared<Swaption>(*this);
+}
+
+const std::string& Swaption::getType() const { return tradeType; }
+const std::string& Swaption::getUnderlying() const { return swap.getUnderlying(); }
+double Swaption::getNotional() const { return swap.getNotional(); }
+OptionType Swaption::getOptionType() const { return optType; }
+double Swaption::getStrike() const { return strike; }
+double Swaption::getSwapTenor() const { return swapEnd - expiryDate; }
+
+double Swaption::payoff(double swapRate) const {
+    double raw = PAYOFF::VanillaOption(optType, strike, swapRate);
+    return isLong_ ? raw : -raw;
+}
+
+double Swaption::payoff(const Market& market) const {
+    return payoff(swap.getForwardRate(market)) * swap.getAnnuity(market);
+}
+
+double Swaption::valueAtNode(double, double, double continuation) const {
+    return continuation;   // European
+}
+
+double Swaption::price(const Market& mkt) const {
+    return pv(mkt);
+}
+
+double Swaption::pv(const Market& mkt) const {
+    SwaptionPricer pricer;
+    return pricer.price(mkt, std::const_pointer_cast<Trade>(shared_from_this()));
+}
+
+// ===== Discount Table Valuation =====
+
+void Swaption::registerDates(DiscountTable& table) const {
+    swap.registerDates(table);
+}
+
+void Swaption::bindDiscountTable(const DiscountTable& table) {
+    swap.bindDiscountTable(table);
+}
+
+double Swaption::pvFromTable(const std::vector<double>& dfs, const Market& mkt) const {
+    auto cube = mkt.getSwaptionVolCube(volCube);
+    double annuity = swap.getAnnuityFromTable(dfs, mkt.asOf);
+    double forward = swap.getForwardRateFromTable(dfs, mkt.asOf, annuity);
+    return SwaptionPricer::quote(*this, *cube, mkt.asOf, annuity, forward).pv;
+}
+
+uint64_t Swaption::fingerprint() const {
+    uint64_t h = Trade::fingerprint();
+    h = util::hashMix(h, swapEnd.getSerialDate());
+    h = util::hashMix(h, swap.getFrequency());
+    return util::hashMix(h, volCube);
+}
+
+const Date& Swaption::getExpiry() const { return expiryDate; }
+const Date& Swaption::getTradeDate() const { return tradeDate; }
+const std::string& Swaption::getRateCurve() const { return swap.getRateCurve(); }
+
+// Curve for annuity and forward, cube for the smile
+std::vector<MarketFactor> Swaption::getMarketDependencies() const {
+    return { { FactorKind::Curve, getRateCurve() }, { FactorKind::SwaptionCube, volCube } };
+}
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include "swaption_vol_cube.h"
+
+using namespace std;
+
+namespace {
+
+    // Bracketing index and weight on a sorted axis; flat beyond either end
+    void bracket(const vector<double>& axis, double x, size_t& i, double& w) {
+        if (axis.size() == 1 || x <= axis.front()) { i = 0; w = 0.0; return; }
+        if (x >= axis.back()) { i = axis.size() - 2; w = 1.0; return; }
+        i = static_cast<size_t>(upper_bound(axis.begin(), axis.end(), x) - axis.begin()) - 1;
+        w = (x - axis[i]) / (axis[i + 1] - axis[i]);
+    }
+}
+
+// ===== Constructors =====
+
+SwaptionVolCube::SwaptionVolCube() = default;
+
+SwaptionVolCube::SwaptionVolCube(const string& _name, SwaptionVolType _type)
+    : name(_name), type(_type) {
+}
+
+// ===== Construction =====
+
+void SwaptionVolCube::setStrikeOffsets(const vector<double>& strikeOffsets) {
+    if (strikeOffsets.empty())
+        throw invalid_argument("Swaption vol cube needs at least one strike offset.");
+    if (!is_sorted(strikeOffsets.begin(), strikeOffsets.end()) ||
+        adjacent_find(strikeOffsets.begin(), strikeOffsets.end()) != strikeOffsets.end())
+        throw invalid_argument("Swaption vol cube strike offsets must be strictly increasing.");
+    if (!smiles.empty() && strikeOffsets.size() != offsets.size())
+        throw invalid_argument("Cannot change the number of strike offsets once smiles are loaded.");
+    offsets = strikeOffsets;
+}
+
+void SwaptionVolCube::addSmile(double expiry, double tenor, const vector<double>& smileVols) {
+    if (offsets.empty())
+        throw runtime_error("Swaption vol cube " + name + ": set strike offsets before adding smiles.");
+    if (smileVols.size() != offsets.size())
+        throw invalid_argument("Swaption vol cube " + name + ": smile size does not match strike offsets.");
+    if (expiry < 0.0 || tenor <= 0.0)
+        throw invalid_argument("Swaption vol cube " + name + ": invalid expiry or tenor.");
+
+    smiles[{ expiry, tenor }] = smileVols;
+    rebuildGrid();
+}
+
+void SwaptionVolCube::rebuildGrid() {
+    expiries.clear();
+    tenors.clear();
+    for (const auto& [node, _] : smiles) {
+        expiries.push_back(node.first);
+        tenors.push_back(node.second);
+    }
+    sort(expiries.begin(), expiries.end());
+    expiries.erase(unique(expiries.begin(), expiries.end()), expiries.end());
+    sort(tenors.begin(), tenors.end());
+    tenors.erase(unique(tenors.begin(), tenors.end()), tenors.end());
+
+    // Nodes missing from a ragged grid stay NaN and are rejected when a lookup needs them
+    const size_t nk = offsets.size();
+    grid.assign(expiries.size() * tenors.size() * nk, numeric_limits<double>::quiet_NaN());
+    for (const auto& [node, v] : smiles) {
+        size_t e = lower_bound(expiries.begin(), expiries.end(), node.first) - expiries.begin();
+        size_t t = lower_bound(tenors.begin(), tenors.end(), node.second) - tenors.begin();
+        copy(v.begin(), v.end(), grid.begin() + (e * tenors.size() + t) * nk);
+    }
+}
+
+// ===== Lookup =====
+
+double SwaptionVolCube::smileVol(size_t e, size_t t, size_t k, double w) const {
+    const size_t nk = offsets.size();
+    const double* smile = grid.data() + (e * tenors.size() + t) * nk;
+    double v = nk == 1 ? smile[0] : smile[k] + w * (smile[k + 1] - smile[k]);
+    if (std::isnan(v))
+        throw runtime_error("Swaption vol cube " + name + " has no smile at expiry " +
+            to_string(expiries[e]) + ", tenor " + to_string(tenors[t]));
+    return v;
+}
+
+double SwaptionVolCube::getVol(double expiry, double tenor, double strike, double forward) const {
+    if (grid.empty())
+        throw runtime_error("Swaption vol cube " + name + " is empty.");
+
+    size_t e, t, k;
+    double we, wt, wk;
+    bracket(expiries, expiry, e, we);
+    bracket(tenors, tenor, t, wt);
+    bracket(offsets, strike - forward, k, wk);
+
+    const size_t e1 = expiries.size() > 1 ? e + 1 : e;
+    const size_t t1 = tenors.size() > 1 ? t + 1 : t;
+    auto corner = [&](size_t ei, size_t ti, double weight) {
+        return weight == 0.0 ? 0.0 : weight * smileVol(ei, ti, k, wk);
+    };
+    return corner(e, t, (1.0 - we) * (1.0 - wt)) + corner(e, t1, (1.0 - we) * wt) +
+        corner(e1, t, we * (1.0 - wt)) + corner(e1, t1, we * wt);
+}
+
+// ===== Shocks =====
+
+void SwaptionVolCube::shock(double delta) {
+    for (auto& [_, v] : smiles)
+        for (double& x : v) x += delta;
+    for (double& x : grid) x += delta;
+}
+
+void SwaptionVolCube::scale(double factor) {
+    for (auto& [_, v] : smiles)
+        for (double& x : v) x *= factor;
+    for (double& x : grid) x *= factor;
+}
+
+// ===== Display =====
+
+void SwaptionVolCube::display() const {
+    cout << "Swaption vol cube: " << name
+        << (type == SwaptionVolType::Normal ? " (normal)" : " (lognormal)") << endl;
+    for (const auto& [node, v] : smiles) {
+        cout << node.first << "Y x " << node.second << "Y:";
+        for (double x : v) cout << " " << x;
+        cout << endl;
+    }
+}
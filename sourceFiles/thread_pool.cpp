@@ -0,0 +1,114 @@
+#include "thread_pool.h"
+
+using namespace std;
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentIndex = 0;
+
+// ===== Constructor / Destructor =====
+
+ThreadPool::ThreadPool(size_t numThreads) {
+    if (numThreads == 0) numThreads = 1;
+
+    queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+        queues.push_back(make_unique<WorkerQueue>());
+
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+        workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stop = true;
+    }
+    sleepCv.notify_all();
+    parkCv.notify_all();
+    for (auto& t : workers)
+        t.join();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+size_t ThreadPool::defaultGrain(size_t count, size_t tasksPerWorker) const {
+    size_t chunks = max<size_t>(1, workers.size() * tasksPerWorker);
+    return max<size_t>(1, (count + chunks - 1) / chunks);
+}
+
+// ===== Scheduling =====
+
+void ThreadPool::push(function<void()> task) {
+    // Workers keep their own tasks local; external threads spread work round robin
+    size_t target = (currentPool == this) ? currentIndex
+        : nextQueue.fetch_add(1, memory_order_relaxed) % queues.size();
+    // Count the task before publishing it so a thief can never drive the counter below zero
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        pending.fetch_add(1, memory_order_release);
+    }
+    {
+        lock_guard<mutex> lock(queues[target]->mtx);
+        queues[target]->tasks.push_back(move(task));
+    }
+    sleepCv.notify_one();
+    if (parked.load(memory_order_relaxed) > 0)   // pending rose under sleepMutex, so no lost wakeup
+        parkCv.notify_all();
+}
+
+void ThreadPool::notifyParked() {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (parked.load(memory_order_relaxed) == 0) return;
+    lock_guard<mutex> lock(sleepMutex);
+    parkCv.notify_all();
+}
+
+bool ThreadPool::tryRunOne() {
+    function<void()> task;
+    size_t n = queues.size();
+    bool isWorker = (currentPool == this);
+    size_t self = isWorker ? currentIndex : 0;
+
+    // Own queue first (LIFO)
+    if (isWorker) {
+        lock_guard<mutex> lock(queues[self]->mtx);
+        if (!queues[self]->tasks.empty()) {
+            task = move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+
+    // Steal from the front of the other queues (FIFO)
+    for (size_t k = 1; !task && k <= n; ++k) {
+        size_t victim = (self + k) % n;
+        if (isWorker && victim == self) continue;
+        lock_guard<mutex> lock(queues[victim]->mtx);
+        if (!queues[victim]->tasks.empty()) {
+            task = move(queues[victim]->tasks.front());
+            queues[victim]->tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+    pending.fetch_sub(1, memory_order_acq_rel);
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+
+    while (true) {
+        if (tryRunOne()) continue;
+
+        unique_lock<mutex> lock(sleepMutex);
+        sleepCv.wait(lock, [this] { return stop || pending.load(memory_order_acquire) > 0; });
+        if (stop && pending.load(memory_order_acquire) == 0)
+            return;
+    }
+}
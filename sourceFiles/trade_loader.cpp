@@ -0,0 +1,91 @@
+#include <stdexcept>
+#include <unordered_map>
+
+#include "trade_loader.h"
+#include "factory.h"
+#include "asian_trade.h"
+#include "barrier_trade.h"
+#include "swaption_trade.h"
+#include "bermudan_swaption_trade.h"
+#include "helper.h"
+
+using namespace std;
+using namespace util;
+
+shared_ptr<Trade> parseTradeRow(const string& line) {
+    auto t = split(line, ";");
+    if (t.size() < 12)
+        throw invalid_argument("Malformed trade row: " + line);
+
+    string type = to_lower(t[1]);
+    Date tradeDate = parseDate(t[2]);
+    Date startDate = parseDate(t[3]);
+    Date endDate = parseDate(t[4]);
+    double notional = stod(t[5]);
+    string underlying = t[6];
+    if (underlying == "SGD-MAS-BILL") underlying = "SGD-SORA";
+    double rate = stod(t[7]);
+    double strike = stod(t[8]);
+    double freq = stod(t[9]);
+    string optionStr = to_lower(t[10]);
+    string direction = to_lower(t[11]);
+    string book = (t.size() > 12 && !t[12].empty()) ? to_upper(t[12]) : "DEFAULT";
+    string nettingSet = t.size() > 13 ? to_upper(t[13]) : "";
+
+    OptionType optType = OptionType::None;
+    if (optionStr == "call") optType = OptionType::Call;
+    else if (optionStr == "put") optType = OptionType::Put;
+
+    bool isLong = (direction == "long");
+
+    shared_ptr<Trade> trade;
+    if (type == "bond")
+        trade = BondFactory().createTrade(underlying, startDate, endDate, notional, rate, freq, optType);
+    else if (type == "swap")
+        trade = SwapFactory().createTrade(underlying, startDate, endDate, notional, rate, freq, optType);
+    else if (type == "european")
+        trade = make_shared<EuropeanOption>(optType, notional, strike, tradeDate, endDate, underlying);
+    else if (type == "american")
+        trade = make_shared<AmericanOption>(optType, notional, strike, tradeDate, endDate, underlying);
+    else if (type == "asian-arith" || type == "asian-geo") {
+        // start_dt opens the averaging window, freq is the fixing interval in years
+        AverageType avgType = type == "asian-geo" ? AverageType::Geometric : AverageType::Arithmetic;
+        trade = make_shared<AsianOption>(optType, avgType, notional, strike, tradeDate, startDate, endDate, freq, underlying);
+    }
+    else if (type.rfind("barrier-", 0) == 0) {
+        // rate column carries the barrier level
+        static const unordered_map<string, BarrierType> barrierTypes = {
+            { "barrier-uo", BarrierType::UpAndOut }, { "barrier-ui", BarrierType::UpAndIn },
+            { "barrier-do", BarrierType::DownAndOut }, { "barrier-di", BarrierType::DownAndIn } };
+        auto it = barrierTypes.find(type);
+        if (it == barrierTypes.end())
+            throw runtime_error("Unknown barrier type: " + type);
+        trade = make_shared<BarrierOption>(optType, it->second, notional, strike, rate, tradeDate, endDate, underlying);
+    }
+    else if (type == "bond-callable") {
+        // option column is the no-call period; callable on every later coupon date at strike per 100
+        trade = BondFactory().createTrade(underlying, startDate, endDate, notional, rate, freq, optType);
+        auto bond = dynamic_pointer_cast<Bond>(trade);
+        Date firstCall = dateAddTenor(startDate, optionStr);
+        vector<Date> calls;
+        for (const auto& d : bond->getSchedule())
+            if (!(d < firstCall) && d < endDate) calls.push_back(d);
+        bond->setCallSchedule(calls, strike / 100.0);
+    }
+    else if (type == "bermudan") {
+        // start_dt is the first exercise, end_dt the swap end; exercisable on every reset
+        trade = make_shared<BermudanSwaption>(optType, notional, strike, tradeDate, startDate, endDate, freq, underlying);
+    }
+    else if (type == "swaption") {
+        // start_dt is the expiry (and swap start), end_dt the swap end; call = payer
+        trade = make_shared<Swaption>(optType, notional, strike, tradeDate, startDate, endDate, freq, underlying);
+    }
+
+    if (trade) {
+        trade->setLong(isLong);
+        trade->setId(t[0]);
+        trade->setBook(book);
+        trade->setNettingSet(nettingSet);
+    }
+    return trade;
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 #include <vector>
@@ -101,4 +102,75 @@ void JRRNBinomialTreePricer::modelSetup(double S0, double sigma, double rate, do
     d = std::exp((rate - 0.5 * sigma * sigma) * dt - sigma * std::sqrt(dt));
     p = (std::exp(rate * dt) - d) / (u - d);
     currentSpot = S0;
-}
\ No newline at end of file
+}
+
+// ===========================
+// Early-Exercise Lattice
+// ===========================
+
+EarlyExerciseLatticePricer::EarlyExerciseLatticePricer(int N)
+    : nTimeSteps(N) {
+}
+
+double EarlyExerciseLatticePricer::price(const Market& mkt, std::shared_ptr<Trade> trade) const {
+    if (!trade) throw std::invalid_argument("Null trade pointer");
+    if (!std::dynamic_pointer_cast<AmericanOption>(trade) && !std::dynamic_pointer_cast<AmerCallSpread>(trade))
+        return trade->pv(mkt);
+
+    const Date& expiry = trade->getExpiry();
+    double S = mkt.getStockPrice(trade->getUnderlying());
+    double sigma = mkt.getVolCurve("LOGVOL")->getVol(expiry);
+    double rate = mkt.getCurve(trade->getRateCurve())->getRate(expiry);
+    // Trade payoffs carry the direction; the lattice exercises for the holder, the long side
+    const double sign = trade->isLong() ? 1.0 : -1.0;
+    auto exercise = [&](double s) { return sign * trade->payoff(s); };
+
+    double value = profile(exercise, S, expiry - mkt.asOf, rate, sigma, nTimeSteps, { 1.0 })[0];
+    return sign * value;
+}
+
+std::vector<double> EarlyExerciseLatticePricer::profile(const std::function<double(double)>& exercise,
+    double S, double T, double r, double sigma, int N, const std::vector<double>& ratios) {
+    std::vector<double> out(ratios.size());
+    if (T <= 0.0) {
+        for (size_t i = 0; i < ratios.size(); ++i) out[i] = exercise(S * ratios[i]);
+        return out;
+    }
+
+    N = std::max(N, 1);
+    double maxLog = 0.0;
+    for (double x : ratios) maxLog = std::max(maxLog, std::fabs(std::log(x)));
+
+    const double dt = T / N;
+    const double h = sigma * std::sqrt(dt);
+    const double u = std::exp(h), d = 1.0 / u;
+    const double p = (std::exp(r * dt) - d) / (u - d);
+    const double disc = std::exp(-r * dt);
+    // W extra nodes each side, so the first layer holds 2W + 1 spots spaced 2h apart
+    const int W = int(std::ceil(maxLog / (2.0 * h))) + 2;
+
+    // Spot at log-exponent e (units of h), e in [-(N + 2W), N + 2W]
+    const int eMax = N + 2 * W;
+    std::vector<double> spot(2 * eMax + 1);
+    for (int e = -eMax; e <= eMax; ++e) spot[e + eMax] = S * std::exp(e * h);
+
+    std::vector<double> V(N + 2 * W + 1);
+    for (int i = 0; i <= N + 2 * W; ++i) V[i] = exercise(spot[2 * i]);
+    for (int k = N - 1; k >= 0; --k) {
+        const int e0 = -(k + 2 * W);
+        for (int i = 0; i <= k + 2 * W; ++i) {
+            double cont = disc * (p * V[i + 1] + (1.0 - p) * V[i]);
+            V[i] = std::max(cont, exercise(spot[e0 + 2 * i + eMax]));
+        }
+    }
+
+    for (size_t j = 0; j < ratios.size(); ++j) {
+        double f = std::log(ratios[j]) / (2.0 * h) + W;
+        int i0 = std::min(std::max(int(std::floor(f + 0.5)) - 1, 0), 2 * W - 2);
+        double x = f - i0;
+        out[j] = V[i0] * (x - 1.0) * (x - 2.0) / 2.0
+            - V[i0 + 1] * x * (x - 2.0)
+            + V[i0 + 2] * x * (x - 1.0) / 2.0;
+    }
+    return out;
+}
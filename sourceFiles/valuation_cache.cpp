@@ -0,0 +1,92 @@
+#include <algorithm>
+
+#include "valuation_cache.h"
+
+using namespace std;
+
+// ===== Constructor =====
+
+ValuationCache::ValuationCache(size_t capacity, size_t shardCount) {
+    shardCount = max<size_t>(1, shardCount);
+    shardCapacity = max<size_t>(1, (capacity + shardCount - 1) / shardCount);
+    shards.reserve(shardCount);
+    for (size_t i = 0; i < shardCount; ++i)
+        shards.push_back(make_unique<Shard>());
+}
+
+ValuationCache::Shard& ValuationCache::shardOf(const ValuationKey& key) {
+    // High bits pick the shard; the shard's own table uses the full hash
+    size_t h = ValuationKeyHash()(key);
+    return *shards[(h >> 17) % shards.size()];
+}
+
+// ===== Lookup / Insert =====
+
+bool ValuationCache::find(const ValuationKey& key, double& value) {
+    Shard& shard = shardOf(key);
+    {
+        lock_guard<mutex> lock(shard.mtx);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            value = it->second->second;
+            ++hitCount;
+            return true;
+        }
+    }
+    ++missCount;
+    return false;
+}
+
+void ValuationCache::insert(const ValuationKey& key, double value) {
+    Shard& shard = shardOf(key);
+    lock_guard<mutex> lock(shard.mtx);
+
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->second->second = value;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        return;
+    }
+
+    shard.lru.emplace_front(key, value);
+    shard.index.emplace(key, shard.lru.begin());
+    while (shard.lru.size() > shardCapacity) {
+        shard.index.erase(shard.lru.back().first);
+        shard.lru.pop_back();
+        ++evictionCount;
+    }
+}
+
+// ===== Statistics =====
+
+CacheStats ValuationCache::stats() const {
+    CacheStats s;
+    s.hits = hitCount;
+    s.misses = missCount;
+    s.evictions = evictionCount;
+    for (const auto& shard : shards) {
+        lock_guard<mutex> lock(shard->mtx);
+        s.entries += shard->lru.size();
+    }
+    return s;
+}
+
+void ValuationCache::resetStats() {
+    hitCount = 0;
+    missCount = 0;
+    evictionCount = 0;
+}
+
+void ValuationCache::clear() {
+    for (auto& shard : shards) {
+        lock_guard<mutex> lock(shard->mtx);
+        shard->lru.clear();
+        shard->index.clear();
+    }
+}
+
+ValuationCache& ValuationCache::global() {
+    static ValuationCache cache;
+    return cache;
+}
@@ -62,6 +62,11 @@ void VolCurve::shock(double delta) {
     for (auto& v : vols) v += delta;
 }
 
+// ===== Scale all vols by factor =====
+void VolCurve::scale(double factor) {
+    for (auto& v : vols) v *= factor;
+}
+
 // ===== Shock a specific tenor by delta =====
 void VolCurve::shock(const Date& tenor, double delta) {
     for (size_t i = 0; i < tenors.size(); ++i) {
@@ -0,0 +1,165 @@
+#include <stdexcept>
+
+#include "what_if_analyzer.h"
+#include "tree_pricer.h"
+#include "helper.h"
+
+using namespace std;
+
+namespace {
+    // Same methods the VaR engines revalue with; the candidate is not bound to the
+    // discount table, so rate trades discount off the curves directly
+    double revalueCandidate(const shared_ptr<Trade>& trade, const Market& mkt, const BinomialTreePricer& pricer) {
+        return trade->usesDiscountTable() ? trade->pv(mkt) : pricer.price(mkt, trade);
+    }
+
+    void accumulate(map<string, double>& into, const map<string, double>& from, double sign) {
+        for (const auto& [key, v] : from) into[key] += sign * v;
+    }
+}
+
+// ===== Constructor =====
+
+WhatIfAnalyzer::WhatIfAnalyzer(const PortfolioValuer& portfolioValuer, double conf, ThreadPool& threadPool)
+    : valuer(portfolioValuer), confidence(conf), pool(threadPool)
+{
+    if (confidence <= 0.0 || confidence >= 1.0)
+        throw invalid_argument("VaR confidence must be in (0, 1).");
+    refresh();
+}
+
+void WhatIfAnalyzer::refresh() {
+    baseTotal = valuer.total();
+    baseDv01.clear();
+    baseVega.clear();
+    for (const auto& r : valuer.getResults()) {
+        accumulate(baseDv01, r.dv01Buckets, 1.0);
+        accumulate(baseVega, r.vegaBuckets, 1.0);
+    }
+}
+
+// ===== Scenario P&L =====
+
+void WhatIfAnalyzer::attach(const HistoricalVarEngine& var) {
+    const PnlCube& cube = var.getCube();
+    if (cube.tradeCount() != valuer.getTrades().size() || cube.scenarioCount() != var.getScenarios().size())
+        throw invalid_argument("WhatIfAnalyzer: VaR engine has not been run on this portfolio");
+
+    bookedPnl = [&cube](size_t t) {
+        vector<double> pnl(cube.scenarioCount());
+        for (size_t s = 0; s < pnl.size(); ++s) pnl[s] = cube.at(t, s);
+        return pnl;
+    };
+    attachScenarios(var.getScenarios(), cube.portfolioPnl());
+}
+
+void WhatIfAnalyzer::attach(const RollingVarEngine& var) {
+    bookedPnl = [&var](size_t t) { return var.tradePnl(t); };
+    attachScenarios(var.getWindowScenarios(), var.getPortfolioPnl());
+}
+
+void WhatIfAnalyzer::attachScenarios(const vector<HistoricalScenario>& scenarios, vector<double> pnl) {
+    if (pnl.size() != scenarios.size())
+        throw invalid_argument("WhatIfAnalyzer: scenario P&L does not match the scenario set");
+
+    // Overlays share every unmoved object with the valuer's market, so this is cheap to hold
+    const Market& base = valuer.getMarket();
+    scenarioMarkets.clear();
+    scenarioMarkets.resize(scenarios.size());
+    pool.parallel_for(0, scenarios.size(), 8, [&](size_t s) {
+        scenarioMarkets[s].reset(new Market(scenarios[s].apply(base)));
+    });
+
+    portfolioPnl = move(pnl);
+    baseVar = computeVaR(portfolioPnl, confidence);
+}
+
+vector<double> WhatIfAnalyzer::scenarioPnlOf(const shared_ptr<Trade>& trade) const {
+    const double basePv = revalueCandidate(trade, valuer.getMarket(), CRRBinomialTreePricer(50));
+
+    vector<double> pnl(scenarioMarkets.size());
+    pool.parallel_for_range(0, pnl.size(), scenarioChunk, [&](size_t lo, size_t hi) {
+        CRRBinomialTreePricer pricer(50);
+        for (size_t s = lo; s < hi; ++s)
+            pnl[s] = revalueCandidate(trade, *scenarioMarkets[s], pricer) - basePv;
+    });
+    return pnl;
+}
+
+// ===== Queries =====
+
+long WhatIfAnalyzer::indexOf(const string& tradeId) const {
+    long i = valuer.findTrade(tradeId);
+    if (i < 0) throw invalid_argument("Trade not found in portfolio: " + tradeId);
+    return i;
+}
+
+WhatIfResult WhatIfAnalyzer::addTrade(const shared_ptr<Trade>& candidate) const {
+    if (!candidate) throw invalid_argument("Null trade pointer");
+    return evaluate(candidate, -1);
+}
+
+WhatIfResult WhatIfAnalyzer::amendTrade(const string& tradeId, const shared_ptr<Trade>& amended) const {
+    if (!amended) throw invalid_argument("Null trade pointer");
+    return evaluate(amended, indexOf(tradeId));
+}
+
+WhatIfResult WhatIfAnalyzer::cancelTrade(const string& tradeId) const {
+    return evaluate(nullptr, indexOf(tradeId));
+}
+
+WhatIfResult WhatIfAnalyzer::evaluate(const shared_ptr<Trade>& added, long removed) const {
+    WhatIfResult out;
+    out.before = baseTotal;
+    out.varBefore = baseVar;
+    out.scenarioPnl.assign(scenarioMarkets.size(), 0.0);
+
+    TradeResult& d = out.delta;
+    d.tradeInfo = added ? added->getType() + " " + added->getUnderlying() : "cancel";
+
+    if (added) {
+        // Bucketed risk runs alongside the scenario revaluations
+        auto risk = pool.submit([this, &added] { return valuer.valueExternal(added); });
+        vector<double> pnl = scenarioMarkets.empty() ? vector<double>() : scenarioPnlOf(added);
+        TradeResult r = pool.wait(risk);
+
+        d.PV += r.PV;
+        d.DV01 += r.DV01;
+        d.Vega += r.Vega;
+        accumulate(d.dv01Buckets, r.dv01Buckets, 1.0);
+        accumulate(d.vegaBuckets, r.vegaBuckets, 1.0);
+        for (size_t s = 0; s < pnl.size(); ++s) out.scenarioPnl[s] += pnl[s];
+    }
+
+    if (removed >= 0) {
+        const TradeResult& r = valuer.getResults().at(static_cast<size_t>(removed));
+        d.PV -= r.PV;
+        d.DV01 -= r.DV01;
+        d.Vega -= r.Vega;
+        accumulate(d.dv01Buckets, r.dv01Buckets, -1.0);
+        accumulate(d.vegaBuckets, r.vegaBuckets, -1.0);
+        if (bookedPnl && !scenarioMarkets.empty()) {
+            vector<double> pnl = bookedPnl(static_cast<size_t>(removed));
+            for (size_t s = 0; s < pnl.size() && s < out.scenarioPnl.size(); ++s) out.scenarioPnl[s] -= pnl[s];
+        }
+    }
+
+    out.after = baseTotal;
+    out.after.PV += d.PV;
+    out.after.DV01 += d.DV01;
+    out.after.Vega += d.Vega;
+    out.after.tradeCount = baseTotal.tradeCount + (added ? 1 : 0) - (removed >= 0 ? 1 : 0);
+
+    out.dv01Buckets = baseDv01;
+    out.vegaBuckets = baseVega;
+    accumulate(out.dv01Buckets, d.dv01Buckets, 1.0);
+    accumulate(out.vegaBuckets, d.vegaBuckets, 1.0);
+
+    if (!portfolioPnl.empty()) {
+        vector<double> pnlAfter(portfolioPnl);
+        for (size_t s = 0; s < pnlAfter.size(); ++s) pnlAfter[s] += out.scenarioPnl[s];
+        out.varAfter = computeVaR(pnlAfter, confidence);
+        out.varContribution = out.varAfter.VaR - out.varBefore.VaR;
+    }
+    return out;
+}
@@ -0,0 +1,74 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "barrier_pricer.h"
+#include "exotic_batch_pricer.h"
+
+using namespace std;
+
+// Reiner-Rubinstein closed forms as tabulated by Haug (no dividend yield, no rebate)
+static double haugBarrier(OptionType type, BarrierType barrier, double S, double X, double H, double T, double r, double sigma) {
+    const double phi = type == OptionType::Call ? 1.0 : -1.0;
+    const bool down = barrier == BarrierType::DownAndOut || barrier == BarrierType::DownAndIn;
+    const double eta = down ? 1.0 : -1.0;
+    const double sT = sigma * sqrt(T);
+    const double mu = (r - 0.5 * sigma * sigma) / (sigma * sigma);
+    const double x1 = log(S / X) / sT + (1 + mu) * sT;
+    const double x2 = log(S / H) / sT + (1 + mu) * sT;
+    const double y1 = log(H * H / (S * X)) / sT + (1 + mu) * sT;
+    const double y2 = log(H / S) / sT + (1 + mu) * sT;
+    const double df = exp(-r * T);
+    using test::normCdf;
+    const double A = phi * S * normCdf(phi * x1) - phi * X * df * normCdf(phi * x1 - phi * sT);
+    const double B = phi * S * normCdf(phi * x2) - phi * X * df * normCdf(phi * x2 - phi * sT);
+    const double C = phi * S * pow(H / S, 2 * (mu + 1)) * normCdf(eta * y1) - phi * X * df * pow(H / S, 2 * mu) * normCdf(eta * y1 - eta * sT);
+    const double D = phi * S * pow(H / S, 2 * (mu + 1)) * normCdf(eta * y2) - phi * X * df * pow(H / S, 2 * mu) * normCdf(eta * y2 - eta * sT);
+    const bool call = type == OptionType::Call, above = X > H;
+    switch (barrier) {
+    case BarrierType::DownAndIn:  return call ? (above ? C : A - B + D) : (above ? B - C + D : A);
+    case BarrierType::UpAndIn:    return call ? (above ? A : B - C + D) : (above ? A - B + D : C);
+    case BarrierType::DownAndOut: return call ? (above ? A - C : B - D) : (above ? A - B + C - D : 0.0);
+    case BarrierType::UpAndOut:   return call ? (above ? 0.0 : A - B + C - D) : (above ? B - D : A - C);
+    }
+    return 0.0;
+}
+
+int main() {
+    const Date asOf(2025, 6, 2), expiry(2026, 6, 2);
+    const double S = 100.0, r = 0.05, sigma = 0.25;
+    Market mkt(asOf);
+    mkt.addCurve("USD-SOFR", test::flatCurve("USD-SOFR", asOf, r));
+    mkt.addVolCurve("LOGVOL", test::flatVol(asOf, sigma));
+    mkt.addStockPrice("SP500", S);
+    const double T = expiry - asOf;
+
+    struct Case { OptionType type; BarrierType barrier; double strike, level; const char* name; };
+    const vector<Case> cases = {
+        { OptionType::Call, BarrierType::DownAndOut, 100, 90, "down-out call K>H" },
+        { OptionType::Call, BarrierType::DownAndOut, 90, 95, "down-out call K<H" },
+        { OptionType::Call, BarrierType::DownAndIn, 100, 90, "down-in call K>H" },
+        { OptionType::Call, BarrierType::UpAndOut, 100, 130, "up-out call" },
+        { OptionType::Call, BarrierType::UpAndIn, 100, 130, "up-in call" },
+        { OptionType::Put, BarrierType::UpAndOut, 100, 110, "up-out put K<H" },
+        { OptionType::Put, BarrierType::UpAndOut, 105, 102, "up-out put K>H" },
+        { OptionType::Put, BarrierType::DownAndOut, 100, 80, "down-out put" },
+        { OptionType::Put, BarrierType::DownAndIn, 100, 80, "down-in put" },
+        { OptionType::Put, BarrierType::UpAndIn, 100, 110, "up-in put" },
+    };
+
+    // Single-trade pricer and the batch path, both against the closed form
+    BarrierPricer pricer;
+    vector<shared_ptr<Trade>> book;
+    for (const auto& c : cases) {
+        auto trade = make_shared<BarrierOption>(c.type, c.barrier, 1.0, c.strike, c.level, asOf, expiry, "SP500");
+        const double expected = haugBarrier(c.type, c.barrier, S, c.strike, c.level, T, r, sigma);
+        CHECK_NEAR(string("Haug ") + c.name, pricer.price(mkt, trade), expected, 5e-4);
+        book.push_back(trade);
+    }
+    const vector<double> batch = ExoticBatchPricer().price(mkt, book);
+    for (size_t i = 0; i < cases.size(); ++i)
+        CHECK_NEAR(string("Batch ") + cases[i].name, batch[i], pricer.price(mkt, book[i]), 1e-10);
+    return test::failures();
+}
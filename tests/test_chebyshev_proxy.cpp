@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "american_trade.h"
+#include "tree_pricer.h"
+#include "risk_ladder.h"
+#include "historical_var.h"
+#include "chebyshev_proxy.h"
+
+using namespace std;
+
+// Chebyshev proxies fitted to the early-exercise lattice. The lattice itself must price a
+// short at exactly minus the long. Fitted on the base market, the proxy must match the
+// lattice on the spot/vol ladder within each trade's error estimate, without building
+// lattices. Sized to a scenario set with fitEnvelope, it must price every scenario with no
+// further refits, within its error estimate and 0.5% of the largest PV
+int main() {
+    const Date asOf(2025, 6, 2), expiry1(2026, 6, 2), expiry2(2027, 6, 2);
+    Market mkt(asOf);
+    mkt.addCurve("USD-SOFR", test::flatCurve("USD-SOFR", asOf, 0.04));
+    mkt.addVolCurve("LOGVOL", test::flatVol(asOf, 0.22));
+    mkt.addStockPrice("SP500", 5000.0);
+    mkt.addStockPrice("STI", 3400.0);
+
+    const vector<shared_ptr<Trade>> trades = {
+        make_shared<AmericanOption>(OptionType::Put, 200.0, 5200.0, asOf, expiry2, "SP500"),
+        make_shared<AmericanOption>(OptionType::Put, 200.0, 5200.0, asOf, expiry2, "SP500", false),
+        make_shared<AmerCallSpread>(100.0, 4800.0, 5400.0, asOf, expiry2, "SP500"),
+        make_shared<AmericanOption>(OptionType::Put, 100.0, 3500.0, asOf, expiry1, "STI"),
+        make_shared<AmericanOption>(OptionType::Call, 200.0, 3300.0, asOf, expiry1, "STI", false),
+    };
+    auto lattice = make_shared<EarlyExerciseLatticePricer>(200);
+
+    CHECK_NEAR("Lattice short put mirrors long", lattice->price(mkt, trades[1]), -lattice->price(mkt, trades[0]), 1e-9);
+
+    ChebyshevProxy proxy(lattice);
+    CHECK("All trades fitted", proxy.fit(mkt, trades) == trades.size());
+    CHECK("Two groups, one per underlying and expiry", proxy.getStats().groups == 2);
+    for (size_t k = 0; k < trades.size(); ++k)
+        CHECK_NEAR("Proxy vs lattice on the base market, trade " + to_string(k), proxy.price(mkt, trades[k]),
+            lattice->price(mkt, trades[k]), proxy.errorEstimate(*trades[k]) + 1e-6);
+
+    // Ladder inside the fitted box: read off the interpolant, no lattices
+    const LadderSpec spec = LadderSpec::uniform(-0.2, 0.2, 21, { -0.05, 0.0, 0.05 });
+    LadderEngine exactLadders(mkt, trades), proxyLadders(mkt, trades);
+    proxyLadders.setProxy(&proxy);
+    exactLadders.run(spec);
+    proxyLadders.run(spec);
+    CHECK("Proxy ladder builds no lattices", proxyLadders.latticeBuilds() == 0);
+    const size_t width = spec.volMoves.size() * spec.spotMoves.size();
+    for (size_t t = 0; t < trades.size(); ++t) {
+        double maxDiff = 0.0;
+        for (size_t k = 0; k < width; ++k)
+            maxDiff = max(maxDiff, fabs(proxyLadders.getLadder().row(t)[k] - exactLadders.getLadder().row(t)[k]));
+        CHECK_NEAR("Proxy vs lattice ladder, trade " + to_string(t), maxDiff, 0.0, proxy.errorEstimate(*trades[t]));
+    }
+
+    // 300 scenarios, some well outside the box the base fit drew
+    mt19937_64 rng(20250101);
+    normal_distribution<double> z(0.0, 1.0);
+    vector<unique_ptr<Market>> markets;
+    for (int d = 0; d < 300; ++d) {
+        HistoricalScenario sc;
+        sc.curveMoves.push_back({ "USD-SOFR", "", 0.002 * z(rng) });
+        sc.volMoves.push_back({ "LOGVOL", "", 0.04 * z(rng) });
+        sc.spotMoves.push_back({ "SP500", "", 0.15 * z(rng) });
+        sc.spotMoves.push_back({ "STI", "", 0.15 * z(rng) });
+        markets.emplace_back(new Market(sc.apply(mkt)));
+    }
+    const size_t grown = proxy.fitEnvelope(mkt, markets.size(), [&](size_t m) { return markets[m]->overlay(); });
+    CHECK("Envelope refits both groups", grown == 2);
+
+    const size_t refitsBefore = proxy.getStats().refits;
+    double maxErr = 0.0, maxPv = 0.0;
+    for (const auto& m : markets)
+        for (const auto& trade : trades) {
+            const double exact = lattice->price(*m, trade);
+            maxErr = max(maxErr, fabs(proxy.price(*m, trade) - exact));
+            maxPv = max(maxPv, fabs(exact));
+        }
+    CHECK("No refits after the envelope fit", proxy.getStats().refits == refitsBefore);
+    CHECK("No exact fallbacks in the sweep", proxy.getStats().fallbacks == 0);
+    CHECK_NEAR("Sweep error within the error estimate", maxErr, 0.0, proxy.maxErrorEstimate());
+    CHECK_NEAR("Sweep error relative to the largest PV", maxErr / maxPv, 0.0, 5e-3);
+    return test::failures();
+}
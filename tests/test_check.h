@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "market.h"
+#include "helper.h"
+
+// ===========================
+// Test checks
+// ===========================
+// Each test is a plain executable registered with ctest: CHECK_NEAR reports every miss to
+// cerr and counts it, and main returns the count so any miss fails the test.
+namespace test {
+
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void checkNear(const std::string& label, double actual, double expected, double tol) {
+        const double err = std::fabs(actual - expected);
+        if (!(err <= tol)) {
+            std::cerr << "[ERROR] " << label << ": " << actual << " vs " << expected << " (error " << err
+                << ", tolerance " << tol << ")" << std::endl;
+            ++failures();
+        }
+    }
+
+    inline void check(const std::string& label, bool ok) {
+        if (!ok) {
+            std::cerr << "[ERROR] " << label << std::endl;
+            ++failures();
+        }
+    }
+
+    // Flat continuously compounded curve and flat LOGVOL, pillars out to 30Y
+    inline std::shared_ptr<RateCurve> flatCurve(const std::string& name, const Date& asOf, double rate) {
+        auto curve = std::make_shared<RateCurve>(name);
+        for (const std::string tenor : { "ON", "1M", "3M", "6M", "1Y", "2Y", "5Y", "10Y", "30Y" })
+            curve->addRate(util::dateAddTenor(asOf, tenor), rate);
+        return curve;
+    }
+
+    inline std::shared_ptr<VolCurve> flatVol(const Date& asOf, double vol) {
+        auto curve = std::make_shared<VolCurve>("LOGVOL");
+        for (const std::string tenor : { "1M", "3M", "6M", "1Y", "2Y", "5Y", "10Y", "30Y" })
+            curve->addVol(util::dateAddTenor(asOf, tenor), vol);
+        return curve;
+    }
+
+    inline double normCdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+}
+
+#define CHECK_NEAR(label, actual, expected, tol) test::checkNear(label, actual, expected, tol)
+#define CHECK(label, cond) test::check(label, cond)
@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#include "test_check.h"
+#include "date.h"
+
+using namespace std;
+
+// Next calendar day by month lengths alone, as the independent reference for day counts
+static Date nextDay(const Date& d) {
+    static const int monthDays[] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+    const int y = d.getYear(), m = d.getMonth();
+    const bool leap = y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
+    const int dim = (m == 2 && leap) ? 29 : monthDays[m - 1];
+    if (d.getDay() < dim) return Date(y, m, d.getDay() + 1);
+    return m < 12 ? Date(y, m + 1, 1) : Date(y + 1, 1, 1);
+}
+
+// POSIX zone strings, so no zone database is needed
+static void setZone(const char* zone) {
+#ifdef _WIN32
+    _putenv_s("TZ", zone);
+    _tzset();
+#else
+    setenv("TZ", zone, 1);
+    tzset();
+#endif
+}
+
+static string show(const Date& d) {
+    return to_string(d.getYear()) + "-" + to_string(d.getMonth()) + "-" + to_string(d.getDay());
+}
+
+// Day counts, serials and day steps are calendar arithmetic: they must not depend on the
+// process time zone or move by a day across daylight-saving changes
+int main() {
+    for (const char* zone : { "UTC0", "EST5EDT,M3.2.0,M11.1.0", "GMT0BST,M3.5.0/1,M10.5.0", "AEST-10AEDT,M10.1.0,M4.1.0/3" }) {
+        setZone(zone);
+        const string tz = string(" (") + zone + ")";
+
+        // Both 2025 DST changes of each zone, one day apart
+        for (const auto& [a, b] : { make_pair(Date(2025, 3, 9), Date(2025, 3, 10)), make_pair(Date(2025, 11, 2), Date(2025, 11, 3)),
+                 make_pair(Date(2025, 3, 30), Date(2025, 3, 31)), make_pair(Date(2025, 10, 26), Date(2025, 10, 27)),
+                 make_pair(Date(2025, 4, 6), Date(2025, 4, 7)), make_pair(Date(2025, 10, 5), Date(2025, 10, 6)) }) {
+            CHECK("One day across " + show(a) + tz, b.diffDays(a) == 1);
+            CHECK("addDays(1) from " + show(a) + tz, a.addDays(1) == b);
+            CHECK("addDays(-1) from " + show(b) + tz, b.addDays(-1) == a);
+        }
+
+        // Every day from 1990 to 2060 against the stepped reference
+        const Date start(1990, 1, 1);
+        const long startSerial = start.getSerialDate();
+        Date d = start;
+        int count = 0, misses = 0;
+        while (d.getYear() < 2060) {
+            if (d.diffDays(start) != count || d.getSerialDate() != startSerial + count || !(start.addDays(count) == d)) ++misses;
+            Date back;
+            back.serialToDate(static_cast<int>(d.getSerialDate()));
+            if (!(back == d)) ++misses;
+            d = nextDay(d);
+            ++count;
+        }
+        CHECK("Day counts, serials and steps from 1990 to 2060" + tz + ": " + to_string(misses) + " misses", misses == 0);
+        CHECK_NEAR("ACT/365 over the 2024 leap year" + tz, Date(2025, 1, 1) - Date(2024, 1, 1), 366.0 / 365.0, 1e-15);
+    }
+
+    // Excel serials, which count a phantom 1900-02-29 (the year 1900 itself is not matched)
+    CHECK("Serial 1901-01-01", Date(1901, 1, 1).getSerialDate() == 367);
+    CHECK("Serial 2000-01-01", Date(2000, 1, 1).getSerialDate() == 36526);
+    CHECK("Serial 2025-01-01", Date(2025, 1, 1).getSerialDate() == 45658);
+    return test::failures();
+}
@@ -0,0 +1,64 @@
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "heston_pricer.h"
+#include "heston_calibrator.h"
+
+using namespace std;
+
+int main() {
+    // Fang & Oosterlee (2008), Table 4: S = K = 100, T = 1, r = 0
+    HestonParams fo;
+    fo.v0 = 0.0175;
+    fo.kappa = 1.5768;
+    fo.theta = 0.0398;
+    fo.sigma = 0.5751;
+    fo.rho = -0.5711;
+    HestonPricer pricer;
+    const double call = pricer.priceChain(fo, 100.0, 0.0, 1.0, { 100.0 }, { OptionType::Call }).front();
+    CHECK_NEAR("Fang-Oosterlee reference call", call, 5.785155450, 1e-7);
+
+    // A chain prices each strike as it would alone, and calls and puts keep parity; a chain
+    // spans a wider interval than one strike, so the two agree to the expansion's accuracy
+    vector<double> strikes;
+    vector<OptionType> types;
+    for (int k = 0; k < 9; ++k) {
+        strikes.push_back(60.0 + 10.0 * k);
+        types.push_back(k % 2 ? OptionType::Put : OptionType::Call);
+    }
+    const double r = 0.03, T = 2.0;
+    const vector<double> chain = pricer.priceChain(fo, 100.0, r, T, strikes, types);
+    for (size_t k = 0; k < strikes.size(); ++k) {
+        const string label = "K=" + to_string(static_cast<int>(strikes[k]));
+        CHECK_NEAR("Chain vs single " + label, chain[k], pricer.priceChain(fo, 100.0, r, T, { strikes[k] }, { types[k] }).front(), 1e-6);
+        const OptionType other = types[k] == OptionType::Call ? OptionType::Put : OptionType::Call;
+        const double mirror = pricer.priceChain(fo, 100.0, r, T, { strikes[k] }, { other }).front();
+        const double callPv = types[k] == OptionType::Call ? chain[k] : mirror;
+        const double putPv = types[k] == OptionType::Call ? mirror : chain[k];
+        CHECK_NEAR("Put-call parity " + label, callPv - putPv, 100.0 - strikes[k] * exp(-r * T), 1e-6);
+    }
+
+    // Calibration to a grid priced with known parameters recovers them
+    vector<HestonQuote> quotes;
+    for (double expiry : { 0.25, 0.5, 1.0, 2.0, 5.0 }) {
+        for (double m : { 0.8, 0.9, 1.0, 1.1, 1.2 }) {
+            HestonQuote q;
+            q.expiry = expiry;
+            q.strike = 100.0 * m;
+            q.rate = r;
+            q.type = m < 1.0 ? OptionType::Put : OptionType::Call;
+            q.price = pricer.priceChain(fo, 100.0, r, expiry, { q.strike }, { q.type }).front();
+            q.weight = 0.01;
+            quotes.push_back(q);
+        }
+    }
+    const HestonCalibration fit = HestonCalibrator(pricer).calibrate(100.0, quotes);
+    CHECK("Calibration converged", fit.converged);
+    CHECK_NEAR("Calibrated v0", fit.params.v0, fo.v0, 1e-4);
+    CHECK_NEAR("Calibrated kappa", fit.params.kappa, fo.kappa, 1e-2);
+    CHECK_NEAR("Calibrated theta", fit.params.theta, fo.theta, 1e-4);
+    CHECK_NEAR("Calibrated sigma", fit.params.sigma, fo.sigma, 1e-2);
+    CHECK_NEAR("Calibrated rho", fit.params.rho, fo.rho, 1e-2);
+    return test::failures();
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "european_trade.h"
+#include "american_trade.h"
+#include "tree_pricer.h"
+#include "black_scholes_pricer.h"
+#include "risk_ladder.h"
+
+using namespace std;
+
+// Spot/vol ladders from the shared lattice against the closed-form ladders: an American
+// call on a non-dividend stock is never exercised early, so its lattice ladder must match
+// the analytic European ladder. Lattice ladder points must also match a full lattice
+// reprice on a bumped market, and short rows must mirror long ones
+int main() {
+    const Date asOf(2025, 6, 2), expiry(2026, 6, 2);
+    const double spot = 5000.0, strike = 5000.0, vol = 0.25;
+    Market mkt(asOf);
+    mkt.addCurve("USD-SOFR", test::flatCurve("USD-SOFR", asOf, 0.04));
+    mkt.addVolCurve("LOGVOL", test::flatVol(asOf, vol));
+    mkt.addStockPrice("SP500", spot);
+
+    const vector<shared_ptr<Trade>> trades = {
+        make_shared<AmericanOption>(OptionType::Call, 1.0, strike, asOf, expiry, "SP500"),
+        make_shared<EuropeanOption>(OptionType::Call, 1.0, strike, asOf, expiry, "SP500"),
+        make_shared<AmericanOption>(OptionType::Put, 1.0, strike, asOf, expiry, "SP500"),
+        make_shared<AmericanOption>(OptionType::Put, 1.0, strike, asOf, expiry, "SP500", false),
+    };
+    const LadderSpec spec = LadderSpec::uniform(-0.2, 0.2, 21, { -0.05, 0.0, 0.05 });
+    LadderEngine engine(mkt, trades);
+    const RiskLadder& ladder = engine.run(spec);
+    const size_t nS = spec.spotMoves.size(), nV = spec.volMoves.size();
+
+    CHECK("One lattice per vol level per American trade", engine.latticeBuilds() == 3 * nV);
+
+    // American vs European call across the grid, relative to the European PV at each vol
+    double maxRel = 0.0;
+    for (size_t v = 0; v < nV; ++v) {
+        mkt.addVolCurve("LOGVOL", test::flatVol(asOf, vol + spec.volMoves[v]));
+        const double scale = BlackScholesPricer().price(mkt, trades[1]);
+        for (size_t s = 0; s < nS; ++s)
+            maxRel = max(maxRel, fabs(ladder.at(0, v, s) - ladder.at(1, v, s)) / scale);
+    }
+    mkt.addVolCurve("LOGVOL", test::flatVol(asOf, vol));
+    CHECK_NEAR("American vs European call ladder (max relative)", maxRel, 0.0, 1e-3);
+
+    // Lattice ladder points against full 200-step lattice reprices on bumped markets; the
+    // two place their nodes differently, so they agree to the lattice's own noise
+    EarlyExerciseLatticePricer lattice(spec.treeSteps);
+    const double basePut = lattice.price(mkt, trades[2]);
+    for (size_t v = 0; v < nV; ++v)
+        for (size_t s = 0; s < nS; s += 5) {
+            Market bumped = mkt.overlay();
+            bumped.addVolCurve("LOGVOL", test::flatVol(asOf, vol + spec.volMoves[v]));
+            bumped.addStockPrice("SP500", spot * (1.0 + spec.spotMoves[s]));
+            const string label = "Put ladder vs reprice dv=" + to_string(spec.volMoves[v]) + " ds=" + to_string(spec.spotMoves[s]);
+            CHECK_NEAR(label, ladder.at(2, v, s), lattice.price(bumped, trades[2]) - basePut, 5e-3 * basePut);
+        }
+
+    for (size_t k = 0; k < nS * nV; ++k)
+        CHECK_NEAR("Short put mirrors long " + to_string(k), ladder.row(3)[k], -ladder.row(2)[k], 1e-9 * spot);
+
+    // Gamma read-out of the European row against the Black-Scholes gamma times S^2
+    const double T = expiry - asOf, r = 0.04;
+    const double d1 = (log(spot / strike) + (r + 0.5 * vol * vol) * T) / (vol * sqrt(T));
+    const double gammaS2 = spot * exp(-0.5 * d1 * d1) / sqrt(2.0 * acos(-1.0)) / (vol * sqrt(T));
+    CHECK_NEAR("European ladder gamma", engine.greeks(ladder.row(1)).gamma, gammaS2, 2e-3 * gammaS2);
+    return test::failures();
+}
@@ -0,0 +1,75 @@
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "european_trade.h"
+#include "american_trade.h"
+#include "black_scholes_pricer.h"
+#include "local_vol_pricer.h"
+
+using namespace std;
+
+// Vol linear in ln(K / F), the same at every expiry, so total variance is exactly linear in
+// T. The moneyness nodes reach well past 2Y's standard deviations: the surface's flat-vol
+// extrapolation puts a kink in w at the outer nodes, which Dupire would turn into a density
+// the PDE grid cannot see
+static shared_ptr<ImpliedVolSurface> makeSurface(double atmVol, double skew) {
+    auto surface = make_shared<ImpliedVolSurface>("SP500");
+    const vector<double> moneyness = { 0.25, 0.4, 0.6, 0.8, 0.9, 1.0, 1.1, 1.25, 1.5, 2.0, 3.0 };
+    surface->setMoneyness(moneyness);
+    for (double T : { 0.25, 0.5, 1.0, 2.0 }) {
+        vector<double> vols;
+        for (double m : moneyness) vols.push_back(atmVol + skew * log(m));
+        surface->addSmile(T, vols);
+    }
+    return surface;
+}
+
+// Dupire local vol reprices the implied surface it was built from. On a flat surface the
+// PDE must match Black-Scholes; on a skewed one each European must match Black-Scholes at
+// its own implied vol from the surface. Batched and single-trade solves must agree, and
+// early exercise can only add value to a put. Tolerances are in units of spot
+int main() {
+    const Date asOf(2025, 6, 2);
+    const double spot = 5000.0, rate = 0.04;
+    const vector<Date> expiries = { Date(2025, 12, 2), Date(2026, 6, 2), Date(2027, 6, 2) };
+    const vector<double> strikes = { 4250.0, 5000.0, 5750.0 };
+
+    for (const double skew : { 0.0, -0.15 }) {
+        const string tag = skew == 0.0 ? "flat" : "skewed";
+        Market mkt(asOf);
+        mkt.addCurve("USD-SOFR", test::flatCurve("USD-SOFR", asOf, rate));
+        mkt.addStockPrice("SP500", spot);
+        auto surface = makeSurface(0.22, skew);
+        mkt.addVolSurface("SP500", surface);
+
+        vector<shared_ptr<Trade>> trades;
+        for (const Date& expiry : expiries)
+            for (double K : strikes) {
+                trades.push_back(make_shared<EuropeanOption>(OptionType::Call, 1.0, K, asOf, expiry, "SP500"));
+                trades.push_back(make_shared<EuropeanOption>(OptionType::Put, 1.0, K, asOf, expiry, "SP500"));
+                trades.push_back(make_shared<AmericanOption>(OptionType::Put, 1.0, K, asOf, expiry, "SP500"));
+            }
+        LocalVolPricer localVol;
+        const vector<double> pvs = localVol.priceBatch(mkt, trades);
+
+        BlackScholesPricer bs;
+        for (size_t i = 0; i < trades.size(); i += 3) {
+            const auto& call = trades[i];
+            const double K = call->getStrike();
+            const double T = call->getExpiry() - asOf;
+            const double forward = spot * exp(rate * T);
+            // Black-Scholes reads LOGVOL: make it the surface vol at this trade's expiry and strike
+            mkt.addVolCurve("LOGVOL", test::flatVol(asOf, surface->getVol(T, K, forward)));
+            const string label = tag + " K=" + to_string(int(K)) + " T=" + to_string(T).substr(0, 4) + "Y";
+            CHECK_NEAR("LV call vs Black-Scholes " + label, pvs[i], bs.price(mkt, call), 1e-5 * spot);
+            CHECK_NEAR("LV put vs Black-Scholes " + label, pvs[i + 1], bs.price(mkt, trades[i + 1]), 1e-5 * spot);
+            CHECK("American put above European " + label, pvs[i + 2] >= pvs[i + 1] - 1e-8);
+        }
+        for (size_t i = 0; i < trades.size(); i += 4)
+            CHECK_NEAR("LV batch vs single " + tag + " " + to_string(i), pvs[i], localVol.price(mkt, trades[i]), 1e-9 * spot);
+    }
+    return test::failures();
+}
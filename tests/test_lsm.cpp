@@ -0,0 +1,50 @@
+#include <memory>
+#include <string>
+
+#include "test_check.h"
+#include "american_trade.h"
+#include "european_trade.h"
+#include "black_scholes_pricer.h"
+#include "tree_pricer.h"
+#include "lsm_pricer.h"
+
+using namespace std;
+
+// Longstaff-Schwartz against the CRR lattice and the finite-difference American put values
+// of Longstaff and Schwartz (2001, table 1: K = 40, r = 6%, sigma = 20%, T = 1Y). The
+// American call on a non-dividend stock is never exercised early, so it must price as the
+// Black-Scholes European
+int main() {
+    const Date asOf(2025, 6, 2), expiry(2026, 6, 2);
+    const double K = 40.0;
+    Market mkt(asOf);
+    mkt.addCurve("USD-SOFR", test::flatCurve("USD-SOFR", asOf, 0.06));
+    mkt.addVolCurve("LOGVOL", test::flatVol(asOf, 0.20));
+
+    LsmPricer lsm(1 << 16);
+    EarlyExerciseLatticePricer lattice(500);
+    const struct { double spot, fdPrice; } puts[] = { { 36.0, 4.478 }, { 40.0, 2.314 }, { 44.0, 1.110 } };
+    for (const auto& c : puts) {
+        mkt.addStockPrice("SP500", c.spot);
+        auto put = make_shared<AmericanOption>(OptionType::Put, 1.0, K, asOf, expiry, "SP500");
+        const string label = "American put S=" + to_string(int(c.spot));
+        const McResult r = lsm.priceWithError(mkt, put);
+        const double tree = lattice.price(mkt, put);
+        CHECK("Standard error reported for " + label, r.stdError > 0.0);
+        // Fifty exercise dates and the in-sample bias keep LSM within a few cents of the PDE
+        CHECK_NEAR("LSM vs finite difference " + label, r.price, c.fdPrice, 3.0 * r.stdError + 0.02);
+        CHECK_NEAR("Lattice vs finite difference " + label, tree, c.fdPrice, 0.01);
+        CHECK_NEAR("LSM vs lattice " + label, r.price, tree, 3.0 * r.stdError + 0.02);
+
+        auto shortPut = make_shared<AmericanOption>(OptionType::Put, 1.0, K, asOf, expiry, "SP500", false);
+        CHECK_NEAR("LSM short vs long " + label, lsm.price(mkt, shortPut), -r.price, 3.0 * r.stdError + 0.02);
+    }
+
+    mkt.addStockPrice("SP500", 40.0);
+    auto call = make_shared<AmericanOption>(OptionType::Call, 1.0, K, asOf, expiry, "SP500");
+    const McResult r = lsm.priceWithError(mkt, call);
+    const double european = BlackScholesPricer().price(mkt,
+        make_shared<EuropeanOption>(OptionType::Call, 1.0, K, asOf, expiry, "SP500"));
+    CHECK_NEAR("LSM American call vs Black-Scholes", r.price, european, 3.0 * r.stdError);
+    return test::failures();
+}
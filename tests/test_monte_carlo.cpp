@@ -0,0 +1,50 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "european_trade.h"
+#include "black_scholes_pricer.h"
+#include "monte_carlo_pricer.h"
+
+using namespace std;
+
+// Sobol Monte Carlo against closed-form Black-Scholes on vanillas and a call spread, with
+// the control variate off (it is the Black-Scholes price itself and would make vanillas
+// exact); each PV must land within four reported standard errors
+int main() {
+    const Date asOf(2025, 6, 2);
+    Market mkt(asOf);
+    mkt.addCurve("USD-SOFR", test::flatCurve("USD-SOFR", asOf, 0.04));
+    mkt.addVolCurve("LOGVOL", test::flatVol(asOf, 0.25));
+    mkt.addStockPrice("SP500", 5000.0);
+
+    BlackScholesPricer bs;
+    vector<pair<string, shared_ptr<Trade>>> trades = {
+        { "ATM call 1Y", make_shared<EuropeanOption>(OptionType::Call, 1.0, 5000.0, asOf, Date(2026, 6, 2), "SP500") },
+        { "OTM put 6M", make_shared<EuropeanOption>(OptionType::Put, 1.0, 4500.0, asOf, Date(2025, 12, 2), "SP500") },
+        { "ITM call 2Y short", make_shared<EuropeanOption>(OptionType::Call, 1.0, 4000.0, asOf, Date(2027, 6, 2), "SP500", false) },
+        { "Call spread 1Y", make_shared<EuroCallSpread>(1.0, 4800.0, 5200.0, asOf, Date(2026, 6, 2), "SP500") },
+    };
+
+    // Black-Scholes prices vanillas only: the spread pays (S - K1)/(K2 - K1) capped at one,
+    // so its reference is the two call legs over the strike width
+    auto exactPrice = [&](const shared_ptr<Trade>& trade) {
+        if (dynamic_pointer_cast<EuroCallSpread>(trade))
+            return (bs.price(mkt, make_shared<EuropeanOption>(OptionType::Call, 1.0, 4800.0, asOf, Date(2026, 6, 2), "SP500")) -
+                bs.price(mkt, make_shared<EuropeanOption>(OptionType::Call, 1.0, 5200.0, asOf, Date(2026, 6, 2), "SP500"))) / 400.0;
+        return bs.price(mkt, trade);
+    };
+
+    MonteCarloPricer mc(1 << 16);
+    mc.setSampling(Sampling::Sobol);
+    mc.setControlVariate(false);
+    for (const auto& [label, trade] : trades) {
+        const McResult r = mc.priceWithError(mkt, trade);
+        const double exact = exactPrice(trade);
+        CHECK("Standard error reported for " + label, r.stdError > 0.0);
+        CHECK_NEAR("MC vs Black-Scholes " + label, r.price, exact, 4.0 * r.stdError);
+        CHECK_NEAR("MC relative error " + label, r.price / exact, 1.0, 1e-3);
+    }
+    return test::failures();
+}